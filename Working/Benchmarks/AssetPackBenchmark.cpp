@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "AssetPack.hpp"
+#include "AssetPackWriter.hpp"
+#include "JobSystem.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    const uint32_t ASSET_COUNT = 64;
+    const size_t ASSET_SIZE = 1024 * 1024;
+    const int RUNS = 5;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    std::string assetName(uint32_t index) {
+        return "textures/asset" + std::to_string(index) + ".bin";
+    }
+
+    /**
+     * @brief Texture-like data: smooth gradients with a little noise, so it compresses
+     * roughly as well as real uncompressed texels do.
+     */
+    std::vector<std::byte> makeAsset(uint32_t seed) {
+        std::vector<std::byte> data(ASSET_SIZE);
+        uint32_t state = seed * 2654435761u + 1;
+        for (size_t i = 0; i < data.size(); i++) {
+            state = state * 1664525u + 1013904223u;
+            uint32_t gradient = (uint32_t)((i / 4) % 1024 / 4 + seed);
+            data[i] = (std::byte)(gradient + ((state >> 28) & 3));
+        }
+        return data;
+    }
+
+    void report(const char* label, double seconds) {
+        double bytes = (double)ASSET_COUNT * ASSET_SIZE;
+        std::printf("  %-28s %8.2f ms  %8.2f GB/s\n", label, seconds * 1e3, bytes / seconds / 1e9);
+    }
+
+    /**
+     * @brief The path assets take today: one loose file per asset, read into a heap vector
+     * and then copied to staging.
+     */
+    double benchmarkLoose(const std::filesystem::path& directory, std::vector<std::byte>& staging) {
+        auto start = Clock::now();
+        for (uint32_t i = 0; i < ASSET_COUNT; i++) {
+            std::ifstream file(directory / ("asset" + std::to_string(i) + ".bin"), std::ios::binary);
+            std::vector<char> data {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+            std::copy(data.begin(), data.end(), reinterpret_cast<char*>(staging.data()) + i * ASSET_SIZE);
+        }
+        return secondsSince(start);
+    }
+
+    double benchmarkPack(const char* path, std::vector<std::byte>& staging, JobSystem* jobs) {
+        auto start = Clock::now();
+        AssetPack pack(path);
+        auto load = [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                pack.read(*pack.find(assetName(i)), staging.data() + i * ASSET_SIZE);
+            }
+        };
+        if (jobs) {
+            jobs->parallelFor(ASSET_COUNT, 1, load);
+        }
+        else {
+            load(0, ASSET_COUNT);
+        }
+        return secondsSince(start);
+    }
+
+    template <typename Benchmark>
+    double best(Benchmark benchmark) {
+        double best_seconds = 1e9;
+        for (int run = 0; run < RUNS; run++) {
+            best_seconds = std::min(best_seconds, benchmark());
+        }
+        return best_seconds;
+    }
+}
+
+int main() {
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "meadow_asset_pack_benchmark";
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::vector<std::byte>> assets;
+    for (uint32_t i = 0; i < ASSET_COUNT; i++) {
+        assets.push_back(makeAsset(i));
+        std::ofstream file(directory / ("asset" + std::to_string(i) + ".bin"), std::ios::binary);
+        file.write(reinterpret_cast<const char*>(assets.back().data()), ASSET_SIZE);
+    }
+
+    std::vector<std::byte> staging(ASSET_COUNT * ASSET_SIZE);
+    JobSystem jobs;
+
+    std::printf("Loading %u assets of %zu KiB (warm page cache, best of %d)\n", ASSET_COUNT, ASSET_SIZE / 1024, RUNS);
+    report("loose files", best([&]() { return benchmarkLoose(directory, staging); }));
+
+    for (Compression::Codec codec : {Compression::Codec::None, Compression::Codec::LZ4, Compression::Codec::Zstd}) {
+        if (!Compression::isAvailable(codec)) {
+            std::printf("  %-28s (not built)\n", Compression::getName(codec));
+            continue;
+        }
+
+        AssetPackWriter writer;
+        for (uint32_t i = 0; i < ASSET_COUNT; i++) {
+            writer.add(assetName(i), assets[i], codec);
+        }
+        std::string path = (directory / (std::string("assets_") + Compression::getName(codec) + ".pack")).string();
+        writer.write(path.c_str());
+
+        std::string label = std::string("pack, ") + Compression::getName(codec);
+        std::printf("  %s: %.1f%% of original size\n", label.c_str(), 100.0 * writer.getStoredSize() / (ASSET_COUNT * ASSET_SIZE));
+        report((label + ", 1 thread").c_str(), best([&]() { return benchmarkPack(path.c_str(), staging, nullptr); }));
+        report((label + ", " + std::to_string(jobs.getThreadCount()) + " threads").c_str(),
+            best([&]() { return benchmarkPack(path.c_str(), staging, &jobs); }));
+    }
+
+    std::filesystem::remove_all(directory);
+}
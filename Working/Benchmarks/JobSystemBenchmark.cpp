@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+#include "JobSystem.hpp"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /**
+     * @brief Cost of scheduling, running and retiring an empty job.
+     */
+    void benchmarkOverhead(JobSystem& jobs) {
+        const uint32_t job_count = 200000;
+
+        auto start = Clock::now();
+        JobCounter counter;
+        for (uint32_t i = 0; i < job_count; i++) {
+            jobs.schedule([]() {}, &counter);
+        }
+        jobs.wait(counter);
+        double seconds = secondsSince(start);
+
+        std::printf("  empty jobs:      %8.1f ns/job\n", seconds * 1e9 / job_count);
+
+        start = Clock::now();
+        std::atomic<uint32_t> sink = 0;
+        jobs.parallelFor(job_count, 1, [&sink](uint32_t begin, uint32_t end) {
+            sink.fetch_add(end - begin, std::memory_order_relaxed);
+        });
+        seconds = secondsSince(start);
+
+        std::printf("  parallelFor(1):  %8.1f ns/batch\n", seconds * 1e9 / job_count);
+    }
+
+    /**
+     * @brief Latency of a chain where every job waits on the one before it, which forces a
+     * hand-off through the dependency list for every link.
+     */
+    void benchmarkChain(JobSystem& jobs) {
+        const uint32_t chain_length = 10000;
+
+        auto start = Clock::now();
+        std::vector<std::unique_ptr<JobCounter>> counters;
+        counters.reserve(chain_length);
+        for (uint32_t i = 0; i < chain_length; i++) {
+            counters.push_back(std::make_unique<JobCounter>());
+            jobs.schedule([]() {}, counters[i].get(), i > 0 ? counters[i - 1].get() : nullptr);
+        }
+        jobs.wait(*counters.back());
+        for (auto& counter : counters) {
+            jobs.wait(*counter);
+        }
+        double seconds = secondsSince(start);
+
+        std::printf("  dependent chain: %8.1f ns/link\n", seconds * 1e9 / chain_length);
+    }
+
+    /**
+     * @brief Wall time of a compute-bound parallelFor.
+     */
+    double benchmarkScaling(JobSystem& jobs) {
+        const uint32_t element_count = 1 << 22;
+        std::vector<float> values(element_count);
+
+        auto start = Clock::now();
+        jobs.parallelFor(element_count, 4096, [&values](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                float x = (float)i;
+                for (int k = 0; k < 16; k++) {
+                    x = std::sqrt(x + 1.0f) * 1.5f;
+                }
+                values[i] = x;
+            }
+        });
+        return secondsSince(start);
+    }
+}
+
+int main() {
+    const uint32_t hardware_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("Scheduling overhead (%u threads)\n", hardware_threads);
+    {
+        JobSystem jobs;
+        benchmarkOverhead(jobs);
+        benchmarkChain(jobs);
+    }
+
+    std::printf("\nScaling (compute-bound parallelFor over 4M elements)\n");
+    double baseline = 0.0;
+    for (uint32_t threads = 1; threads <= hardware_threads; threads *= 2) {
+        JobSystem jobs(threads - 1);
+        if (threads == 1) {
+            // A pool with no workers still needs one thread to run on, so warm that up too
+            benchmarkScaling(jobs);
+        }
+
+        double best = 1e9;
+        for (int run = 0; run < 5; run++) {
+            best = std::min(best, benchmarkScaling(jobs));
+        }
+        if (threads == 1) {
+            baseline = best;
+        }
+        std::printf("  %3u threads: %8.2f ms  (%.2fx)\n", threads, best * 1e3, baseline / best);
+    }
+}
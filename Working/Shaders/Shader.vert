@@ -2,6 +2,9 @@
 
 layout(location = 0) out vec3 fragColor;
 
+// The depth prepass and the EQUAL-tested color pass must produce bit-identical depth
+invariant gl_Position;
+
 vec2 positions[3] = vec2[] (
     vec2(0.0, -0.5),
     vec2(0.5, 0.5),
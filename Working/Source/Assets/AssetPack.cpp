@@ -0,0 +1,70 @@
+#include "AssetPack.hpp"
+#include "Hash.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+AssetPack::AssetPack(const char* path) : file(path) {
+    const std::byte* data = file.getData();
+
+    AssetPackFormat::Header header;
+    if (file.getSize() < sizeof(header)) {
+        throw std::runtime_error(std::string("Not an asset pack: ") + path);
+    }
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, AssetPackFormat::MAGIC, sizeof(header.magic))) {
+        throw std::runtime_error(std::string("Not an asset pack: ") + path);
+    }
+    if (header.version != AssetPackFormat::VERSION) {
+        throw std::runtime_error(std::string("Unsupported asset pack version: ") + path);
+    }
+    if (header.file_size != file.getSize()) {
+        throw std::runtime_error(std::string("Truncated asset pack: ") + path);
+    }
+    if (header.slot_count == 0 || (header.slot_count & (header.slot_count - 1)) || header.slot_count <= header.entry_count) {
+        throw std::runtime_error(std::string("Corrupt asset pack lookup table: ") + path);
+    }
+
+    size_t entries_offset = sizeof(header);
+    size_t slots_offset = entries_offset + (size_t)header.entry_count * sizeof(AssetPackFormat::Entry);
+    if (slots_offset + (size_t)header.slot_count * sizeof(uint32_t) > file.getSize()) {
+        throw std::runtime_error(std::string("Truncated asset pack: ") + path);
+    }
+
+    entries.resize(header.entry_count);
+    std::memcpy(entries.data(), data + entries_offset, entries.size() * sizeof(AssetPackFormat::Entry));
+    slots.resize(header.slot_count);
+    std::memcpy(slots.data(), data + slots_offset, slots.size() * sizeof(uint32_t));
+
+    for (const AssetPackFormat::Entry& entry : entries) {
+        if (entry.offset > file.getSize() || entry.stored_size > file.getSize() - entry.offset) {
+            throw std::runtime_error(std::string("Asset pack blob out of bounds: ") + path);
+        }
+    }
+    for (uint32_t slot : slots) {
+        if (slot > entries.size()) {
+            throw std::runtime_error(std::string("Corrupt asset pack lookup table: ") + path);
+        }
+    }
+}
+
+const AssetPackFormat::Entry* AssetPack::find(std::string_view name) const {
+    return find(Hash::string(name));
+}
+
+const AssetPackFormat::Entry* AssetPack::find(uint64_t name_hash) const {
+    const uint32_t mask = (uint32_t)slots.size() - 1;
+    for (uint32_t i = (uint32_t)name_hash & mask; slots[i] != 0; i = (i + 1) & mask) {
+        const AssetPackFormat::Entry& entry = entries[slots[i] - 1];
+        if (entry.name_hash == name_hash) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void AssetPack::read(const AssetPackFormat::Entry& entry, void* destination) const {
+    Compression::decompress(entry.codec, getStoredData(entry), entry.stored_size,
+        static_cast<std::byte*>(destination), entry.size);
+}
@@ -0,0 +1,53 @@
+#ifndef _MEADOW_ASSET_PACK_HPP_
+#define _MEADOW_ASSET_PACK_HPP_
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "AssetPackFormat.hpp"
+#include "MappedFile.hpp"
+
+/**
+ * @brief A memory-mapped asset pack written by MeadowPacker.
+ *
+ * Opening a pack only parses its header and lookup table; blob data is paged
+ * in by the OS as it is read. read() copies or decompresses a blob straight
+ * from the mapping into caller memory, typically a persistently mapped
+ * staging buffer (Buffer::getMapped()), so assets reach the GPU without an
+ * intermediate heap copy.
+ */
+class AssetPack {
+    MappedFile file;
+
+    std::vector<AssetPackFormat::Entry> entries;
+    std::vector<uint32_t> slots;
+
+public:
+    /**
+     * @brief Maps and validates a pack. Throws std::runtime_error if it cannot be used.
+     */
+    explicit AssetPack(const char* path);
+
+    /**
+     * @brief Looks an asset up by the name it was packed under.
+     *
+     * @return The entry, or nullptr if the pack has no such asset.
+     */
+    const AssetPackFormat::Entry* find(std::string_view name) const;
+
+    const AssetPackFormat::Entry* find(uint64_t name_hash) const;
+
+    /**
+     * @brief Copies or decompresses an asset into destination, which must hold entry.size bytes.
+     */
+    void read(const AssetPackFormat::Entry& entry, void* destination) const;
+
+    /**
+     * @brief The asset's bytes as stored, compressed or not.
+     */
+    inline const std::byte* getStoredData(const AssetPackFormat::Entry& entry) const { return file.getData() + entry.offset; }
+
+    inline const std::vector<AssetPackFormat::Entry>& getEntries() const { return entries; }
+};
+
+#endif // _MEADOW_ASSET_PACK_HPP_
@@ -0,0 +1,52 @@
+#ifndef _MEADOW_ASSET_PACK_FORMAT_HPP_
+#define _MEADOW_ASSET_PACK_FORMAT_HPP_
+
+#include <cstdint>
+#include "Compression.hpp"
+
+/**
+ * @brief On-disk layout of a Meadow asset pack, shared by the runtime reader and the packer.
+ *
+ * A pack is laid out as:
+ *   Header
+ *   Entry[entry_count]              sorted by offset
+ *   uint32_t slots[slot_count]      open-addressed by name hash, entry index + 1, 0 if empty
+ *   padding to BLOB_ALIGNMENT
+ *   blobs, each starting on a BLOB_ALIGNMENT boundary
+ *
+ * Names are not stored, only their Hash::string() values; the packer rejects
+ * collisions. Blobs hold asset data in the layout it is uploaded in, either
+ * raw or compressed as a single block. All integers are little-endian.
+ */
+namespace AssetPackFormat {
+    constexpr char MAGIC[8] = {'M', 'D', 'W', 'P', 'A', 'C', 'K', '\0'};
+    constexpr uint32_t VERSION = 1;
+
+    /**
+     * @brief Blobs start on 64 KiB boundaries so they can be mapped, read with direct I/O or
+     * copied with page-granular DMA without straddling a page.
+     */
+    constexpr uint64_t BLOB_ALIGNMENT = 64 * 1024;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t entry_count;
+        uint32_t slot_count;  /**< A power of two, at least twice the entry count. */
+        uint32_t reserved;
+        uint64_t file_size;
+    };
+
+    struct Entry {
+        uint64_t name_hash;
+        uint64_t offset;      /**< From the start of the file. */
+        uint64_t stored_size; /**< Bytes in the file. */
+        uint64_t size;        /**< Bytes once decompressed. */
+        Compression::Codec codec;
+        uint32_t reserved;
+    };
+
+    static_assert(sizeof(Header) == 32 && sizeof(Entry) == 40, "Asset pack structs must match the file layout");
+}
+
+#endif // _MEADOW_ASSET_PACK_FORMAT_HPP_
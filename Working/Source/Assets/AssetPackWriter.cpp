@@ -0,0 +1,114 @@
+#include "AssetPackWriter.hpp"
+#include "Hash.hpp"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+    // Compressed blobs are only kept when they save at least this fraction of the original
+    const double MIN_SAVINGS = 0.05;
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+}
+
+void AssetPackWriter::add(const std::string& name, const std::vector<std::byte>& data, Compression::Codec codec) {
+    uint64_t name_hash = Hash::string(name);
+    for (const Blob& blob : blobs) {
+        if (blob.entry.name_hash == name_hash) {
+            throw std::runtime_error("Failed to add asset " + name + ": its name hash collides with " + blob.name);
+        }
+    }
+
+    Blob blob {
+        .name = name,
+        .entry = {
+            .name_hash = name_hash,
+            .offset = 0,
+            .stored_size = data.size(),
+            .size = data.size(),
+            .codec = Compression::Codec::None,
+            .reserved = 0
+        },
+        .stored = {}
+    };
+
+    if (codec != Compression::Codec::None && !data.empty()) {
+        std::vector<std::byte> compressed = Compression::compress(codec, data.data(), data.size());
+        if (compressed.size() <= data.size() * (1.0 - MIN_SAVINGS)) {
+            blob.entry.codec = codec;
+            blob.entry.stored_size = compressed.size();
+            blob.stored = std::move(compressed);
+        }
+    }
+    if (blob.entry.codec == Compression::Codec::None) {
+        blob.stored = data;
+    }
+
+    blobs.push_back(std::move(blob));
+}
+
+void AssetPackWriter::write(const char* path) const {
+    const uint32_t entry_count = (uint32_t)blobs.size();
+    const uint32_t slot_count = std::bit_ceil(std::max(2u, entry_count * 2));
+
+    std::vector<AssetPackFormat::Entry> entries(entry_count);
+    std::vector<uint32_t> slots(slot_count, 0);
+
+    const uint64_t table_end = sizeof(AssetPackFormat::Header) + entry_count * sizeof(AssetPackFormat::Entry) +
+        slot_count * sizeof(uint32_t);
+    uint64_t offset = alignUp(table_end, AssetPackFormat::BLOB_ALIGNMENT);
+    for (uint32_t i = 0; i < entry_count; i++) {
+        entries[i] = blobs[i].entry;
+        entries[i].offset = offset;
+        offset = alignUp(offset + entries[i].stored_size, AssetPackFormat::BLOB_ALIGNMENT);
+
+        uint32_t slot = (uint32_t)entries[i].name_hash & (slot_count - 1);
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & (slot_count - 1);
+        }
+        slots[slot] = i + 1;
+    }
+    // The last blob isn't padded out, so the file ends right after it, or after the tables if there are none
+    uint64_t file_size = entry_count ? entries.back().offset + entries.back().stored_size : table_end;
+
+    AssetPackFormat::Header header {};
+    std::memcpy(header.magic, AssetPackFormat::MAGIC, sizeof(header.magic));
+    header.version = AssetPackFormat::VERSION;
+    header.entry_count = entry_count;
+    header.slot_count = slot_count;
+    header.file_size = file_size;
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error(std::string("Failed to create asset pack ") + path);
+    }
+
+    auto writeAt = [&](uint64_t position, const void* data, size_t size) {
+        std::vector<char> padding(position - (uint64_t)file.tellp(), 0);
+        file.write(padding.data(), padding.size());
+        file.write(static_cast<const char*>(data), size);
+    };
+
+    writeAt(0, &header, sizeof(header));
+    writeAt(sizeof(header), entries.data(), entries.size() * sizeof(AssetPackFormat::Entry));
+    file.write(reinterpret_cast<const char*>(slots.data()), slots.size() * sizeof(uint32_t));
+    for (uint32_t i = 0; i < entry_count; i++) {
+        writeAt(entries[i].offset, blobs[i].stored.data(), blobs[i].stored.size());
+    }
+
+    if (!file) {
+        throw std::runtime_error(std::string("Failed to write asset pack ") + path);
+    }
+}
+
+uint64_t AssetPackWriter::getStoredSize() const {
+    uint64_t size = 0;
+    for (const Blob& blob : blobs) {
+        size += blob.entry.stored_size;
+    }
+    return size;
+}
@@ -0,0 +1,44 @@
+#ifndef _MEADOW_ASSET_PACK_WRITER_HPP_
+#define _MEADOW_ASSET_PACK_WRITER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "AssetPackFormat.hpp"
+
+/**
+ * @brief Builds an asset pack; used by the MeadowPacker tool.
+ *
+ * Assets are compressed as they are added, so only their stored bytes are
+ * kept in memory until write().
+ */
+class AssetPackWriter {
+    struct Blob {
+        std::string name;
+        AssetPackFormat::Entry entry;
+        std::vector<std::byte> stored;
+    };
+
+    std::vector<Blob> blobs;
+
+public:
+    /**
+     * @brief Adds an asset under a name, compressed with codec if that makes it meaningfully smaller.
+     * Throws std::runtime_error if the name (or its hash) is already taken.
+     */
+    void add(const std::string& name, const std::vector<std::byte>& data, Compression::Codec codec = Compression::Codec::None);
+
+    /**
+     * @brief Writes the pack. Throws std::runtime_error on failure.
+     */
+    void write(const char* path) const;
+
+    inline size_t getCount() const { return blobs.size(); }
+
+    /**
+     * @brief Total bytes of blob data, before alignment padding.
+     */
+    uint64_t getStoredSize() const;
+};
+
+#endif // _MEADOW_ASSET_PACK_WRITER_HPP_
@@ -0,0 +1,138 @@
+#include "Compression.hpp"
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#ifdef MEADOW_HAS_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#ifdef MEADOW_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+#ifdef MEADOW_HAS_ZSTD
+    const int ZSTD_PACK_LEVEL = 19;
+#endif
+
+#if !defined(MEADOW_HAS_LZ4) || !defined(MEADOW_HAS_ZSTD)
+    [[noreturn]] void unavailable(Compression::Codec codec) {
+        throw std::runtime_error(std::string("Meadow was built without ") + Compression::getName(codec) + " support");
+    }
+#endif
+}
+
+bool Compression::isAvailable(Codec codec) {
+    switch (codec) {
+        case Codec::None:
+            return true;
+        case Codec::LZ4:
+#ifdef MEADOW_HAS_LZ4
+            return true;
+#else
+            return false;
+#endif
+        case Codec::Zstd:
+#ifdef MEADOW_HAS_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* Compression::getName(Codec codec) {
+    switch (codec) {
+        case Codec::None:
+            return "none";
+        case Codec::LZ4:
+            return "LZ4";
+        case Codec::Zstd:
+            return "zstd";
+    }
+    return "unknown";
+}
+
+std::vector<std::byte> Compression::compress(Codec codec, const std::byte* data, size_t size) {
+    switch (codec) {
+        case Codec::None:
+            return std::vector<std::byte>(data, data + size);
+
+        case Codec::LZ4: {
+#ifdef MEADOW_HAS_LZ4
+            if (size > LZ4_MAX_INPUT_SIZE) {
+                throw std::runtime_error("Failed to compress: block too large for LZ4");
+            }
+            std::vector<std::byte> compressed(LZ4_compressBound((int)size));
+            int compressed_size = LZ4_compress_HC(reinterpret_cast<const char*>(data),
+                reinterpret_cast<char*>(compressed.data()), (int)size, (int)compressed.size(), LZ4HC_CLEVEL_DEFAULT);
+            if (compressed_size <= 0) {
+                throw std::runtime_error("Failed to compress block with LZ4");
+            }
+            compressed.resize(compressed_size);
+            return compressed;
+#else
+            unavailable(codec);
+#endif
+        }
+
+        case Codec::Zstd: {
+#ifdef MEADOW_HAS_ZSTD
+            std::vector<std::byte> compressed(ZSTD_compressBound(size));
+            size_t compressed_size = ZSTD_compress(compressed.data(), compressed.size(), data, size, ZSTD_PACK_LEVEL);
+            if (ZSTD_isError(compressed_size)) {
+                throw std::runtime_error(std::string("Failed to compress block with zstd: ") + ZSTD_getErrorName(compressed_size));
+            }
+            compressed.resize(compressed_size);
+            return compressed;
+#else
+            unavailable(codec);
+#endif
+        }
+    }
+    throw std::runtime_error("Failed to compress: unknown codec");
+}
+
+void Compression::decompress(Codec codec, const std::byte* source, size_t source_size, std::byte* destination, size_t size) {
+    switch (codec) {
+        case Codec::None:
+            if (source_size != size) {
+                throw std::runtime_error("Failed to copy block: size mismatch");
+            }
+            std::memcpy(destination, source, size);
+            return;
+
+        case Codec::LZ4: {
+#ifdef MEADOW_HAS_LZ4
+            if (source_size > (size_t)std::numeric_limits<int>::max() || size > LZ4_MAX_INPUT_SIZE) {
+                throw std::runtime_error("Failed to decompress: block too large for LZ4");
+            }
+            int decompressed = LZ4_decompress_safe(reinterpret_cast<const char*>(source),
+                reinterpret_cast<char*>(destination), (int)source_size, (int)size);
+            if (decompressed < 0 || (size_t)decompressed != size) {
+                throw std::runtime_error("Failed to decompress LZ4 block: corrupt data");
+            }
+            return;
+#else
+            unavailable(codec);
+#endif
+        }
+
+        case Codec::Zstd: {
+#ifdef MEADOW_HAS_ZSTD
+            size_t decompressed = ZSTD_decompress(destination, size, source, source_size);
+            if (ZSTD_isError(decompressed) || decompressed != size) {
+                throw std::runtime_error("Failed to decompress zstd block: corrupt data");
+            }
+            return;
+#else
+            unavailable(codec);
+#endif
+        }
+    }
+    throw std::runtime_error("Failed to decompress: unknown codec");
+}
@@ -0,0 +1,39 @@
+#ifndef _MEADOW_COMPRESSION_HPP_
+#define _MEADOW_COMPRESSION_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Block compression for packed assets.
+ *
+ * LZ4 and zstd are optional; each is compiled in only when CMake finds the
+ * library (MEADOW_HAS_LZ4, MEADOW_HAS_ZSTD). Packing favours ratio (LZ4 HC,
+ * zstd level 19) since it happens offline, while both decoders are fast
+ * enough to run straight into staging memory at load time.
+ */
+namespace Compression {
+    enum class Codec : uint32_t {
+        None = 0,
+        LZ4 = 1,
+        Zstd = 2
+    };
+
+    bool isAvailable(Codec codec);
+
+    const char* getName(Codec codec);
+
+    /**
+     * @brief Compresses a block. Throws std::runtime_error if the codec is unavailable or fails.
+     */
+    std::vector<std::byte> compress(Codec codec, const std::byte* data, size_t size);
+
+    /**
+     * @brief Decompresses a block into exactly size bytes at destination.
+     * Throws std::runtime_error if the codec is unavailable or the data is corrupt.
+     */
+    void decompress(Codec codec, const std::byte* source, size_t source_size, std::byte* destination, size_t size);
+}
+
+#endif // _MEADOW_COMPRESSION_HPP_
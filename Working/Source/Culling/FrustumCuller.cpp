@@ -0,0 +1,318 @@
+#include "FrustumCuller.hpp"
+#include "Config.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define MEADOW_CULLING_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+    #endif
+#endif
+
+// GCC and Clang only emit AVX instructions inside functions compiled for them;
+// MSVC accepts the intrinsics anywhere
+#if defined(__GNUC__)
+    #define MEADOW_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define MEADOW_TARGET(isa)
+#endif
+
+namespace {
+    using Planes = FrustumCuller::Planes;
+    using Spheres = FrustumCuller::Spheres;
+    using CullFunction = uint32_t (*)(const Planes&, const Spheres&, uint32_t, uint32_t, uint32_t*);
+
+#ifndef MEADOW_CULLING_X86
+    uint32_t cullScalar(const Planes& planes, const Spheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible) {
+        uint32_t written = 0;
+        for (uint32_t i = begin; i < end; i++) {
+            bool inside = true;
+            for (int p = 0; p < 6 && inside; p++) {
+                float sphere_distance = planes.normal_x[p] * spheres.center_x[i]
+                    + planes.normal_y[p] * spheres.center_y[i]
+                    + planes.normal_z[p] * spheres.center_z[i]
+                    + planes.distance[p];
+                float corner_distance = planes.normal_x[p] * planes.corner_x[p][i]
+                    + planes.normal_y[p] * planes.corner_y[p][i]
+                    + planes.normal_z[p] * planes.corner_z[p][i]
+                    + planes.distance[p];
+                inside = sphere_distance >= -spheres.radius[i] && corner_distance >= 0.0f;
+            }
+            if (inside) {
+                visible[written++] = i;
+            }
+        }
+        return written;
+    }
+#else
+    uint32_t cullSse(const Planes& planes, const Spheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible) {
+        uint32_t written = 0;
+        const __m128 zero = _mm_setzero_ps();
+        for (uint32_t i = begin; i < end; i += 4) {
+            __m128 center_x = _mm_loadu_ps(spheres.center_x + i);
+            __m128 center_y = _mm_loadu_ps(spheres.center_y + i);
+            __m128 center_z = _mm_loadu_ps(spheres.center_z + i);
+            __m128 negative_radius = _mm_sub_ps(zero, _mm_loadu_ps(spheres.radius + i));
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+            for (int p = 0; p < 6; p++) {
+                __m128 normal_x = _mm_set1_ps(planes.normal_x[p]);
+                __m128 normal_y = _mm_set1_ps(planes.normal_y[p]);
+                __m128 normal_z = _mm_set1_ps(planes.normal_z[p]);
+                __m128 distance = _mm_set1_ps(planes.distance[p]);
+
+                __m128 sphere_distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normal_x, center_x),
+                    _mm_mul_ps(normal_y, center_y)), _mm_add_ps(_mm_mul_ps(normal_z, center_z), distance));
+                __m128 corner_distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(normal_x, _mm_loadu_ps(planes.corner_x[p] + i)),
+                        _mm_mul_ps(normal_y, _mm_loadu_ps(planes.corner_y[p] + i))),
+                    _mm_add_ps(_mm_mul_ps(normal_z, _mm_loadu_ps(planes.corner_z[p] + i)), distance));
+
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(sphere_distance, negative_radius));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(corner_distance, zero));
+            }
+
+            for (uint32_t mask = (uint32_t)_mm_movemask_ps(inside); mask; mask &= mask - 1) {
+                visible[written++] = i + std::countr_zero(mask);
+            }
+        }
+        return written;
+    }
+
+    MEADOW_TARGET("avx2,fma")
+    uint32_t cullAvx2(const Planes& planes, const Spheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible) {
+        uint32_t written = 0;
+        const __m256 zero = _mm256_setzero_ps();
+        for (uint32_t i = begin; i < end; i += 8) {
+            __m256 center_x = _mm256_loadu_ps(spheres.center_x + i);
+            __m256 center_y = _mm256_loadu_ps(spheres.center_y + i);
+            __m256 center_z = _mm256_loadu_ps(spheres.center_z + i);
+            __m256 negative_radius = _mm256_sub_ps(zero, _mm256_loadu_ps(spheres.radius + i));
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+            for (int p = 0; p < 6; p++) {
+                __m256 normal_x = _mm256_set1_ps(planes.normal_x[p]);
+                __m256 normal_y = _mm256_set1_ps(planes.normal_y[p]);
+                __m256 normal_z = _mm256_set1_ps(planes.normal_z[p]);
+                __m256 distance = _mm256_set1_ps(planes.distance[p]);
+
+                __m256 sphere_distance = _mm256_fmadd_ps(normal_x, center_x,
+                    _mm256_fmadd_ps(normal_y, center_y, _mm256_fmadd_ps(normal_z, center_z, distance)));
+                __m256 corner_distance = _mm256_fmadd_ps(normal_x, _mm256_loadu_ps(planes.corner_x[p] + i),
+                    _mm256_fmadd_ps(normal_y, _mm256_loadu_ps(planes.corner_y[p] + i),
+                        _mm256_fmadd_ps(normal_z, _mm256_loadu_ps(planes.corner_z[p] + i), distance)));
+
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(sphere_distance, negative_radius, _CMP_GE_OQ));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(corner_distance, zero, _CMP_GE_OQ));
+            }
+
+            for (uint32_t mask = (uint32_t)_mm256_movemask_ps(inside); mask; mask &= mask - 1) {
+                visible[written++] = i + std::countr_zero(mask);
+            }
+        }
+        return written;
+    }
+
+    MEADOW_TARGET("avx512f")
+    uint32_t cullAvx512(const Planes& planes, const Spheres& spheres, uint32_t begin, uint32_t end, uint32_t* visible) {
+        uint32_t written = 0;
+        const __m512 zero = _mm512_setzero_ps();
+        const __m512i lane_index = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+        for (uint32_t i = begin; i < end; i += 16) {
+            __m512 center_x = _mm512_loadu_ps(spheres.center_x + i);
+            __m512 center_y = _mm512_loadu_ps(spheres.center_y + i);
+            __m512 center_z = _mm512_loadu_ps(spheres.center_z + i);
+            __m512 negative_radius = _mm512_sub_ps(zero, _mm512_loadu_ps(spheres.radius + i));
+            __mmask16 inside = 0xFFFF;
+
+            for (int p = 0; p < 6; p++) {
+                __m512 normal_x = _mm512_set1_ps(planes.normal_x[p]);
+                __m512 normal_y = _mm512_set1_ps(planes.normal_y[p]);
+                __m512 normal_z = _mm512_set1_ps(planes.normal_z[p]);
+                __m512 distance = _mm512_set1_ps(planes.distance[p]);
+
+                __m512 sphere_distance = _mm512_fmadd_ps(normal_x, center_x,
+                    _mm512_fmadd_ps(normal_y, center_y, _mm512_fmadd_ps(normal_z, center_z, distance)));
+                __m512 corner_distance = _mm512_fmadd_ps(normal_x, _mm512_loadu_ps(planes.corner_x[p] + i),
+                    _mm512_fmadd_ps(normal_y, _mm512_loadu_ps(planes.corner_y[p] + i),
+                        _mm512_fmadd_ps(normal_z, _mm512_loadu_ps(planes.corner_z[p] + i), distance)));
+
+                inside = _mm512_mask_cmp_ps_mask(inside, sphere_distance, negative_radius, _CMP_GE_OQ);
+                inside = _mm512_mask_cmp_ps_mask(inside, corner_distance, zero, _CMP_GE_OQ);
+            }
+
+            // Compress-store writes the visible lanes' indices contiguously in one instruction
+            _mm512_mask_compressstoreu_epi32(visible + written, inside,
+                _mm512_add_epi32(_mm512_set1_epi32((int)i), lane_index));
+            written += std::popcount((uint32_t)inside);
+        }
+        return written;
+    }
+
+    bool supportsAvx2() {
+    #if defined(__GNUC__)
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    #else
+        int info[4];
+        __cpuid(info, 1);
+        bool os_saves_ymm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+        bool fma = info[2] & (1 << 12);
+        __cpuidex(info, 7, 0);
+        return os_saves_ymm && fma && (info[1] & (1 << 5));
+    #endif
+    }
+
+    bool supportsAvx512() {
+    #if defined(__GNUC__)
+        return __builtin_cpu_supports("avx512f");
+    #else
+        int info[4];
+        __cpuid(info, 1);
+        bool os_saves_zmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0xE6) == 0xE6;
+        __cpuidex(info, 7, 0);
+        return os_saves_zmm && (info[1] & (1 << 16));
+    #endif
+    }
+#endif
+
+    struct Kernel {
+        CullFunction function;
+        const char* name;
+    };
+
+    Kernel selectKernel() {
+    #ifdef MEADOW_CULLING_X86
+        if (supportsAvx512()) {
+            return {cullAvx512, "AVX-512"};
+        }
+        if (supportsAvx2()) {
+            return {cullAvx2, "AVX2"};
+        }
+        return {cullSse, "SSE"};
+    #else
+        return {cullScalar, "scalar"};
+    #endif
+    }
+
+    const Kernel& kernel() {
+        static const Kernel selected = selectKernel();
+        return selected;
+    }
+}
+
+Frustum Frustum::fromViewProjection(const Math::Mat4& m) {
+    // Gribb-Hartmann: each clip-space inequality -w <= x <= w etc. is a plane in world space
+    auto row_plane = [&m](float sx, float sy, float sz, float sw) {
+        auto combine = [&](int column) {
+            return sx * m.at(0, column) + sy * m.at(1, column) + sz * m.at(2, column) + sw * m.at(3, column);
+        };
+        return Math::Plane{ {combine(0), combine(1), combine(2)}, combine(3) }.normalized();
+    };
+
+    return {{
+        row_plane( 1.0f,  0.0f,  0.0f, 1.0f), // left:   x >= -w
+        row_plane(-1.0f,  0.0f,  0.0f, 1.0f), // right:  x <= w
+        row_plane( 0.0f,  1.0f,  0.0f, 1.0f), // top:    y >= -w (Vulkan's y points down)
+        row_plane( 0.0f, -1.0f,  0.0f, 1.0f), // bottom: y <= w
+        row_plane( 0.0f,  0.0f,  1.0f, 0.0f), // near:   z >= 0
+        row_plane( 0.0f,  0.0f, -1.0f, 1.0f)  // far:    z <= w
+    }};
+}
+
+FrustumCuller::FrustumCuller() : count(0) {}
+
+uint32_t FrustumCuller::add(const BoundingSphere& sphere, const BoundingBox& box) {
+    uint32_t index = count;
+    resize(count + 1);
+    update(index, sphere, box);
+    return index;
+}
+
+void FrustumCuller::update(uint32_t index, const BoundingSphere& sphere, const BoundingBox& box) {
+    center_x[index] = sphere.center.x;
+    center_y[index] = sphere.center.y;
+    center_z[index] = sphere.center.z;
+    radius[index] = sphere.radius;
+    min_x[index] = box.min.x;
+    min_y[index] = box.min.y;
+    min_z[index] = box.min.z;
+    max_x[index] = box.max.x;
+    max_y[index] = box.max.y;
+    max_z[index] = box.max.z;
+}
+
+void FrustumCuller::clear() {
+    resize(0);
+}
+
+void FrustumCuller::resize(uint32_t new_count) {
+    // Padding lanes get an infinitely negative radius, which fails every sphere test
+    const uint32_t padded = (new_count + BATCH_SIZE - 1) / BATCH_SIZE * BATCH_SIZE;
+    const float never = -std::numeric_limits<float>::infinity();
+
+    for (auto* stream : {&center_x, &center_y, &center_z, &min_x, &min_y, &min_z, &max_x, &max_y, &max_z}) {
+        stream->resize(padded, 0.0f);
+    }
+    radius.resize(padded, never);
+    std::fill(radius.begin() + std::min<size_t>(new_count, count), radius.end(), never);
+
+    count = new_count;
+}
+
+uint32_t FrustumCuller::cull(const Frustum& frustum, std::vector<uint32_t>& visible, JobSystem* jobs) const {
+    Planes planes;
+    for (int p = 0; p < 6; p++) {
+        const Math::Plane& plane = frustum.planes[p];
+        planes.normal_x[p] = plane.normal.x;
+        planes.normal_y[p] = plane.normal.y;
+        planes.normal_z[p] = plane.normal.z;
+        planes.distance[p] = plane.distance;
+
+        // The box corner furthest along the normal decides whether any of the box is inside
+        planes.corner_x[p] = plane.normal.x >= 0.0f ? max_x.data() : min_x.data();
+        planes.corner_y[p] = plane.normal.y >= 0.0f ? max_y.data() : min_y.data();
+        planes.corner_z[p] = plane.normal.z >= 0.0f ? max_z.data() : min_z.data();
+    }
+
+    Spheres spheres = {center_x.data(), center_y.data(), center_z.data(), radius.data()};
+
+    const uint32_t padded = (uint32_t)radius.size();
+    visible.resize(padded);
+
+    const CullFunction function = kernel().function;
+
+    if (!jobs || count < CONSTANTS::CULLING_PARALLEL_THRESHOLD) {
+        visible.resize(function(planes, spheres, 0, padded, visible.data()));
+        return (uint32_t)visible.size();
+    }
+
+    // Each chunk writes into its own region of the output, then the regions are packed together.
+    // A few chunks per thread lets stealing even out chunks that happen to be mostly visible.
+    const uint32_t chunk_count = jobs->getThreadCount() * 4;
+    const uint32_t chunk_size = (padded / chunk_count + BATCH_SIZE - 1) / BATCH_SIZE * BATCH_SIZE;
+    const uint32_t used_chunks = (padded + chunk_size - 1) / chunk_size;
+
+    std::vector<uint32_t> written(used_chunks);
+    jobs->parallelFor(used_chunks, 1, [&](uint32_t first_chunk, uint32_t last_chunk) {
+        for (uint32_t chunk = first_chunk; chunk < last_chunk; chunk++) {
+            uint32_t begin = chunk * chunk_size;
+            written[chunk] = function(planes, spheres, begin, std::min(begin + chunk_size, padded), visible.data() + begin);
+        }
+    });
+
+    uint32_t total = written[0];
+    for (uint32_t chunk = 1; chunk < used_chunks; chunk++) {
+        std::memmove(visible.data() + total, visible.data() + chunk * chunk_size, written[chunk] * sizeof(uint32_t));
+        total += written[chunk];
+    }
+    visible.resize(total);
+    return total;
+}
+
+const char* FrustumCuller::getInstructionSet() {
+    return kernel().name;
+}
@@ -0,0 +1,123 @@
+#ifndef _MEADOW_FRUSTUM_CULLER_HPP_
+#define _MEADOW_FRUSTUM_CULLER_HPP_
+
+#include <cstdint>
+#include <vector>
+#include "Math.hpp"
+#include "JobSystem.hpp"
+
+/**
+ * @brief The six planes of a view frustum, normals facing inwards.
+ */
+struct Frustum {
+    Math::Plane planes[6];
+
+    /**
+     * @brief Extracts the planes of a view-projection matrix with Vulkan's [0, 1] clip depth.
+     */
+    static Frustum fromViewProjection(const Math::Mat4& view_projection);
+};
+
+struct BoundingSphere {
+    Math::Vec3 center;
+    float radius;
+};
+
+struct BoundingBox {
+    Math::Vec3 min;
+    Math::Vec3 max;
+};
+
+/**
+ * @brief Culls object bounds against a frustum, many objects per instruction.
+ *
+ * Bounds are kept as structure-of-arrays streams so each frustum plane is
+ * tested against 16 (AVX-512), 8 (AVX2) or 4 (SSE) objects at once. The
+ * instruction set is picked at runtime from what the CPU supports; other
+ * architectures use a scalar loop. An object is visible when both its
+ * sphere and its box are at least partly inside every plane.
+ *
+ * Large object counts are split into chunks culled in parallel on a JobSystem.
+ */
+class FrustumCuller {
+    uint32_t count;
+
+    // Streams are padded to a multiple of the widest vector with bounds that never pass
+    std::vector<float> center_x;
+    std::vector<float> center_y;
+    std::vector<float> center_z;
+    std::vector<float> radius;
+    std::vector<float> min_x;
+    std::vector<float> min_y;
+    std::vector<float> min_z;
+    std::vector<float> max_x;
+    std::vector<float> max_y;
+    std::vector<float> max_z;
+
+public:
+    FrustumCuller();
+
+    /**
+     * @brief Adds an object's bounds.
+     *
+     * @return The object's index, which cull() reports when it is visible.
+     */
+    uint32_t add(const BoundingSphere& sphere, const BoundingBox& box);
+
+    /**
+     * @brief Replaces the bounds of an object, e.g. after it moved.
+     */
+    void update(uint32_t index, const BoundingSphere& sphere, const BoundingBox& box);
+
+    void clear();
+
+    /**
+     * @brief Writes the indices of every object intersecting the frustum, in ascending order.
+     *
+     * @param visible Replaced with the compact visible-index list.
+     * @param jobs Spreads large counts across the pool; without it the calling thread culls everything.
+     * @return The number of visible objects.
+     */
+    uint32_t cull(const Frustum& frustum, std::vector<uint32_t>& visible, JobSystem* jobs = nullptr) const;
+
+    inline uint32_t getCount() const { return count; }
+
+    /**
+     * @brief Name of the instruction set cull() runs with on this machine.
+     */
+    static const char* getInstructionSet();
+
+    /**
+     * @brief Objects per lane group; stream sizes are padded to a multiple of this.
+     */
+    static constexpr uint32_t BATCH_SIZE = 16;
+
+    /**
+     * @brief Everything one cull needs: the plane coefficients, and for each plane the box
+     * corner streams furthest along its normal.
+     */
+    struct Planes {
+        float normal_x[6];
+        float normal_y[6];
+        float normal_z[6];
+        float distance[6];
+        const float* corner_x[6];
+        const float* corner_y[6];
+        const float* corner_z[6];
+    };
+
+    /**
+     * @brief The sphere streams a cull reads.
+     */
+    struct Spheres {
+        const float* center_x;
+        const float* center_y;
+        const float* center_z;
+        const float* radius;
+    };
+
+private:
+    void resize(uint32_t new_count);
+};
+
+#endif // _MEADOW_FRUSTUM_CULLER_HPP_
@@ -0,0 +1,445 @@
+#include "OcclusionCuller.hpp"
+#include "Config.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t CULL_GROUP_SIZE = 64;
+    constexpr uint32_t REDUCE_GROUP_SIZE = 8;
+
+    // Both phases' parameters share a buffer; 256 satisfies every device's minUniformBufferOffsetAlignment
+    constexpr VkDeviceSize PARAMS_STRIDE = 256;
+
+    uint32_t previousPowerOfTwo(uint32_t value) {
+        uint32_t power = 1;
+        while (power * 2 <= value) {
+            power *= 2;
+        }
+        return power;
+    }
+
+    VkMemoryBarrier computeBarrier(VkAccessFlags src_access, VkAccessFlags dst_access) {
+        return {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER,
+            .srcAccessMask = src_access,
+            .dstAccessMask = dst_access
+        };
+    }
+}
+
+OcclusionCuller::OcclusionCuller(const GraphicsContext& context, DescriptorAllocator& descriptors, uint32_t capacity,
+    VkSampleCountFlagBits depth_samples) :
+    context(context),
+    descriptors(descriptors),
+    capacity(capacity),
+    cull_shaders(context.getLogicalDevice()),
+    reduce_shaders(context.getLogicalDevice()),
+    multisample_reduce_shaders(context.getLogicalDevice()),
+    pyramid_view(VK_NULL_HANDLE),
+    depth_extent{0, 0},
+    current_frame(0),
+    needs_initialization(true)
+{
+    static_assert(sizeof(GpuObject) == 48, "GpuObject must match the std430 layout of the cull shader");
+    static_assert(sizeof(CullParams) <= PARAMS_STRIDE);
+
+    cull_shaders.load(SHADER_BINARY_DIR "OcclusionCull.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+    reduce_shaders.load(SHADER_BINARY_DIR "HiZReduce.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+
+    createSetLayouts();
+    cull_pipeline = std::make_unique<ComputePipeline>(context, cull_shaders, SetLayouts{cull_set_layout});
+    reduce_pipeline = std::make_unique<ComputePipeline>(context, reduce_shaders, SetLayouts{reduce_set_layout});
+
+    // A multisampled image can only be fetched per sample through a sampler2DMS
+    if (depth_samples != VK_SAMPLE_COUNT_1_BIT) {
+        multisample_reduce_shaders.load(SHADER_BINARY_DIR "HiZReduceMultisample.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+        multisample_reduce_pipeline = std::make_unique<ComputePipeline>(context, multisample_reduce_shaders,
+            SetLayouts{reduce_set_layout});
+    }
+    createSampler();
+
+    const VkDeviceSize draws_size = std::max(1u, capacity) * sizeof(VkDrawIndexedIndirectCommand);
+
+    visibility = std::make_unique<Buffer>(context, std::max(1u, capacity) * sizeof(uint32_t),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    frames.resize(CONSTANTS::FRAMES_IN_FLIGHT);
+    for (auto& frame : frames) {
+        frame.params = std::make_unique<Buffer>(context, 2 * PARAMS_STRIDE, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        frame.objects = std::make_unique<Buffer>(context, std::max(1u, capacity) * sizeof(GpuObject), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        frame.early_draws = std::make_unique<Buffer>(context, draws_size,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        frame.late_draws = std::make_unique<Buffer>(context, draws_size,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        frame.objects_stale = false;
+    }
+}
+
+OcclusionCuller::~OcclusionCuller() {
+    destroyPyramid();
+    vkDestroySampler(context.getLogicalDevice(), pyramid_sampler, nullptr);
+
+    // The pipelines reference the shader collections and set layouts, so go first
+    cull_pipeline.reset();
+    reduce_pipeline.reset();
+    multisample_reduce_pipeline.reset();
+    vkDestroyDescriptorSetLayout(context.getLogicalDevice(), cull_set_layout, nullptr);
+    vkDestroyDescriptorSetLayout(context.getLogicalDevice(), reduce_set_layout, nullptr);
+}
+
+void OcclusionCuller::setObjects(const std::vector<Object>& new_objects) {
+    if (new_objects.size() > capacity) {
+        throw std::runtime_error("Failed to set occlusion culling objects: more objects than the culler's capacity!");
+    }
+
+    objects = new_objects;
+    for (auto& frame : frames) {
+        frame.objects_stale = true;
+    }
+}
+
+void OcclusionCuller::beginFrame(uint32_t frame_index) {
+    current_frame = frame_index;
+}
+
+void OcclusionCuller::addPasses(RenderGraph& graph, RenderGraph::ResourceHandle color, RenderGraph::ResourceHandle depth,
+    VkExtent2D extent, const Math::Mat4& view_projection, DrawFunction draw, std::optional<VkClearColorValue> clear_color)
+{
+    if (extent.width != depth_extent.width || extent.height != depth_extent.height) {
+        createPyramid(extent);
+    }
+
+    FrameData& frame = frames[current_frame];
+
+    // Frames in flight each read their own copy, so an update reaches each one in turn
+    if (frame.objects_stale) {
+        GpuObject* gpu_objects = (GpuObject*)frame.objects->getMapped();
+        for (uint32_t i = 0; i < objects.size(); i++) {
+            const BoundingSphere& sphere = objects[i].sphere;
+            gpu_objects[i] = {
+                .sphere = {sphere.center.x, sphere.center.y, sphere.center.z, sphere.radius},
+                .draw = objects[i].draw,
+                .padding = {}
+            };
+        }
+        frame.objects_stale = false;
+    }
+
+    Frustum frustum = Frustum::fromViewProjection(view_projection);
+    for (uint32_t phase = 0; phase < 2; phase++) {
+        CullParams params {
+            .view_projection = view_projection,
+            .planes = {},
+            .pyramid_size = {(float)pyramid->getExtent().width, (float)pyramid->getExtent().height},
+            .object_count = (uint32_t)objects.size(),
+            .late_phase = phase
+        };
+        for (uint32_t i = 0; i < 6; i++) {
+            const Math::Plane& plane = frustum.planes[i];
+            params.planes[i][0] = plane.normal.x;
+            params.planes[i][1] = plane.normal.y;
+            params.planes[i][2] = plane.normal.z;
+            params.planes[i][3] = plane.distance;
+        }
+        std::memcpy((char*)frame.params->getMapped() + phase * PARAMS_STRIDE, &params, sizeof(params));
+    }
+
+    const uint32_t count = (uint32_t)objects.size();
+    VkBuffer early_buffer = frame.early_draws->getBuffer();
+    VkBuffer late_buffer = frame.late_draws->getBuffer();
+
+    RenderGraph::ResourceHandle visibility_resource = graph.importBuffer("occlusion_visibility", visibility->getBuffer());
+    RenderGraph::ResourceHandle early_draws = graph.importBuffer("occlusion_early_draws", early_buffer);
+    RenderGraph::ResourceHandle late_draws = graph.importBuffer("occlusion_late_draws", late_buffer);
+
+    graph.addPass("occlusion_early_cull", RenderGraph::PassType::Compute,
+        [&](RenderGraph::PassBuilder& builder) {
+            builder.readStorage(visibility_resource);
+            builder.writeStorage(early_draws);
+        },
+        [this, early_buffer](VkCommandBuffer command_buffer) {
+            recordCull(command_buffer, 0, early_buffer);
+        });
+
+    graph.addPass("occlusion_early_draw", RenderGraph::PassType::Raster,
+        [&](RenderGraph::PassBuilder& builder) {
+            builder.writeColor(color, clear_color);
+            builder.writeDepth(depth, VkClearDepthStencilValue{1.0f, 0});
+            builder.readIndirect(early_draws);
+        },
+        [draw, early_buffer, count](VkCommandBuffer command_buffer) {
+            draw(command_buffer, early_buffer, count);
+        });
+
+    // The pyramid lives outside the graph, so nothing the graph tracks consumes this pass
+    graph.addPass("occlusion_hiz_build", RenderGraph::PassType::Compute,
+        [&](RenderGraph::PassBuilder& builder) {
+            builder.readTexture(depth);
+            builder.setSideEffects();
+        },
+        [this, &graph, depth](VkCommandBuffer command_buffer) {
+            recordPyramid(command_buffer, graph.getImageView(depth));
+        });
+
+    graph.addPass("occlusion_late_cull", RenderGraph::PassType::Compute,
+        [&](RenderGraph::PassBuilder& builder) {
+            builder.writeStorage(visibility_resource);
+            builder.writeStorage(late_draws);
+        },
+        [this, late_buffer](VkCommandBuffer command_buffer) {
+            recordCull(command_buffer, 1, late_buffer);
+        });
+
+    graph.addPass("occlusion_late_draw", RenderGraph::PassType::Raster,
+        [&](RenderGraph::PassBuilder& builder) {
+            builder.writeColor(color);
+            builder.writeDepth(depth);
+            builder.readIndirect(late_draws);
+        },
+        [draw, late_buffer, count](VkCommandBuffer command_buffer) {
+            draw(command_buffer, late_buffer, count);
+        });
+}
+
+void OcclusionCuller::drawIndirect(VkCommandBuffer command_buffer, VkBuffer commands, uint32_t count) const {
+    const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    if (context.supportsMultiDrawIndirect()) {
+        vkCmdDrawIndexedIndirect(command_buffer, commands, 0, count, stride);
+        return;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        vkCmdDrawIndexedIndirect(command_buffer, commands, i * stride, 1, stride);
+    }
+}
+
+void OcclusionCuller::createSetLayouts() {
+    VkDescriptorSetLayoutBinding cull_bindings[5] = {
+        { .binding = 0, .descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .pImmutableSamplers = nullptr },
+        { .binding = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .pImmutableSamplers = nullptr },
+        { .binding = 2, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .pImmutableSamplers = nullptr },
+        { .binding = 3, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .pImmutableSamplers = nullptr },
+        { .binding = 4, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .pImmutableSamplers = nullptr }
+    };
+
+    VkDescriptorSetLayoutBinding reduce_bindings[2] = {
+        { .binding = 0, .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .pImmutableSamplers = nullptr },
+        { .binding = 1, .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .descriptorCount = 1,
+            .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT, .pImmutableSamplers = nullptr }
+    };
+
+    VkDescriptorSetLayoutCreateInfo cull_layout_info {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = 5,
+        .pBindings = cull_bindings
+    };
+    if (vkCreateDescriptorSetLayout(context.getLogicalDevice(), &cull_layout_info, nullptr, &cull_set_layout)) {
+        throw std::runtime_error("Failed to create occlusion culling descriptor set layout");
+    }
+
+    VkDescriptorSetLayoutCreateInfo reduce_layout_info {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount = 2,
+        .pBindings = reduce_bindings
+    };
+    if (vkCreateDescriptorSetLayout(context.getLogicalDevice(), &reduce_layout_info, nullptr, &reduce_set_layout)) {
+        throw std::runtime_error("Failed to create Hi-Z descriptor set layout");
+    }
+}
+
+void OcclusionCuller::createSampler() {
+    // Point sampling of an explicit level; filtering would blend in nearer depths
+    VkSamplerCreateInfo sampler_info {
+        .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+        .magFilter = VK_FILTER_NEAREST,
+        .minFilter = VK_FILTER_NEAREST,
+        .mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST,
+        .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+        .mipLodBias = 0.0f,
+        .anisotropyEnable = VK_FALSE,
+        .maxAnisotropy = 1.0f,
+        .compareEnable = VK_FALSE,
+        .compareOp = VK_COMPARE_OP_ALWAYS,
+        .minLod = 0.0f,
+        .maxLod = VK_LOD_CLAMP_NONE,
+        .borderColor = VK_BORDER_COLOR_FLOAT_OPAQUE_WHITE,
+        .unnormalizedCoordinates = VK_FALSE
+    };
+    if (vkCreateSampler(context.getLogicalDevice(), &sampler_info, nullptr, &pyramid_sampler)) {
+        throw std::runtime_error("Failed to create Hi-Z sampler");
+    }
+}
+
+void OcclusionCuller::createPyramid(VkExtent2D extent) {
+    if (pyramid) {
+        destroyPyramid();
+    }
+
+    const uint32_t width = previousPowerOfTwo(std::max(1u, extent.width));
+    const uint32_t height = previousPowerOfTwo(std::max(1u, extent.height));
+    uint32_t level_count = 1;
+    while ((std::max(width, height) >> level_count) > 0) {
+        level_count++;
+    }
+
+    VkImageCreateInfo image_create_info {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = VK_FORMAT_R32_SFLOAT,
+        .extent = { width, height, 1 },
+        .mipLevels = level_count,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    pyramid = std::make_unique<Image>(context, image_create_info);
+
+    pyramid_view = pyramid->createView(VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT);
+    for (uint32_t level = 0; level < level_count; level++) {
+        pyramid_mips.push_back(pyramid->createView(VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT, level, 1));
+    }
+
+    depth_extent = extent;
+    needs_initialization = true;
+}
+
+void OcclusionCuller::destroyPyramid() {
+    std::vector<VkImageView> views = std::move(pyramid_mips);
+    pyramid_mips.clear();
+    if (pyramid_view != VK_NULL_HANDLE) {
+        views.push_back(pyramid_view);
+        pyramid_view = VK_NULL_HANDLE;
+    }
+
+    // Earlier frames may still be sampling the old pyramid
+    VkDevice device = context.getLogicalDevice();
+    context.getDeletionQueue().push([device, views, image = std::shared_ptr<Image>(std::move(pyramid))]() {
+        for (VkImageView view : views) {
+            vkDestroyImageView(device, view, nullptr);
+        }
+    });
+}
+
+void OcclusionCuller::recordInitialization(VkCommandBuffer command_buffer) {
+    // With nothing visible the early phase draws nothing, and the late phase tests
+    // every object against the cleared depth, so the first frame is still complete
+    vkCmdFillBuffer(command_buffer, visibility->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+
+    VkBufferMemoryBarrier fill_barrier {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = visibility->getBuffer(),
+        .offset = 0,
+        .size = VK_WHOLE_SIZE
+    };
+
+    // Both phases bind the pyramid, so it has to be in GENERAL before the early cull
+    VkImageMemoryBarrier layout_barrier {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = 0,
+        .dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = pyramid->getImage(),
+        .subresourceRange = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .baseMipLevel = 0,
+            .levelCount = VK_REMAINING_MIP_LEVELS,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        }
+    };
+
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+        0, nullptr, 1, &fill_barrier, 1, &layout_barrier);
+
+    needs_initialization = false;
+}
+
+void OcclusionCuller::recordCull(VkCommandBuffer command_buffer, uint32_t phase, VkBuffer draws) {
+    FrameData& frame = frames[current_frame];
+
+    if (phase == 0) {
+        if (needs_initialization) {
+            recordInitialization(command_buffer);
+        }
+        else {
+            // The graph only orders accesses within a frame; the previous frame's late cull
+            // wrote the visibility this phase reads, and sampled the pyramid about to be rebuilt
+            VkMemoryBarrier barrier = computeBarrier(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+            vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                1, &barrier, 0, nullptr, 0, nullptr);
+        }
+    }
+
+    VkDescriptorSet set = descriptors.allocate(cull_set_layout, {
+        { .binding = 0, .type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .buffer = { frame.params->getBuffer(), phase * PARAMS_STRIDE, sizeof(CullParams) }, .image = {} },
+        { .binding = 1, .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .buffer = { frame.objects->getBuffer(), 0, VK_WHOLE_SIZE }, .image = {} },
+        { .binding = 2, .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .buffer = { visibility->getBuffer(), 0, VK_WHOLE_SIZE }, .image = {} },
+        { .binding = 3, .type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .buffer = { draws, 0, VK_WHOLE_SIZE }, .image = {} },
+        { .binding = 4, .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .buffer = {}, .image = { pyramid_sampler, pyramid_view, VK_IMAGE_LAYOUT_GENERAL } }
+    });
+
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, *cull_pipeline);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, cull_pipeline->getLayout(), 0, 1, &set, 0, nullptr);
+
+    const uint32_t count = (uint32_t)objects.size();
+    if (count > 0) {
+        vkCmdDispatch(command_buffer, (count + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+    }
+}
+
+void OcclusionCuller::recordPyramid(VkCommandBuffer command_buffer, VkImageView depth_view) {
+    const VkExtent3D& extent = pyramid->getExtent();
+    for (uint32_t level = 0; level < pyramid_mips.size(); level++) {
+        // Only level 0 reads the depth target, which may be multisampled
+        ComputePipeline& pipeline = level == 0 && multisample_reduce_pipeline ? *multisample_reduce_pipeline : *reduce_pipeline;
+        if (level <= 1) {
+            vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        }
+
+        VkDescriptorImageInfo source = level == 0
+            ? VkDescriptorImageInfo{ pyramid_sampler, depth_view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL }
+            : VkDescriptorImageInfo{ pyramid_sampler, pyramid_mips[level - 1], VK_IMAGE_LAYOUT_GENERAL };
+
+        VkDescriptorSet set = descriptors.allocate(reduce_set_layout, {
+            { .binding = 0, .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .buffer = {}, .image = source },
+            { .binding = 1, .type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+                .buffer = {}, .image = { VK_NULL_HANDLE, pyramid_mips[level], VK_IMAGE_LAYOUT_GENERAL } }
+        });
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.getLayout(), 0, 1, &set, 0, nullptr);
+
+        const uint32_t width = std::max(1u, extent.width >> level);
+        const uint32_t height = std::max(1u, extent.height >> level);
+        vkCmdDispatch(command_buffer, (width + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE,
+            (height + REDUCE_GROUP_SIZE - 1) / REDUCE_GROUP_SIZE, 1);
+
+        // Each level reads the one before it; the last barrier also covers the late cull
+        VkMemoryBarrier barrier = computeBarrier(VK_ACCESS_SHADER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT);
+        vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+            1, &barrier, 0, nullptr, 0, nullptr);
+    }
+}
@@ -0,0 +1,182 @@
+#ifndef _MEADOW_OCCLUSION_CULLER_HPP_
+#define _MEADOW_OCCLUSION_CULLER_HPP_
+
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+#include "GraphicsContext.hpp"
+#include "Buffer.hpp"
+#include "Image.hpp"
+#include "Shader.hpp"
+#include "ComputePipeline.hpp"
+#include "DescriptorAllocator.hpp"
+#include "RenderGraph.hpp"
+#include "FrustumCuller.hpp"
+#include "Math.hpp"
+
+/**
+ * @brief Two-phase occlusion culling on the GPU against a hierarchical depth (Hi-Z) pyramid.
+ *
+ * Every frame addPasses() declares five render graph passes:
+ * - early cull: a compute pass emits an indirect draw for every object that was
+ *   visible last frame and is still inside the frustum,
+ * - early draw: those objects are drawn, laying down most of the frame's depth,
+ * - Hi-Z build: a compute pass reduces that depth into a mip pyramid where each
+ *   texel holds the furthest depth of the area it covers,
+ * - late cull: every object's bounding sphere is projected to a screen rectangle
+ *   and tested against the pyramid level where it spans at most 2x2 texels; the
+ *   objects that passed and were not drawn early get a draw, and the results
+ *   become next frame's visibility,
+ * - late draw: the newly visible objects are drawn on top of the early depth.
+ *
+ * Culled objects keep their slot in the indirect buffer with an instance count of
+ * zero, so object indices stay stable and draws can be issued with a single
+ * multi-draw. Depth must use a depth-only format with LESS testing cleared to 1.0.
+ */
+class OcclusionCuller {
+public:
+    /**
+     * @brief An object's world-space bounds and the draw that renders it when visible.
+     */
+    struct Object {
+        BoundingSphere sphere;
+        VkDrawIndexedIndirectCommand draw;
+    };
+
+    /**
+     * @brief Records the draws of one phase inside its raster pass. Receives the indirect
+     * command buffer and its command count, typically passed on to drawIndirect().
+     */
+    using DrawFunction = std::function<void(VkCommandBuffer, VkBuffer, uint32_t)>;
+
+private:
+    /**
+     * @brief Object layout in the shader's std430 storage buffer.
+     */
+    struct GpuObject {
+        float sphere[4];
+        VkDrawIndexedIndirectCommand draw;
+        uint32_t padding[3];
+    };
+
+    /**
+     * @brief Uniform block of the cull shader, in std140 layout.
+     */
+    struct CullParams {
+        Math::Mat4 view_projection;
+        float planes[6][4];
+        float pyramid_size[2];
+        uint32_t object_count;
+        uint32_t late_phase;
+    };
+
+    struct FrameData {
+        std::unique_ptr<Buffer> params;      /**< One CullParams per phase, PARAMS_STRIDE apart. */
+        std::unique_ptr<Buffer> objects;
+        std::unique_ptr<Buffer> early_draws;
+        std::unique_ptr<Buffer> late_draws;
+        bool objects_stale;
+    };
+
+    const GraphicsContext& context;
+    DescriptorAllocator& descriptors;
+
+    uint32_t capacity;
+    std::vector<Object> objects;
+
+    ShaderCollection cull_shaders;
+    ShaderCollection reduce_shaders;
+    ShaderCollection multisample_reduce_shaders;
+    VkDescriptorSetLayout cull_set_layout;
+    VkDescriptorSetLayout reduce_set_layout;
+    std::unique_ptr<ComputePipeline> cull_pipeline;
+    std::unique_ptr<ComputePipeline> reduce_pipeline;
+    std::unique_ptr<ComputePipeline> multisample_reduce_pipeline; /**< Builds level 0 from multisampled depth; null without MSAA. */
+    VkSampler pyramid_sampler;
+
+    std::unique_ptr<Image> pyramid;
+    VkImageView pyramid_view;
+    std::vector<VkImageView> pyramid_mips;
+    VkExtent2D depth_extent;
+
+    std::unique_ptr<Buffer> visibility;     /**< Shared by all frames; written by each late cull. */
+    std::vector<FrameData> frames;
+    uint32_t current_frame;
+    bool needs_initialization;
+
+public:
+    /**
+     * @param descriptors Source of the per-pass descriptor sets; its frames must be begun alongside this culler's.
+     * @param capacity The most objects setObjects() may be given.
+     * @param depth_samples Sample count of the depth target given to addPasses(). A multisampled
+     * target is reduced over all its samples into the pyramid's level 0.
+     */
+    OcclusionCuller(const GraphicsContext& context, DescriptorAllocator& descriptors, uint32_t capacity,
+        VkSampleCountFlagBits depth_samples = VK_SAMPLE_COUNT_1_BIT);
+
+    ~OcclusionCuller();
+
+    OcclusionCuller(const OcclusionCuller&) = delete;
+    OcclusionCuller& operator=(const OcclusionCuller&) = delete;
+
+    /**
+     * @brief Replaces the objects to cull. An object's index is its identity: visibility
+     * carries over from the last frame by index, and each draw is written to that index
+     * of the indirect buffers.
+     */
+    void setObjects(const std::vector<Object>& new_objects);
+
+    /**
+     * @brief Selects the frame in flight whose buffers the next addPasses() fills. Must only be
+     * called once the frame's fence has signalled (see Frames::addFrameResetCallback).
+     */
+    void beginFrame(uint32_t frame_index);
+
+    /**
+     * @brief Declares the cull, draw and pyramid passes of one frame.
+     *
+     * @param color Color target of both draw passes.
+     * @param depth Depth target of both draw passes, also sampled to build the pyramid.
+     * @param extent Size of the depth target.
+     * @param clear_color Applied by the early draw pass; the depth is always cleared to 1.0.
+     */
+    void addPasses(RenderGraph& graph, RenderGraph::ResourceHandle color, RenderGraph::ResourceHandle depth,
+        VkExtent2D extent, const Math::Mat4& view_projection, DrawFunction draw,
+        std::optional<VkClearColorValue> clear_color = std::nullopt);
+
+    /**
+     * @brief Issues every command of an indirect buffer filled by this culler, as one
+     * multi-draw where the device supports it.
+     */
+    void drawIndirect(VkCommandBuffer command_buffer, VkBuffer commands, uint32_t count) const;
+
+    inline uint32_t getCount() const { return (uint32_t)objects.size(); }
+
+    inline uint32_t getCapacity() const { return capacity; }
+
+private:
+    void createSetLayouts();
+
+    void createSampler();
+
+    /**
+     * @brief (Re)creates the pyramid for a depth target size. Level 0 is the largest power
+     * of two no bigger than the depth target in each dimension.
+     */
+    void createPyramid(VkExtent2D extent);
+
+    void destroyPyramid();
+
+    /**
+     * @brief Clears the visibility and moves the pyramid to GENERAL, the first time it is used.
+     */
+    void recordInitialization(VkCommandBuffer command_buffer);
+
+    void recordCull(VkCommandBuffer command_buffer, uint32_t phase, VkBuffer draws);
+
+    void recordPyramid(VkCommandBuffer command_buffer, VkImageView depth_view);
+};
+
+#endif // _MEADOW_OCCLUSION_CULLER_HPP_
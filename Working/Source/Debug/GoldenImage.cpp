@@ -0,0 +1,141 @@
+#include "GoldenImage.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    // Largest possible weighted YIQ distance, between black and white
+    constexpr float MAX_YIQ_DELTA = 35215.0f;
+
+    constexpr uint32_t BYTES_PER_PIXEL = 4;
+
+    std::string goldenPath(const std::string& directory, uint64_t frame) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/frame_%06llu.raw", (unsigned long long)frame);
+        return directory + name;
+    }
+
+    bool isBgra(VkFormat format) {
+        return format == VK_FORMAT_B8G8R8A8_SRGB || format == VK_FORMAT_B8G8R8A8_UNORM;
+    }
+}
+
+float GoldenImage::distance(const uint8_t* a, const uint8_t* b, bool bgra) {
+    const int red = bgra ? 2 : 0;
+    const int blue = bgra ? 0 : 2;
+    const float dr = (float)a[red] - b[red];
+    const float dg = (float)a[1] - b[1];
+    const float db = (float)a[blue] - b[blue];
+
+    // YIQ weights from "Measuring perceived color difference using YIQ NTSC transmission
+    // color space in mobile applications" (Kotsarenko and Ramos)
+    const float y = dr * 0.29889531f + dg * 0.58662247f + db * 0.11448223f;
+    const float i = dr * 0.59597799f - dg * 0.27417610f - db * 0.32180189f;
+    const float q = dr * 0.21147017f - dg * 0.52261711f + db * 0.31114694f;
+    const float delta = 0.5053f * y * y + 0.299f * i * i + 0.1957f * q * q;
+    return std::sqrt(delta / MAX_YIQ_DELTA);
+}
+
+GoldenImage::Result GoldenImage::compare(const uint8_t* actual, const uint8_t* expected,
+    uint32_t width, uint32_t height, bool bgra, const Tolerance& tolerance)
+{
+    Result result {
+        .differing_pixels = 0,
+        .differing_fraction = 0.0,
+        .max_distance = 0.0f,
+        .passed = true
+    };
+
+    const uint64_t pixel_count = (uint64_t)width * height;
+    for (uint64_t i = 0; i < pixel_count; i++) {
+        const uint8_t* a = actual + i * BYTES_PER_PIXEL;
+        const uint8_t* b = expected + i * BYTES_PER_PIXEL;
+        if (a[0] == b[0] && a[1] == b[1] && a[2] == b[2]) {
+            continue;
+        }
+
+        const float pixel_distance = distance(a, b, bgra);
+        result.max_distance = std::max(result.max_distance, pixel_distance);
+        if (pixel_distance > tolerance.pixel_threshold) {
+            result.differing_pixels++;
+        }
+    }
+
+    result.differing_fraction = pixel_count > 0 ? (double)result.differing_pixels / pixel_count : 0.0;
+    result.passed = result.differing_fraction <= tolerance.max_differing_fraction;
+    return result;
+}
+
+GoldenImageCheck::GoldenImageCheck(std::string directory, GoldenImage::Tolerance tolerance, bool update) :
+    directory(std::move(directory)),
+    tolerance(tolerance),
+    update(update)
+{}
+
+FrameCapture::Sink GoldenImageCheck::sink() {
+    if (update) {
+        return FrameCapture::fileSink(directory, FrameCapture::Format::Raw);
+    }
+    return [this](const FrameCapture::Frame& frame) { check(frame); };
+}
+
+bool GoldenImageCheck::hasGoldenImage(uint64_t frame) const {
+    return std::ifstream(goldenPath(directory, frame), std::ios::binary).is_open();
+}
+
+bool GoldenImageCheck::passed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::all_of(entries.begin(), entries.end(), [](const Entry& entry) {
+        return entry.error.empty() && entry.result.passed;
+    });
+}
+
+void GoldenImageCheck::report(std::ostream& stream) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<Entry> sorted = entries;
+    std::sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) { return a.frame < b.frame; });
+
+    for (const auto& entry : sorted) {
+        stream << "[GOLDEN] Frame " << entry.frame << ": ";
+        if (!entry.error.empty()) {
+            stream << "FAILED, " << entry.error << std::endl;
+            continue;
+        }
+        stream << (entry.result.passed ? "passed, " : "FAILED, ") << entry.result.differing_pixels
+            << " pixels differ (" << entry.result.differing_fraction * 100.0 << "%), largest distance "
+            << entry.result.max_distance << std::endl;
+    }
+}
+
+void GoldenImageCheck::check(const FrameCapture::Frame& frame) {
+    Entry entry {
+        .frame = frame.index,
+        .error = {},
+        .result = {}
+    };
+
+    const std::string path = goldenPath(directory, frame.index);
+    const size_t size = (size_t)frame.width * frame.height * BYTES_PER_PIXEL;
+    std::ifstream file(path, std::ios::binary);
+    const bool found = file.is_open();
+    std::vector<uint8_t> expected;
+    if (found) {
+        expected.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    if (!found) {
+        entry.error = "no golden image at " + path;
+    }
+    else if (expected.size() != size) {
+        entry.error = "golden image " + path + " is not " + std::to_string(frame.width) + "x" + std::to_string(frame.height);
+    }
+    else {
+        entry.result = GoldenImage::compare(frame.pixels, expected.data(), frame.width, frame.height,
+            isBgra(frame.format), tolerance);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.push_back(std::move(entry));
+}
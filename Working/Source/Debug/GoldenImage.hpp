@@ -0,0 +1,90 @@
+#ifndef _MEADOW_GOLDEN_IMAGE_HPP_
+#define _MEADOW_GOLDEN_IMAGE_HPP_
+
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "FrameCapture.hpp"
+
+/**
+ * @brief Compares rendered frames against stored reference ("golden") images.
+ *
+ * Pixels are compared by their perceptual distance in YIQ space, as pixelmatch
+ * does, so differences the eye barely sees (rounding, dithering, driver-specific
+ * filtering) stay under the threshold while visible ones don't. A frame passes if
+ * few enough of its pixels are past the threshold.
+ */
+namespace GoldenImage {
+    struct Tolerance {
+        float pixel_threshold = 0.1f; /**< Perceptual distance in [0, 1] past which a pixel differs. */
+        double max_differing_fraction = 0.001; /**< Share of differing pixels a frame may have. */
+    };
+
+    struct Result {
+        uint64_t differing_pixels;
+        double differing_fraction;
+        float max_distance;
+        bool passed;
+    };
+
+    /**
+     * @brief Perceptual distance between two 8-bit pixels: 0 for equal, close to 1 for black against white.
+     */
+    float distance(const uint8_t* a, const uint8_t* b, bool bgra);
+
+    /**
+     * @brief Compares two tightly packed images of 4 bytes per pixel.
+     */
+    Result compare(const uint8_t* actual, const uint8_t* expected, uint32_t width, uint32_t height,
+        bool bgra, const Tolerance& tolerance = {});
+}
+
+/**
+ * @brief A FrameCapture sink checking each frame against directory/frame_<index>.raw, the
+ * files FrameCapture::fileSink writes in Format::Raw. In update mode it writes the
+ * frames as the new golden images instead.
+ */
+class GoldenImageCheck {
+    struct Entry {
+        uint64_t frame;
+        std::string error; /**< Empty when the frame could be compared. */
+        GoldenImage::Result result;
+    };
+
+    std::string directory;
+    GoldenImage::Tolerance tolerance;
+    bool update;
+
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+
+public:
+    GoldenImageCheck(std::string directory, GoldenImage::Tolerance tolerance = {}, bool update = false);
+
+    /**
+     * @brief The sink to construct a FrameCapture with. The check must outlive the capture.
+     */
+    FrameCapture::Sink sink();
+
+    /**
+     * @brief Whether the directory holds a golden image for a frame index.
+     */
+    bool hasGoldenImage(uint64_t frame) const;
+
+    /**
+     * @brief Whether every frame checked so far matched its golden image.
+     */
+    bool passed() const;
+
+    /**
+     * @brief Writes a line per frame checked.
+     */
+    void report(std::ostream& stream) const;
+
+private:
+    void check(const FrameCapture::Frame& frame);
+};
+
+#endif // _MEADOW_GOLDEN_IMAGE_HPP_
@@ -0,0 +1,97 @@
+#include "PerformanceBaseline.hpp"
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+PerformanceBaseline::PerformanceBaseline() :
+    start_allocations(0),
+    allocations(0)
+{}
+
+void PerformanceBaseline::beginFrame(uint64_t allocation_count) {
+    start_allocations = allocation_count;
+    frame_start = std::chrono::steady_clock::now();
+}
+
+void PerformanceBaseline::endFrame(uint64_t allocation_count) {
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - frame_start;
+    frame_times_ms.push_back(elapsed.count());
+    allocations += allocation_count - start_allocations;
+}
+
+PerformanceBaseline::Metrics PerformanceBaseline::measure() const {
+    Metrics metrics {
+        .median_ms = 0.0,
+        .p95_ms = 0.0,
+        .allocations = allocations
+    };
+    if (frame_times_ms.empty()) {
+        return metrics;
+    }
+
+    std::vector<double> sorted = frame_times_ms;
+    std::sort(sorted.begin(), sorted.end());
+    metrics.median_ms = sorted[sorted.size() / 2];
+    metrics.p95_ms = sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)];
+    return metrics;
+}
+
+std::optional<PerformanceBaseline::Metrics> PerformanceBaseline::load(const char* path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return std::nullopt;
+    }
+
+    Metrics metrics {};
+    std::string key;
+    while (file >> key) {
+        if (key == "median_ms") {
+            file >> metrics.median_ms;
+        }
+        else if (key == "p95_ms") {
+            file >> metrics.p95_ms;
+        }
+        else if (key == "allocations") {
+            file >> metrics.allocations;
+        }
+        else {
+            throw std::runtime_error(std::string("Unknown key ") + key + " in performance baseline " + path);
+        }
+    }
+    return metrics;
+}
+
+void PerformanceBaseline::save(const char* path, const Metrics& metrics) {
+    std::ofstream file(path);
+    file << "median_ms " << metrics.median_ms << "\n"
+        << "p95_ms " << metrics.p95_ms << "\n"
+        << "allocations " << metrics.allocations << "\n";
+    if (!file) {
+        throw std::runtime_error(std::string("Failed to write performance baseline ") + path);
+    }
+}
+
+bool PerformanceBaseline::check(const Metrics& baseline, std::ostream& report, const Tolerance& tolerance) const {
+    const Metrics measured = measure();
+    bool passed = true;
+
+    auto checkTime = [&](const char* name, double value, double base) {
+        const double allowed = base * tolerance.time_factor + tolerance.time_slack_ms;
+        const bool ok = value <= allowed;
+        report << "[PERF] " << name << ": " << value << " ms against " << base << " ms (allowed "
+            << allowed << " ms), " << (ok ? "passed" : "FAILED") << std::endl;
+        passed = passed && ok;
+    };
+    checkTime("Median frame time", measured.median_ms, baseline.median_ms);
+    checkTime("95th percentile frame time", measured.p95_ms, baseline.p95_ms);
+
+    const bool allocations_ok = measured.allocations <= baseline.allocations;
+    report << "[PERF] Allocations: " << measured.allocations << " against " << baseline.allocations
+        << ", " << (allocations_ok ? "passed" : "FAILED") << std::endl;
+    return passed && allocations_ok;
+}
+
+bool PerformanceBaseline::check(const Metrics& baseline, std::ostream& report) const {
+    return check(baseline, report, Tolerance{});
+}
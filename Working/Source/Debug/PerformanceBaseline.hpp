@@ -0,0 +1,75 @@
+#ifndef _MEADOW_PERFORMANCE_BASELINE_HPP_
+#define _MEADOW_PERFORMANCE_BASELINE_HPP_
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+/**
+ * @brief Measures CPU frame time and device memory allocations over a run, and checks
+ * them against a baseline stored from an earlier run.
+ *
+ * Frame times are summarised by their median and 95th percentile, which are stable
+ * enough across runs on one machine to catch real slowdowns without flagging noise.
+ * Allocations made while frames are measured are counted exactly: a steady-state frame
+ * should make none, so any increase over the baseline is a regression.
+ */
+class PerformanceBaseline {
+public:
+    struct Metrics {
+        double median_ms;
+        double p95_ms;
+        uint64_t allocations; /**< Device memory allocations made during the measured frames. */
+    };
+
+    struct Tolerance {
+        double time_factor = 1.2; /**< How much slower than the baseline frames may get. */
+        double time_slack_ms = 0.25; /**< Added to the allowance, so tiny frame times don't fail on jitter. */
+    };
+
+private:
+    std::vector<double> frame_times_ms;
+    std::chrono::steady_clock::time_point frame_start;
+    uint64_t start_allocations;
+    uint64_t allocations;
+
+public:
+    PerformanceBaseline();
+
+    /**
+     * @param allocation_count Allocations made so far, e.g. MemoryBudget::getTotalAllocations().
+     */
+    void beginFrame(uint64_t allocation_count);
+
+    void endFrame(uint64_t allocation_count);
+
+    /**
+     * @brief Summarises the frames measured so far.
+     */
+    Metrics measure() const;
+
+    /**
+     * @brief Reads a baseline written by save(), or std::nullopt if there is none.
+     */
+    static std::optional<Metrics> load(const char* path);
+
+    /**
+     * @brief Writes metrics as a baseline. Throws std::runtime_error on failure.
+     */
+    static void save(const char* path, const Metrics& metrics);
+
+    /**
+     * @brief Whether the measured frames are within tolerance of the baseline. Writes a line
+     * per metric to report.
+     */
+    bool check(const Metrics& baseline, std::ostream& report, const Tolerance& tolerance) const;
+
+    /**
+     * @brief check() with the default tolerance.
+     */
+    bool check(const Metrics& baseline, std::ostream& report) const;
+};
+
+#endif // _MEADOW_PERFORMANCE_BASELINE_HPP_
@@ -3,7 +3,7 @@
 #include <stdexcept>
 #include <iostream>
 CommandPool::CommandPool(const GraphicsContext& context, Swapchain& swapchain) 
-    : context(context), swapchain(swapchain)
+    : command_pool(VK_NULL_HANDLE, {context.getLogicalDevice()}), context(context), swapchain(swapchain), bindless(nullptr)
 {
 
     QueueUtils::QueueFamilyIndices queue_family_indices = 
@@ -15,23 +15,14 @@ CommandPool::CommandPool(const GraphicsContext& context, Swapchain& swapchain)
         .queueFamilyIndex = queue_family_indices.graphics_family.value()
     };
 
-    if (vkCreateCommandPool(context.getLogicalDevice(), &pool_info, nullptr, &command_pool)) {
+    VkCommandPool created;
+    if (vkCreateCommandPool(context.getLogicalDevice(), &pool_info, nullptr, &created)) {
         throw std::runtime_error("Failed to create command pool!");
-    }   
-
-}
+    }
+    command_pool.reset(created);
 
-CommandPool::~CommandPool() {
-    vkDestroyCommandPool(context.getLogicalDevice(), command_pool, nullptr);
 }
 
-CommandPool::CommandPool(const CommandPool& other) :
-	command_pool(other.command_pool),
-    context(other.context),
-	swapchain(other.swapchain),
-    command_buffers(other.command_buffers)
-{}
-
 void CommandPool::createCommandBuffer(VkCommandBufferLevel level) {
     VkCommandBuffer command_buffer;
 
@@ -47,43 +38,59 @@ void CommandPool::createCommandBuffer(VkCommandBufferLevel level) {
     }
 
     command_buffers.push_back(command_buffer);
+    dynamic_states.emplace_back(context);
+    push_constants.emplace_back();
 }
 
-void CommandPool::beginCommandBuffer(uint32_t command_buffer, uint32_t image_index, Pipeline& pipeline) {
+void CommandPool::recordRenderGraph(uint32_t command_buffer, RenderGraph& render_graph) {
     VkCommandBufferBeginInfo begin_info = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
     };
 
     if (vkBeginCommandBuffer(command_buffers[command_buffer], &begin_info) != VK_SUCCESS) {
         throw std::runtime_error("Failed to begin recording command buffer!");
     }
+    dynamic_states[command_buffer].reset();
+    push_constants[command_buffer].reset();
 
-    VkRenderPassBeginInfo render_pass_info = {
-        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-        .renderPass = swapchain.getRenderPass(),
-        .framebuffer = swapchain.getFramebuffers()[image_index],
-        .renderArea = {
-            .offset = {0, 0},
-            .extent = swapchain.getExtent()
-        },
-        .clearValueCount = 1,
-        .pClearValues = &swapchain.getClearValue()
-    };
+    render_graph.execute(command_buffers[command_buffer]);
 
-    vkCmdBeginRenderPass(command_buffers[command_buffer], &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
+    if (vkEndCommandBuffer(command_buffers[command_buffer]) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record command buffer!");
+    }
+}
 
+void CommandPool::bindPipeline(uint32_t command_buffer, Pipeline& pipeline) {
     vkCmdBindPipeline(command_buffers[command_buffer], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 
-    vkCmdSetViewport(command_buffers[command_buffer], 0, 1, &pipeline.getViewport());
+    dynamic_states[command_buffer].apply(command_buffers[command_buffer], pipeline.getDesc());
+
+    if (bindless) {
+        bindless->bind(command_buffers[command_buffer], VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.getLayout());
+    }
 
-    vkCmdSetScissor(command_buffers[command_buffer], 0, 1, &pipeline.getScissor());
+    // Pipelines outlive a swapchain recreation, so the viewport follows the current extent
+    const VkExtent2D& extent = swapchain.getExtent();
+    const VkViewport viewport = {
+        .x = 0.0f,
+        .y = 0.0f,
+        .width = (float)extent.width,
+        .height = (float)extent.height,
+        .minDepth = 0.0f,
+        .maxDepth = 1.0f
+    };
+    const VkRect2D scissor = {
+        .offset = {0, 0},
+        .extent = extent
+    };
+    vkCmdSetViewport(command_buffers[command_buffer], 0, 1, &viewport);
 
-    vkCmdDraw(command_buffers[command_buffer], 3, 1, 0, 0);
+    vkCmdSetScissor(command_buffers[command_buffer], 0, 1, &scissor);
+}
 
-    vkCmdEndRenderPass(command_buffers[command_buffer]);
+void CommandPool::recordDraw(uint32_t command_buffer, Pipeline& pipeline) {
+    bindPipeline(command_buffer, pipeline);
 
-    if (vkEndCommandBuffer(command_buffers[command_buffer]) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to record command buffer!");
-    }
-}
\ No newline at end of file
+    vkCmdDraw(command_buffers[command_buffer], 3, 1, 0, 0);
+}
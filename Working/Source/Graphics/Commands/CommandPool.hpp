@@ -4,28 +4,69 @@
 #include <vector>
 #include <vulkan/vulkan.h>
 #include "GraphicsContext.hpp"
+#include "DeviceHandle.hpp"
 #include "Swapchain.hpp"
 #include "Pipeline.hpp"
+#include "ComputePipeline.hpp"
+#include "BindlessDescriptors.hpp"
+#include "RenderGraph.hpp"
+#include "DynamicStateRecorder.hpp"
+#include "PushConstantRecorder.hpp"
 
 class CommandPool {
-    VkCommandPool command_pool;
+    CommandPoolHandle command_pool;
     const GraphicsContext& context;
     Swapchain& swapchain;
     std::vector<VkCommandBuffer> command_buffers;
+    std::vector<DynamicStateRecorder> dynamic_states;
+    std::vector<PushConstantRecorder> push_constants;
+    const BindlessDescriptors* bindless;
 
 public:
     CommandPool(const GraphicsContext& context, Swapchain& swapchain);
 
-    ~CommandPool();
-
-    CommandPool(const CommandPool&);
+    /**
+     * @brief Takes over the pool and its command buffers, which are freed along with the pool.
+     */
+    CommandPool(CommandPool&&) = default;
 
     void createCommandBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
-    void beginCommandBuffer(uint32_t command_buffer, uint32_t image_index, Pipeline& pipeline);
+    /**
+     * @brief Records a whole frame from a compiled render graph.
+     */
+    void recordRenderGraph(uint32_t command_buffer, RenderGraph& render_graph);
+
+    /**
+     * @brief Binds a graphics pipeline with its dynamic state, the bindless set and a
+     * viewport covering the swapchain, from inside a render graph pass.
+     */
+    void bindPipeline(uint32_t command_buffer, Pipeline& pipeline);
+
+    /**
+     * @brief Binds a graphics pipeline as bindPipeline() does and records its draw.
+     */
+    void recordDraw(uint32_t command_buffer, Pipeline& pipeline);
 
     inline VkCommandBuffer& getCommandBuffer(uint32_t index) { return command_buffers[index]; }
 
+    /**
+     * @brief The extended dynamic state tracker of a command buffer, for render graph passes
+     * that bind pipelines themselves. Reset whenever the command buffer is begun.
+     */
+    inline DynamicStateRecorder& getDynamicStateRecorder(uint32_t index) { return dynamic_states[index]; }
+
+    /**
+     * @brief The push constant tracker of a command buffer, for per-draw values. Reset
+     * whenever the command buffer is begun.
+     */
+    inline PushConstantRecorder& getPushConstantRecorder(uint32_t index) { return push_constants[index]; }
+
+    /**
+     * @brief Sets the global bindless set, bound once per bind point in every recorded command buffer.
+     */
+    inline void setBindlessDescriptors(const BindlessDescriptors* bindless) { this->bindless = bindless; }
+
     
 
 };
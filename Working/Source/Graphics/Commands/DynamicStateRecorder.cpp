@@ -0,0 +1,85 @@
+#include "DynamicStateRecorder.hpp"
+
+DynamicStateRecorder::DynamicStateRecorder(const GraphicsContext& context) :
+    dynamic_state(context.getExtendedDynamicState()),
+    current{},
+    valid(false),
+    blend_valid(false),
+    recorded(0),
+    skipped(0)
+{}
+
+void DynamicStateRecorder::reset() {
+    valid = false;
+    blend_valid = false;
+}
+
+void DynamicStateRecorder::apply(VkCommandBuffer command_buffer, const PipelineDesc& desc) {
+    using DepthMode = PipelineDesc::DepthMode;
+
+    auto update = [&](auto& tracked, auto value, auto&& record) {
+        if (valid && tracked == value) {
+            skipped++;
+            return;
+        }
+        tracked = value;
+        record();
+        recorded++;
+    };
+
+    // Descriptions don't expose these, so they only need setting once per command buffer
+    if (!valid && dynamic_state.state2) {
+        dynamic_state.vkCmdSetPrimitiveRestartEnableEXT(command_buffer, VK_FALSE);
+        dynamic_state.vkCmdSetDepthBiasEnableEXT(command_buffer, VK_FALSE);
+        dynamic_state.vkCmdSetRasterizerDiscardEnableEXT(command_buffer, VK_FALSE);
+        recorded += 3;
+    }
+
+    if (dynamic_state.state1) {
+        const VkBool32 depth_test = desc.depth_mode != DepthMode::Disabled;
+        const VkBool32 depth_write = desc.depth_mode == DepthMode::TestWrite || desc.depth_mode == DepthMode::Prepass;
+        const VkCompareOp depth_compare_op = desc.depth_mode == DepthMode::Equal ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS;
+
+        update(current.cull_mode, desc.cull_mode, [&]() {
+            dynamic_state.vkCmdSetCullModeEXT(command_buffer, desc.cull_mode);
+        });
+        update(current.front_face, desc.front_face, [&]() {
+            dynamic_state.vkCmdSetFrontFaceEXT(command_buffer, desc.front_face);
+        });
+        update(current.topology, desc.topology, [&]() {
+            dynamic_state.vkCmdSetPrimitiveTopologyEXT(command_buffer, desc.topology);
+        });
+        update(current.depth_test, depth_test, [&]() {
+            dynamic_state.vkCmdSetDepthTestEnableEXT(command_buffer, depth_test);
+        });
+        update(current.depth_write, depth_write, [&]() {
+            dynamic_state.vkCmdSetDepthWriteEnableEXT(command_buffer, depth_write);
+        });
+        update(current.depth_compare_op, depth_compare_op, [&]() {
+            dynamic_state.vkCmdSetDepthCompareOpEXT(command_buffer, depth_compare_op);
+        });
+    }
+
+    if (dynamic_state.state3_polygon_mode) {
+        update(current.polygon_mode, desc.polygon_mode, [&]() {
+            dynamic_state.vkCmdSetPolygonModeEXT(command_buffer, desc.polygon_mode);
+        });
+    }
+
+    // A prepass has no color attachment to set blending for; tracked separately so the
+    // first color pipeline after it still sets its own
+    if (dynamic_state.state3_blend_enable && desc.depth_mode != DepthMode::Prepass) {
+        const VkBool32 blend = desc.blend;
+        if (blend_valid && current.blend == blend) {
+            skipped++;
+        }
+        else {
+            dynamic_state.vkCmdSetColorBlendEnableEXT(command_buffer, 0, 1, &blend);
+            current.blend = blend;
+            blend_valid = true;
+            recorded++;
+        }
+    }
+
+    valid = true;
+}
@@ -0,0 +1,66 @@
+#ifndef _MEADOW_DYNAMIC_STATE_RECORDER_HPP_
+#define _MEADOW_DYNAMIC_STATE_RECORDER_HPP_
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include "GraphicsContext.hpp"
+#include "PipelineDesc.hpp"
+
+/**
+ * @brief Sets the extended dynamic state a pipeline's description asks for, skipping
+ * every state the command buffer already has.
+ *
+ * Dynamic state persists across pipeline binds within a command buffer, so draws
+ * sharing a compiled pipeline but differing in, say, cull mode only record the
+ * one state that changed. Does nothing on devices without extended dynamic state,
+ * where those states are compiled into the pipelines instead.
+ *
+ * One recorder tracks one command buffer; reset() it whenever recording restarts.
+ */
+class DynamicStateRecorder {
+    struct State {
+        VkCullModeFlags cull_mode;
+        VkFrontFace front_face;
+        VkPrimitiveTopology topology;
+        VkBool32 depth_test;
+        VkBool32 depth_write;
+        VkCompareOp depth_compare_op;
+        VkPolygonMode polygon_mode;
+        VkBool32 blend;
+    };
+
+    const ExtendedDynamicState& dynamic_state;
+
+    State current;
+    bool valid;
+    bool blend_valid;
+
+    uint32_t recorded;
+    uint32_t skipped;
+
+public:
+    DynamicStateRecorder(const GraphicsContext& context);
+
+    /**
+     * @brief Forgets the tracked state, e.g. at the start of a new command buffer.
+     */
+    void reset();
+
+    /**
+     * @brief Records whichever dynamic states of desc differ from the command buffer's.
+     * Call after binding the pipeline built from desc.
+     */
+    void apply(VkCommandBuffer command_buffer, const PipelineDesc& desc);
+
+    /**
+     * @brief How many state commands were recorded since construction.
+     */
+    inline uint32_t getRecorded() const { return recorded; }
+
+    /**
+     * @brief How many state commands were skipped as redundant since construction.
+     */
+    inline uint32_t getSkipped() const { return skipped; }
+};
+
+#endif // _MEADOW_DYNAMIC_STATE_RECORDER_HPP_
@@ -0,0 +1,50 @@
+#include "PushConstantRecorder.hpp"
+#include "PushConstants.hpp"
+#include <cstring>
+
+PushConstantRecorder::PushConstantRecorder() :
+    valid(false),
+    words{},
+    word_stages{},
+    recorded(0),
+    skipped(0)
+{}
+
+void PushConstantRecorder::reset() {
+    valid = false;
+    word_stages.fill(0);
+}
+
+void PushConstantRecorder::push(VkCommandBuffer command_buffer, const PipelineBase& pipeline, VkShaderStageFlags stages,
+    uint32_t offset, uint32_t size, const void* data) {
+    if (!valid || !PushConstants::compatible(ranges, pipeline.getPushConstantRanges())) {
+        ranges = pipeline.getPushConstantRanges();
+        word_stages.fill(0);
+        valid = true;
+    }
+
+    const uint32_t first = offset / 4;
+    const uint32_t count = size / 4;
+    const bool shadowed = first + count <= SHADOW_WORDS;
+
+    if (shadowed) {
+        bool redundant = true;
+        for (uint32_t i = 0; i < count && redundant; i++) {
+            redundant = word_stages[first + i] == stages;
+        }
+        if (redundant && std::memcmp(&words[first], data, size) == 0) {
+            skipped++;
+            return;
+        }
+    }
+
+    vkCmdPushConstants(command_buffer, pipeline.getLayout(), stages, offset, size, data);
+    recorded++;
+
+    if (shadowed) {
+        std::memcpy(&words[first], data, size);
+        for (uint32_t i = 0; i < count; i++) {
+            word_stages[first + i] = stages;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef _MEADOW_PUSH_CONSTANT_RECORDER_HPP_
+#define _MEADOW_PUSH_CONSTANT_RECORDER_HPP_
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <type_traits>
+#include "PipelineBase.hpp"
+
+/**
+ * @brief Records push constants for a command buffer, skipping values it already holds.
+ *
+ * Pushed values survive pipeline binds while the bound layouts declare identical
+ * push constant ranges (see PushConstants), so a per-draw value that stays the same
+ * from one draw to the next is only recorded once, even across pipeline switches.
+ * Binding a pipeline whose ranges differ makes the recorder forget everything,
+ * just as the values become undefined on the device.
+ *
+ * One recorder tracks one command buffer; reset() it whenever recording restarts.
+ */
+class PushConstantRecorder {
+    // Covers the largest limit in practice; pushes beyond it are always recorded
+    static constexpr uint32_t SHADOW_WORDS = 64;
+
+    PushConstantRanges ranges;
+    bool valid;
+
+    std::array<uint32_t, SHADOW_WORDS> words;
+    std::array<VkShaderStageFlags, SHADOW_WORDS> word_stages;
+
+    uint32_t recorded;
+    uint32_t skipped;
+
+public:
+    PushConstantRecorder();
+
+    /**
+     * @brief Forgets the tracked values, e.g. at the start of a new command buffer.
+     */
+    void reset();
+
+    /**
+     * @brief Records value at offset unless the command buffer already holds it for stages.
+     * The pipeline only supplies the layout; binding it is up to the caller.
+     */
+    template<typename T>
+    void push(VkCommandBuffer command_buffer, const PipelineBase& pipeline, VkShaderStageFlags stages,
+        const T& value, uint32_t offset = 0) {
+        static_assert(std::is_trivially_copyable_v<T>, "Push constants are copied byte for byte");
+        static_assert(sizeof(T) % 4 == 0, "Push constant ranges are made of 4-byte words");
+        push(command_buffer, pipeline, stages, offset, (uint32_t)sizeof(T), &value);
+    }
+
+    /**
+     * @brief Untyped form of push(); offset and size must be multiples of 4.
+     */
+    void push(VkCommandBuffer command_buffer, const PipelineBase& pipeline, VkShaderStageFlags stages,
+        uint32_t offset, uint32_t size, const void* data);
+
+    /**
+     * @brief How many vkCmdPushConstants were recorded since construction.
+     */
+    inline uint32_t getRecorded() const { return recorded; }
+
+    /**
+     * @brief How many pushes were skipped as redundant since construction.
+     */
+    inline uint32_t getSkipped() const { return skipped; }
+};
+
+#endif // _MEADOW_PUSH_CONSTANT_RECORDER_HPP_
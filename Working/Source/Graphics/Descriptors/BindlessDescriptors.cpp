@@ -0,0 +1,193 @@
+#include "BindlessDescriptors.hpp"
+#include "Config.h"
+#include <algorithm>
+#include <stdexcept>
+
+BindlessDescriptors::BindlessDescriptors(const GraphicsContext& context) :
+    context(context),
+    set_layout(VK_NULL_HANDLE),
+    pool(VK_NULL_HANDLE),
+    set(VK_NULL_HANDLE),
+    next_slot{}
+{
+    if (!context.supportsBindless()) {
+        throw std::runtime_error("Bindless descriptors require descriptor indexing support");
+    }
+
+    // Clamp the requested array sizes to what the device allows for update-after-bind sets
+    VkPhysicalDeviceVulkan12Properties vulkan_12_properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES
+    };
+    VkPhysicalDeviceProperties2 properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2,
+        .pNext = &vulkan_12_properties
+    };
+    vkGetPhysicalDeviceProperties2(context.getPhysicalDevice(), &properties);
+
+    capacities[SAMPLED_IMAGES] = std::min({CONSTANTS::BINDLESS_MAX_SAMPLED_IMAGES,
+        vulkan_12_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+        vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindSampledImages});
+    capacities[SAMPLERS] = std::min({CONSTANTS::BINDLESS_MAX_SAMPLERS,
+        vulkan_12_properties.maxDescriptorSetUpdateAfterBindSamplers,
+        vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindSamplers});
+    capacities[STORAGE_BUFFERS] = std::min({CONSTANTS::BINDLESS_MAX_STORAGE_BUFFERS,
+        vulkan_12_properties.maxDescriptorSetUpdateAfterBindStorageBuffers,
+        vulkan_12_properties.maxPerStageDescriptorUpdateAfterBindStorageBuffers});
+
+    const VkDescriptorType types[BINDING_COUNT] = {
+        VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
+        VK_DESCRIPTOR_TYPE_SAMPLER,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+    };
+
+    VkDescriptorSetLayoutBinding bindings[BINDING_COUNT];
+    VkDescriptorBindingFlags binding_flags[BINDING_COUNT];
+    VkDescriptorPoolSize pool_sizes[BINDING_COUNT];
+    for (uint32_t i = 0; i < BINDING_COUNT; i++) {
+        bindings[i] = {
+            .binding = i,
+            .descriptorType = types[i],
+            .descriptorCount = capacities[i],
+            .stageFlags = VK_SHADER_STAGE_ALL,
+            .pImmutableSamplers = nullptr
+        };
+        // Slots may be empty, and may be written while the set is bound by frames in flight
+        binding_flags[i] = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT
+            | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT
+            | VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT;
+        pool_sizes[i] = {
+            .type = types[i],
+            .descriptorCount = capacities[i]
+        };
+    }
+
+    VkDescriptorSetLayoutBindingFlagsCreateInfo binding_flags_create_info {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = BINDING_COUNT,
+        .pBindingFlags = binding_flags
+    };
+
+    VkDescriptorSetLayoutCreateInfo layout_create_info {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = &binding_flags_create_info,
+        .flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT,
+        .bindingCount = BINDING_COUNT,
+        .pBindings = bindings
+    };
+
+    if (vkCreateDescriptorSetLayout(context.getLogicalDevice(), &layout_create_info, nullptr, &set_layout)) {
+        throw std::runtime_error("Failed to create bindless descriptor set layout");
+    }
+
+    VkDescriptorPoolCreateInfo pool_create_info {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT,
+        .maxSets = 1,
+        .poolSizeCount = BINDING_COUNT,
+        .pPoolSizes = pool_sizes
+    };
+
+    if (vkCreateDescriptorPool(context.getLogicalDevice(), &pool_create_info, nullptr, &pool)) {
+        vkDestroyDescriptorSetLayout(context.getLogicalDevice(), set_layout, nullptr);
+        throw std::runtime_error("Failed to create bindless descriptor pool");
+    }
+
+    VkDescriptorSetAllocateInfo allocate_info {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &set_layout
+    };
+
+    if (vkAllocateDescriptorSets(context.getLogicalDevice(), &allocate_info, &set)) {
+        vkDestroyDescriptorPool(context.getLogicalDevice(), pool, nullptr);
+        vkDestroyDescriptorSetLayout(context.getLogicalDevice(), set_layout, nullptr);
+        throw std::runtime_error("Failed to allocate bindless descriptor set");
+    }
+}
+
+BindlessDescriptors::~BindlessDescriptors() {
+    vkDestroyDescriptorPool(context.getLogicalDevice(), pool, nullptr);
+    vkDestroyDescriptorSetLayout(context.getLogicalDevice(), set_layout, nullptr);
+}
+
+uint32_t BindlessDescriptors::addSampledImage(VkImageView image_view, VkImageLayout layout) {
+    uint32_t index = allocateSlot(SAMPLED_IMAGES);
+    updateSampledImage(index, image_view, layout);
+    return index;
+}
+
+uint32_t BindlessDescriptors::addSampler(VkSampler sampler) {
+    uint32_t index = allocateSlot(SAMPLERS);
+
+    VkDescriptorImageInfo image_info {
+        .sampler = sampler,
+        .imageView = VK_NULL_HANDLE,
+        .imageLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    write(SAMPLERS, index, VK_DESCRIPTOR_TYPE_SAMPLER, &image_info, nullptr);
+
+    return index;
+}
+
+uint32_t BindlessDescriptors::addStorageBuffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    uint32_t index = allocateSlot(STORAGE_BUFFERS);
+
+    VkDescriptorBufferInfo buffer_info {
+        .buffer = buffer,
+        .offset = offset,
+        .range = range
+    };
+    write(STORAGE_BUFFERS, index, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, nullptr, &buffer_info);
+
+    return index;
+}
+
+void BindlessDescriptors::updateSampledImage(uint32_t index, VkImageView image_view, VkImageLayout layout) {
+    VkDescriptorImageInfo image_info {
+        .sampler = VK_NULL_HANDLE,
+        .imageView = image_view,
+        .imageLayout = layout
+    };
+    write(SAMPLED_IMAGES, index, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, &image_info, nullptr);
+}
+
+void BindlessDescriptors::release(Binding binding, uint32_t index) {
+    free_slots[binding].push_back(index);
+}
+
+void BindlessDescriptors::bind(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout) const {
+    vkCmdBindDescriptorSets(command_buffer, bind_point, layout, 0, 1, &set, 0, nullptr);
+}
+
+uint32_t BindlessDescriptors::allocateSlot(Binding binding) {
+    if (!free_slots[binding].empty()) {
+        uint32_t index = free_slots[binding].back();
+        free_slots[binding].pop_back();
+        return index;
+    }
+
+    if (next_slot[binding] >= capacities[binding]) {
+        throw std::runtime_error("Bindless descriptor array is full");
+    }
+
+    return next_slot[binding]++;
+}
+
+void BindlessDescriptors::write(Binding binding, uint32_t index, VkDescriptorType type,
+    const VkDescriptorImageInfo* image_info, const VkDescriptorBufferInfo* buffer_info)
+{
+    VkWriteDescriptorSet descriptor_write {
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = set,
+        .dstBinding = binding,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = type,
+        .pImageInfo = image_info,
+        .pBufferInfo = buffer_info,
+        .pTexelBufferView = nullptr
+    };
+
+    vkUpdateDescriptorSets(context.getLogicalDevice(), 1, &descriptor_write, 0, nullptr);
+}
@@ -0,0 +1,105 @@
+#ifndef _MEADOW_BINDLESS_DESCRIPTORS_HPP_
+#define _MEADOW_BINDLESS_DESCRIPTORS_HPP_
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <vector>
+#include "GraphicsContext.hpp"
+
+/**
+ * @brief The global bindless descriptor set.
+ *
+ * A single descriptor set holding large update-after-bind arrays of sampled images,
+ * samplers and storage buffers. Resources are registered once and referred to by
+ * the index returned on registration, which shaders read from push constants or
+ * instance data. The set is bound once per command buffer, so draws never bind or
+ * allocate descriptors of their own, and draws with different materials can be batched.
+ *
+ * Pipelines using the model pass getSetLayout() as set 0. The matching GLSL is:
+ * @code
+ * #extension GL_EXT_nonuniform_qualifier : require
+ * layout(set = 0, binding = 0) uniform texture2D textures[];
+ * layout(set = 0, binding = 1) uniform sampler samplers[];
+ * layout(set = 0, binding = 2) buffer Buffers { uint data[]; } buffers[];
+ * @endcode
+ *
+ * Requires GraphicsContext::supportsBindless().
+ */
+class BindlessDescriptors {
+public:
+    enum Binding : uint32_t {
+        SAMPLED_IMAGES = 0,
+        SAMPLERS = 1,
+        STORAGE_BUFFERS = 2,
+        BINDING_COUNT = 3
+    };
+
+private:
+    const GraphicsContext& context;
+
+    VkDescriptorSetLayout set_layout;
+    VkDescriptorPool pool;
+    VkDescriptorSet set;
+
+    std::array<uint32_t, BINDING_COUNT> capacities;
+    std::array<uint32_t, BINDING_COUNT> next_slot;
+    std::array<std::vector<uint32_t>, BINDING_COUNT> free_slots;
+
+public:
+    BindlessDescriptors(const GraphicsContext& context);
+
+    ~BindlessDescriptors();
+
+    BindlessDescriptors(const BindlessDescriptors&) = delete;
+    BindlessDescriptors& operator=(const BindlessDescriptors&) = delete;
+
+    /**
+     * @brief Registers a sampled image and returns its index into textures[].
+     */
+    uint32_t addSampledImage(VkImageView image_view,
+        VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    /**
+     * @brief Registers a sampler and returns its index into samplers[].
+     */
+    uint32_t addSampler(VkSampler sampler);
+
+    /**
+     * @brief Registers a storage buffer range and returns its index into buffers[].
+     */
+    uint32_t addStorageBuffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+    /**
+     * @brief Points an existing sampled image slot at a different view, e.g. when
+     * more mip levels of a streamed texture become resident.
+     */
+    void updateSampledImage(uint32_t index, VkImageView image_view,
+        VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    /**
+     * @brief Returns a slot to the free list. The caller must make sure no frame
+     * still in flight indexes the slot.
+     */
+    void release(Binding binding, uint32_t index);
+
+    /**
+     * @brief Binds the global set as set 0 for the given bind point.
+     *
+     * @param layout Any pipeline layout created with getSetLayout() as set 0.
+     */
+    void bind(VkCommandBuffer command_buffer, VkPipelineBindPoint bind_point, VkPipelineLayout layout) const;
+
+    inline const VkDescriptorSetLayout& getSetLayout() const { return set_layout; }
+
+    inline const VkDescriptorSet& getSet() const { return set; }
+
+    inline uint32_t getCapacity(Binding binding) const { return capacities[binding]; }
+
+private:
+    uint32_t allocateSlot(Binding binding);
+
+    void write(Binding binding, uint32_t index, VkDescriptorType type,
+        const VkDescriptorImageInfo* image_info, const VkDescriptorBufferInfo* buffer_info);
+};
+
+#endif // _MEADOW_BINDLESS_DESCRIPTORS_HPP_
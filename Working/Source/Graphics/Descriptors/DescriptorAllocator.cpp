@@ -0,0 +1,224 @@
+#include "DescriptorAllocator.hpp"
+#include "Config.h"
+#include "Hash.hpp"
+#include <algorithm>
+#include <memory_resource>
+#include <stdexcept>
+
+namespace {
+    // Descriptors reserved per set in each pool, by type
+    const VkDescriptorPoolSize POOL_RATIOS[] = {
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2 },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 },
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4 },
+        { VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 1 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1 },
+        { VK_DESCRIPTOR_TYPE_SAMPLER, 1 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 1 },
+        { VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1 },
+        { VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER, 1 },
+        { VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT, 1 }
+    };
+
+    const uint32_t INITIAL_SETS_PER_POOL = 64;
+    const uint32_t MAX_SETS_PER_POOL = 4096;
+
+    bool isImageDescriptor(VkDescriptorType type) {
+        return type == VK_DESCRIPTOR_TYPE_SAMPLER
+            || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+            || type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE
+            || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE
+            || type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    }
+
+    bool isTexelBufferDescriptor(VkDescriptorType type) {
+        return type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER
+            || type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+    }
+}
+
+bool DescriptorBinding::operator==(const DescriptorBinding& other) const {
+    if (binding != other.binding || type != other.type) {
+        return false;
+    }
+    if (isImageDescriptor(type)) {
+        return image.sampler == other.image.sampler
+            && image.imageView == other.image.imageView
+            && image.imageLayout == other.image.imageLayout;
+    }
+    if (isTexelBufferDescriptor(type)) {
+        return texel_buffer == other.texel_buffer;
+    }
+    return buffer.buffer == other.buffer.buffer
+        && buffer.offset == other.buffer.offset
+        && buffer.range == other.buffer.range;
+}
+
+DescriptorAllocator::DescriptorAllocator(const GraphicsContext& context) :
+    context(context),
+    frames(CONSTANTS::FRAMES_IN_FLIGHT),
+    current_frame(0),
+    sets_per_pool(INITIAL_SETS_PER_POOL)
+{}
+
+DescriptorAllocator::~DescriptorAllocator() {
+    auto destroy = [this](VkDescriptorPool pool) {
+        vkDestroyDescriptorPool(context.getLogicalDevice(), pool, nullptr);
+    };
+
+    for (auto& frame : frames) {
+        std::for_each(frame.used.begin(), frame.used.end(), destroy);
+    }
+    std::for_each(immutable_pools.used.begin(), immutable_pools.used.end(), destroy);
+    std::for_each(free_pools.begin(), free_pools.end(), destroy);
+}
+
+void DescriptorAllocator::beginFrame(uint32_t frame_index) {
+    current_frame = frame_index;
+
+    FramePools& frame = frames[frame_index];
+    for (auto& pool : frame.used) {
+        vkResetDescriptorPool(context.getLogicalDevice(), pool, 0);
+        free_pools.push_back(pool);
+    }
+    frame.used.clear();
+    frame.current = VK_NULL_HANDLE;
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+    return allocateFrom(frames[current_frame], layout);
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings) {
+    VkDescriptorSet set = allocate(layout);
+    write(set, bindings);
+    return set;
+}
+
+VkDescriptorSet DescriptorAllocator::getImmutable(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings) {
+    std::vector<CachedSet>& bucket = immutable_sets[hash(layout, bindings)];
+    for (const auto& cached : bucket) {
+        if (cached.layout == layout && cached.bindings == bindings) {
+            return cached.set;
+        }
+    }
+
+    VkDescriptorSet set = allocateFrom(immutable_pools, layout);
+    write(set, bindings);
+    bucket.push_back({layout, bindings, set});
+    return set;
+}
+
+VkDescriptorSet DescriptorAllocator::allocateFrom(FramePools& pools, VkDescriptorSetLayout layout) {
+    if (pools.current == VK_NULL_HANDLE) {
+        pools.current = acquirePool();
+        pools.used.push_back(pools.current);
+    }
+
+    VkDescriptorSetAllocateInfo allocate_info {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = pools.current,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &layout
+    };
+
+    VkDescriptorSet set;
+    VkResult result = vkAllocateDescriptorSets(context.getLogicalDevice(), &allocate_info, &set);
+
+    // The current pool is exhausted, move on to a fresh one and retry once
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+        pools.current = acquirePool();
+        pools.used.push_back(pools.current);
+
+        allocate_info.descriptorPool = pools.current;
+        result = vkAllocateDescriptorSets(context.getLogicalDevice(), &allocate_info, &set);
+    }
+
+    if (result) {
+        throw std::runtime_error("Failed to allocate descriptor set");
+    }
+
+    return set;
+}
+
+VkDescriptorPool DescriptorAllocator::acquirePool() {
+    if (!free_pools.empty()) {
+        VkDescriptorPool pool = free_pools.back();
+        free_pools.pop_back();
+        return pool;
+    }
+
+    VkDescriptorPool pool = createPool(sets_per_pool);
+    sets_per_pool = std::min(sets_per_pool * 2, MAX_SETS_PER_POOL);
+    return pool;
+}
+
+VkDescriptorPool DescriptorAllocator::createPool(uint32_t max_sets) {
+    std::vector<VkDescriptorPoolSize> pool_sizes;
+    for (const auto& ratio : POOL_RATIOS) {
+        pool_sizes.push_back({
+            .type = ratio.type,
+            .descriptorCount = ratio.descriptorCount * max_sets
+        });
+    }
+
+    VkDescriptorPoolCreateInfo pool_create_info {
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = 0,
+        .maxSets = max_sets,
+        .poolSizeCount = (uint32_t)pool_sizes.size(),
+        .pPoolSizes = pool_sizes.data()
+    };
+
+    VkDescriptorPool pool;
+    if (vkCreateDescriptorPool(context.getLogicalDevice(), &pool_create_info, nullptr, &pool)) {
+        throw std::runtime_error("Failed to create descriptor pool");
+    }
+    return pool;
+}
+
+void DescriptorAllocator::write(VkDescriptorSet set, const std::vector<DescriptorBinding>& bindings) {
+    std::pmr::vector<VkWriteDescriptorSet> writes(&context.getFrameAllocator().get());
+    writes.reserve(bindings.size());
+
+    for (const auto& binding : bindings) {
+        bool image = isImageDescriptor(binding.type);
+        bool texel_buffer = isTexelBufferDescriptor(binding.type);
+        writes.push_back({
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet = set,
+            .dstBinding = binding.binding,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = binding.type,
+            .pImageInfo = image ? &binding.image : nullptr,
+            .pBufferInfo = image || texel_buffer ? nullptr : &binding.buffer,
+            .pTexelBufferView = texel_buffer ? &binding.texel_buffer : nullptr
+        });
+    }
+
+    vkUpdateDescriptorSets(context.getLogicalDevice(), (uint32_t)writes.size(), writes.data(), 0, nullptr);
+}
+
+uint64_t DescriptorAllocator::hash(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings) {
+    uint64_t result = Hash::value(layout);
+    for (const auto& binding : bindings) {
+        result = Hash::value(binding.binding, result);
+        result = Hash::value(binding.type, result);
+        if (isImageDescriptor(binding.type)) {
+            result = Hash::value(binding.image.sampler, result);
+            result = Hash::value(binding.image.imageView, result);
+            result = Hash::value(binding.image.imageLayout, result);
+        }
+        else if (isTexelBufferDescriptor(binding.type)) {
+            result = Hash::value(binding.texel_buffer, result);
+        }
+        else {
+            result = Hash::value(binding.buffer.buffer, result);
+            result = Hash::value(binding.buffer.offset, result);
+            result = Hash::value(binding.buffer.range, result);
+        }
+    }
+    return result;
+}
@@ -0,0 +1,102 @@
+#ifndef _MEADOW_DESCRIPTOR_ALLOCATOR_HPP_
+#define _MEADOW_DESCRIPTOR_ALLOCATOR_HPP_
+
+#include <vulkan/vulkan.h>
+#include <vector>
+#include <unordered_map>
+#include "GraphicsContext.hpp"
+
+/**
+ * @brief Describes the resource bound to one binding of a classic descriptor set.
+ *
+ * Only one of buffer, image or texel_buffer is read, depending on type.
+ */
+struct DescriptorBinding {
+    uint32_t binding;
+    VkDescriptorType type;
+    VkDescriptorBufferInfo buffer;
+    VkDescriptorImageInfo image;
+    VkBufferView texel_buffer; /**< For uniform and storage texel buffers. */
+
+    bool operator==(const DescriptorBinding& other) const;
+};
+
+/**
+ * @brief Allocator for pipelines that still use classic descriptor sets.
+ *
+ * Transient sets come from pools owned by the current frame in flight. Nothing is
+ * ever freed individually: once that frame's fence has signalled, beginFrame()
+ * resets each of its pools with a single vkResetDescriptorPool and returns them
+ * to a shared free list. When a pool runs out, a new one is taken from the free
+ * list or created, with each newly created pool twice the size of the last.
+ *
+ * Sets whose contents never change can instead be fetched with getImmutable(),
+ * which caches them by a hash of the layout and bindings, so repeated requests
+ * for the same contents return the same set without allocating or writing.
+ */
+class DescriptorAllocator {
+    struct FramePools {
+        std::vector<VkDescriptorPool> used;
+        VkDescriptorPool current = VK_NULL_HANDLE;
+    };
+
+    struct CachedSet {
+        VkDescriptorSetLayout layout;
+        std::vector<DescriptorBinding> bindings;
+        VkDescriptorSet set;
+    };
+
+    const GraphicsContext& context;
+
+    std::vector<FramePools> frames;
+    std::vector<VkDescriptorPool> free_pools;
+    uint32_t current_frame;
+    uint32_t sets_per_pool;
+
+    FramePools immutable_pools;
+    std::unordered_map<uint64_t, std::vector<CachedSet>> immutable_sets;
+
+public:
+    DescriptorAllocator(const GraphicsContext& context);
+
+    ~DescriptorAllocator();
+
+    DescriptorAllocator(const DescriptorAllocator&) = delete;
+    DescriptorAllocator& operator=(const DescriptorAllocator&) = delete;
+
+    /**
+     * @brief Recycles the pools of the given frame in flight. Must only be called
+     * once the frame's fence has signalled (see Frames::addFrameResetCallback).
+     */
+    void beginFrame(uint32_t frame_index);
+
+    /**
+     * @brief Allocates a set that is valid until the current frame is next begun.
+     */
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+    /**
+     * @brief Allocates and writes a transient set in one call.
+     */
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings);
+
+    /**
+     * @brief Returns a set with the given contents, creating and caching it on first use.
+     *
+     * Cached sets live as long as the allocator, so the resources they reference must too.
+     */
+    VkDescriptorSet getImmutable(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings);
+
+private:
+    VkDescriptorSet allocateFrom(FramePools& pools, VkDescriptorSetLayout layout);
+
+    VkDescriptorPool acquirePool();
+
+    VkDescriptorPool createPool(uint32_t max_sets);
+
+    void write(VkDescriptorSet set, const std::vector<DescriptorBinding>& bindings);
+
+    static uint64_t hash(VkDescriptorSetLayout layout, const std::vector<DescriptorBinding>& bindings);
+};
+
+#endif // _MEADOW_DESCRIPTOR_ALLOCATOR_HPP_
@@ -0,0 +1,34 @@
+#ifndef _MEADOW_DEVICE_HANDLE_HPP_
+#define _MEADOW_DEVICE_HANDLE_HPP_
+
+#include <vulkan/vulkan.h>
+#include "Handle.hpp"
+
+/**
+ * @brief Destroys a Vulkan object through its vkDestroy* function and the device it belongs to.
+ */
+template<typename T, auto Destroy>
+struct DeviceDeleter {
+    VkDevice device = VK_NULL_HANDLE;
+
+    inline void operator()(T handle) const { Destroy(device, handle, nullptr); }
+};
+
+/**
+ * @brief Move-only owner of a Vulkan object created from a device, e.g.
+ * `CommandPoolHandle(pool, {device})`.
+ */
+template<typename T, auto Destroy>
+using DeviceHandle = Handle<T, DeviceDeleter<T, Destroy>>;
+
+using BufferHandle = DeviceHandle<VkBuffer, vkDestroyBuffer>;
+using ImageHandle = DeviceHandle<VkImage, vkDestroyImage>;
+using CommandPoolHandle = DeviceHandle<VkCommandPool, vkDestroyCommandPool>;
+using ShaderModuleHandle = DeviceHandle<VkShaderModule, vkDestroyShaderModule>;
+using RenderPassHandle = DeviceHandle<VkRenderPass, vkDestroyRenderPass>;
+using PipelineLayoutHandle = DeviceHandle<VkPipelineLayout, vkDestroyPipelineLayout>;
+using PipelineHandle = DeviceHandle<VkPipeline, vkDestroyPipeline>;
+using SemaphoreHandle = DeviceHandle<VkSemaphore, vkDestroySemaphore>;
+using FenceHandle = DeviceHandle<VkFence, vkDestroyFence>;
+
+#endif // _MEADOW_DEVICE_HANDLE_HPP_
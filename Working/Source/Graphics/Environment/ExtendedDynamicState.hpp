@@ -0,0 +1,40 @@
+#ifndef _MEADOW_EXTENDED_DYNAMIC_STATE_HPP_
+#define _MEADOW_EXTENDED_DYNAMIC_STATE_HPP_
+
+#include <vulkan/vulkan.h>
+
+/**
+ * @brief Which parts of VK_EXT_extended_dynamic_state 1, 2 and 3 the device was created
+ * with, and their command entry points.
+ *
+ * Each level is only enabled when CONSTANTS::EXTENDED_DYNAMIC_STATE is set and the
+ * device supports it. The entry points of a disabled level are null.
+ */
+struct ExtendedDynamicState {
+    /** Cull mode, front face, topology within a class, depth test, write and compare op. */
+    bool state1 = false;
+    /** Primitive restart, depth bias and rasterizer discard enables. */
+    bool state2 = false;
+    /** Polygon mode, from extended dynamic state 3. */
+    bool state3_polygon_mode = false;
+    /** Per-attachment blend enable, from extended dynamic state 3. */
+    bool state3_blend_enable = false;
+
+    PFN_vkCmdSetCullModeEXT vkCmdSetCullModeEXT = nullptr;
+    PFN_vkCmdSetFrontFaceEXT vkCmdSetFrontFaceEXT = nullptr;
+    PFN_vkCmdSetPrimitiveTopologyEXT vkCmdSetPrimitiveTopologyEXT = nullptr;
+    PFN_vkCmdSetDepthTestEnableEXT vkCmdSetDepthTestEnableEXT = nullptr;
+    PFN_vkCmdSetDepthWriteEnableEXT vkCmdSetDepthWriteEnableEXT = nullptr;
+    PFN_vkCmdSetDepthCompareOpEXT vkCmdSetDepthCompareOpEXT = nullptr;
+
+    PFN_vkCmdSetPrimitiveRestartEnableEXT vkCmdSetPrimitiveRestartEnableEXT = nullptr;
+    PFN_vkCmdSetDepthBiasEnableEXT vkCmdSetDepthBiasEnableEXT = nullptr;
+    PFN_vkCmdSetRasterizerDiscardEnableEXT vkCmdSetRasterizerDiscardEnableEXT = nullptr;
+
+    PFN_vkCmdSetPolygonModeEXT vkCmdSetPolygonModeEXT = nullptr;
+    PFN_vkCmdSetColorBlendEnableEXT vkCmdSetColorBlendEnableEXT = nullptr;
+
+    inline bool any() const { return state1 || state2 || state3_polygon_mode || state3_blend_enable; }
+};
+
+#endif // _MEADOW_EXTENDED_DYNAMIC_STATE_HPP_
@@ -18,9 +18,14 @@ GraphicsContext::GraphicsContext(const char* name) :
     createSurface();
 	createPhysicalDevice();
 	createLogicalDevice();
+	createPipelineCache();
 }
 
 GraphicsContext::~GraphicsContext() {
+	vkDeviceWaitIdle(logical_device);
+	deletion_queue.flush();
+
+	vkDestroyPipelineCache(logical_device, pipeline_cache, nullptr);
 	vkDestroyDevice(logical_device, nullptr);
 	vkDestroySurfaceKHR(instance, surface, nullptr);
 	
@@ -92,7 +97,8 @@ GraphicsContext::~GraphicsContext() {
 		std::vector<VkDeviceQueueCreateInfo> queue_create_infos;
 		std::set<uint32_t> unique_queue_families = {
 			indices.graphics_family.value(),
-			indices.present_family.value()
+			indices.present_family.value(),
+			indices.transfer_family.value()
 		};
 
 		float queue_priority = 1.0f;
@@ -109,12 +115,76 @@ GraphicsContext::~GraphicsContext() {
 		}
 
 		VkPhysicalDeviceFeatures device_features{};
+
+		// Lets GPU-driven passes issue a whole buffer of indirect draws in one call
+		VkPhysicalDeviceFeatures supported_features;
+		vkGetPhysicalDeviceFeatures(physical_device, &supported_features);
+		multi_draw_indirect_supported = supported_features.multiDrawIndirect;
+		device_features.multiDrawIndirect = supported_features.multiDrawIndirect;
+
+		// Descriptor indexing backs the bindless descriptor model; only request it when the device has it
+		bindless_supported = checkBindlessSupport(physical_device);
+		VkPhysicalDeviceVulkan12Features vulkan_12_features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES
+		};
+		if (bindless_supported) {
+			vulkan_12_features.descriptorIndexing = VK_TRUE;
+			vulkan_12_features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+			vulkan_12_features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+			vulkan_12_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+			vulkan_12_features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+			vulkan_12_features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+			vulkan_12_features.descriptorBindingPartiallyBound = VK_TRUE;
+			vulkan_12_features.runtimeDescriptorArray = VK_TRUE;
+		}
+
+		void* feature_chain = bindless_supported ? &vulkan_12_features : nullptr;
+		std::vector<const char*> extensions = CONSTANTS::DEVICE_EXTENSIONS;
+
+		// Extended dynamic state lets pipelines differing only in those states share one VkPipeline
+		extended_dynamic_state = checkExtendedDynamicStateSupport(physical_device);
+		VkPhysicalDeviceExtendedDynamicStateFeaturesEXT state1_features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT,
+			.pNext = feature_chain,
+			.extendedDynamicState = VK_TRUE
+		};
+		if (extended_dynamic_state.state1) {
+			extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+			feature_chain = &state1_features;
+		}
+		VkPhysicalDeviceExtendedDynamicState2FeaturesEXT state2_features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT,
+			.pNext = feature_chain,
+			.extendedDynamicState2 = VK_TRUE
+		};
+		if (extended_dynamic_state.state2) {
+			extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+			feature_chain = &state2_features;
+		}
+		VkPhysicalDeviceExtendedDynamicState3FeaturesEXT state3_features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT,
+			.pNext = feature_chain,
+			.extendedDynamicState3PolygonMode = extended_dynamic_state.state3_polygon_mode,
+			.extendedDynamicState3ColorBlendEnable = extended_dynamic_state.state3_blend_enable
+		};
+		if (extended_dynamic_state.state3_polygon_mode || extended_dynamic_state.state3_blend_enable) {
+			extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+			feature_chain = &state3_features;
+		}
+
+		// Lets MemoryBudget report the driver's budget rather than guess it
+		const bool memory_budget_supported = checkMemoryBudgetSupport(physical_device);
+		if (memory_budget_supported) {
+			extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+		}
+
 		VkDeviceCreateInfo create_info{
 			.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+			.pNext = feature_chain,
 			.queueCreateInfoCount = static_cast<uint32_t>(queue_create_infos.size()),
 			.pQueueCreateInfos = queue_create_infos.data(),
-			.enabledExtensionCount = static_cast<uint32_t>(CONSTANTS::DEVICE_EXTENSIONS.size()),
-			.ppEnabledExtensionNames = CONSTANTS::DEVICE_EXTENSIONS.data(),
+			.enabledExtensionCount = static_cast<uint32_t>(extensions.size()),
+			.ppEnabledExtensionNames = extensions.data(),
 			.pEnabledFeatures = &device_features,
 		};
 
@@ -134,6 +204,53 @@ GraphicsContext::~GraphicsContext() {
 
 		// Get the present queue from the logical device
 		vkGetDeviceQueue(logical_device, indices.graphics_family.value(), 0, &present_queue);
+
+		// Get the transfer queue, which is the graphics queue when there is no dedicated transfer family
+		vkGetDeviceQueue(logical_device, indices.transfer_family.value(), 0, &transfer_queue);
+
+		queue_families = indices;
+
+		loadExtendedDynamicState();
+
+		memory_budget.init(physical_device, memory_budget_supported);
+		memory_budget.update();
+	}
+
+	void GraphicsContext::createPipelineCache() {
+		// A single cache is shared by every graphics and compute pipeline created on this device
+		VkPipelineCacheCreateInfo cache_create_info {
+			.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+			.initialDataSize = 0,
+			.pInitialData = nullptr
+		};
+
+		if (vkCreatePipelineCache(logical_device, &cache_create_info, nullptr, &pipeline_cache)) {
+			throw std::runtime_error("Failed to create pipeline cache!");
+		}
+	}
+
+	void GraphicsContext::loadExtendedDynamicState() {
+		// The loader doesn't export extension commands, so fetch them from the device
+		ExtendedDynamicState& state = extended_dynamic_state;
+		if (state.state1) {
+			state.vkCmdSetCullModeEXT = (PFN_vkCmdSetCullModeEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetCullModeEXT");
+			state.vkCmdSetFrontFaceEXT = (PFN_vkCmdSetFrontFaceEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetFrontFaceEXT");
+			state.vkCmdSetPrimitiveTopologyEXT = (PFN_vkCmdSetPrimitiveTopologyEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetPrimitiveTopologyEXT");
+			state.vkCmdSetDepthTestEnableEXT = (PFN_vkCmdSetDepthTestEnableEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetDepthTestEnableEXT");
+			state.vkCmdSetDepthWriteEnableEXT = (PFN_vkCmdSetDepthWriteEnableEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetDepthWriteEnableEXT");
+			state.vkCmdSetDepthCompareOpEXT = (PFN_vkCmdSetDepthCompareOpEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetDepthCompareOpEXT");
+		}
+		if (state.state2) {
+			state.vkCmdSetPrimitiveRestartEnableEXT = (PFN_vkCmdSetPrimitiveRestartEnableEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetPrimitiveRestartEnableEXT");
+			state.vkCmdSetDepthBiasEnableEXT = (PFN_vkCmdSetDepthBiasEnableEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetDepthBiasEnableEXT");
+			state.vkCmdSetRasterizerDiscardEnableEXT = (PFN_vkCmdSetRasterizerDiscardEnableEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetRasterizerDiscardEnableEXT");
+		}
+		if (state.state3_polygon_mode) {
+			state.vkCmdSetPolygonModeEXT = (PFN_vkCmdSetPolygonModeEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetPolygonModeEXT");
+		}
+		if (state.state3_blend_enable) {
+			state.vkCmdSetColorBlendEnableEXT = (PFN_vkCmdSetColorBlendEnableEXT)vkGetDeviceProcAddr(logical_device, "vkCmdSetColorBlendEnableEXT");
+		}
 	}
 
 //#endregion
@@ -207,6 +324,106 @@ GraphicsContext::~GraphicsContext() {
 
 	}
 
+	bool GraphicsContext::checkBindlessSupport(const VkPhysicalDevice& device) {
+		// VkPhysicalDeviceVulkan12Features may only be chained on Vulkan 1.2 devices
+		VkPhysicalDeviceProperties device_properties;
+		vkGetPhysicalDeviceProperties(device, &device_properties);
+		if (device_properties.apiVersion < VK_API_VERSION_1_2) {
+			return false;
+		}
+
+		VkPhysicalDeviceVulkan12Features vulkan_12_features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES
+		};
+		VkPhysicalDeviceFeatures2 features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+			.pNext = &vulkan_12_features
+		};
+		vkGetPhysicalDeviceFeatures2(device, &features);
+
+		return vulkan_12_features.descriptorIndexing
+			&& vulkan_12_features.shaderSampledImageArrayNonUniformIndexing
+			&& vulkan_12_features.shaderStorageBufferArrayNonUniformIndexing
+			&& vulkan_12_features.descriptorBindingSampledImageUpdateAfterBind
+			&& vulkan_12_features.descriptorBindingStorageBufferUpdateAfterBind
+			&& vulkan_12_features.descriptorBindingUpdateUnusedWhilePending
+			&& vulkan_12_features.descriptorBindingPartiallyBound
+			&& vulkan_12_features.runtimeDescriptorArray;
+	}
+
+	ExtendedDynamicState GraphicsContext::checkExtendedDynamicStateSupport(const VkPhysicalDevice& device) {
+		ExtendedDynamicState support;
+		if (!CONSTANTS::EXTENDED_DYNAMIC_STATE) {
+			return support;
+		}
+
+		uint32_t extension_count;
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+		std::vector<VkExtensionProperties> available_extensions(extension_count);
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, available_extensions.data());
+
+		auto has_extension = [&](const char* name) {
+			for (const auto& extension : available_extensions) {
+				if (strcmp(name, extension.extensionName) == 0) {
+					return true;
+				}
+			}
+			return false;
+		};
+
+		// Only chain the feature structs of extensions the device actually has
+		VkPhysicalDeviceExtendedDynamicStateFeaturesEXT state1_features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT
+		};
+		VkPhysicalDeviceExtendedDynamicState2FeaturesEXT state2_features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT
+		};
+		VkPhysicalDeviceExtendedDynamicState3FeaturesEXT state3_features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT
+		};
+		VkPhysicalDeviceFeatures2 features{
+			.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+			.pNext = nullptr
+		};
+
+		const bool has_state1 = has_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+		const bool has_state2 = has_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+		const bool has_state3 = has_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+		if (has_state1) {
+			state1_features.pNext = features.pNext;
+			features.pNext = &state1_features;
+		}
+		if (has_state2) {
+			state2_features.pNext = features.pNext;
+			features.pNext = &state2_features;
+		}
+		if (has_state3) {
+			state3_features.pNext = features.pNext;
+			features.pNext = &state3_features;
+		}
+		vkGetPhysicalDeviceFeatures2(device, &features);
+
+		support.state1 = has_state1 && state1_features.extendedDynamicState;
+		support.state2 = has_state2 && state2_features.extendedDynamicState2;
+		support.state3_polygon_mode = has_state3 && state3_features.extendedDynamicState3PolygonMode;
+		support.state3_blend_enable = has_state3 && state3_features.extendedDynamicState3ColorBlendEnable;
+		return support;
+	}
+
+	bool GraphicsContext::checkMemoryBudgetSupport(const VkPhysicalDevice& device) {
+		uint32_t extension_count;
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, nullptr);
+		std::vector<VkExtensionProperties> available_extensions(extension_count);
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extension_count, available_extensions.data());
+
+		for (const auto& extension : available_extensions) {
+			if (strcmp(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME, extension.extensionName) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	SwapchainSupportDetails GraphicsContext::queryPhysicalSwapChainSupport(const VkPhysicalDevice& device, const VkSurfaceKHR& surface) {
 
 		// Query the surface capabilities of the physical device
@@ -7,6 +7,11 @@
 #include "Window.hpp"
 #include "Instance.hpp"
 #include "SwapchainSupportDetails.h"
+#include "QueueUtils.hpp"
+#include "ExtendedDynamicState.hpp"
+#include "DeletionQueue.hpp"
+#include "MemoryBudget.hpp"
+#include "FrameAllocator.hpp"
 
 class GraphicsContext : public Window, public Instance
 {
@@ -15,6 +20,27 @@ class GraphicsContext : public Window, public Instance
 
 	VkDevice logical_device;
 	VkQueue present_queue;
+	VkQueue transfer_queue;
+
+	QueueUtils::QueueFamilyIndices queue_families;
+
+	VkPipelineCache pipeline_cache;
+
+	bool bindless_supported;
+
+	bool multi_draw_indirect_supported;
+
+	ExtendedDynamicState extended_dynamic_state;
+
+	// Counts allocations made through a const context
+	mutable MemoryBudget memory_budget;
+
+	// Releasing objects doesn't change the context anyone else sees, so const users may push.
+	// Declared after the budget, since releases still report their frees to it
+	mutable DeletionQueue deletion_queue;
+
+	// Per-frame scratch memory, handed out to const users like the queues above
+	mutable FrameAllocator frame_allocator;
 
 public:
 	GraphicsContext(const char* name);
@@ -28,6 +54,45 @@ public:
 
 	inline const VkQueue& getPresentQueue() const { return present_queue; }
 
+	inline const VkQueue& getTransferQueue() const { return transfer_queue; }
+
+	inline const QueueUtils::QueueFamilyIndices& getQueueFamilies() const { return queue_families; }
+
+	inline const VkPipelineCache& getPipelineCache() const { return pipeline_cache; }
+
+	/**
+	 * @brief Whether the descriptor indexing features needed by BindlessDescriptors were enabled.
+	 */
+	inline bool supportsBindless() const { return bindless_supported; }
+
+	/**
+	 * @brief Whether a single indirect draw call may issue more than one draw.
+	 */
+	inline bool supportsMultiDrawIndirect() const { return multi_draw_indirect_supported; }
+
+	/**
+	 * @brief The extended dynamic state levels that were enabled, and their commands.
+	 */
+	inline const ExtendedDynamicState& getExtendedDynamicState() const { return extended_dynamic_state; }
+
+	/**
+	 * @brief Where GPU objects the frames in flight may still use are released. Frames
+	 * destroys them as their frames finish; whatever is left goes before the device does.
+	 */
+	inline DeletionQueue& getDeletionQueue() const { return deletion_queue; }
+
+	/**
+	 * @brief Device memory use per heap and category, against the driver's budget where
+	 * VK_EXT_memory_budget is available.
+	 */
+	inline MemoryBudget& getMemoryBudget() const { return memory_budget; }
+
+	/**
+	 * @brief Arenas for CPU data that only has to last until its frame comes round again;
+	 * get() is the arena of the frame being recorded.
+	 */
+	inline FrameAllocator& getFrameAllocator() const { return frame_allocator; }
+
 	inline GLFWwindow* getWindow() const { return window; }
 
 private:
@@ -38,6 +103,10 @@ private:
 
 	void createPhysicalDevice();
 
+	void createPipelineCache();
+
+	void loadExtendedDynamicState();
+
 //Helper functions
 	static bool isPhysicalDeviceSuitable(const VkPhysicalDevice& device, const VkSurfaceKHR& surface);
 
@@ -45,6 +114,12 @@ private:
 
 	static bool checkPhysicalDeviceExtensionSupport(const VkPhysicalDevice& device);
 
+	static bool checkBindlessSupport(const VkPhysicalDevice& device);
+
+	static ExtendedDynamicState checkExtendedDynamicStateSupport(const VkPhysicalDevice& device);
+
+	static bool checkMemoryBudgetSupport(const VkPhysicalDevice& device);
+
 public:
 	static SwapchainSupportDetails queryPhysicalSwapChainSupport(const VkPhysicalDevice& device, const VkSurfaceKHR& surface);
 
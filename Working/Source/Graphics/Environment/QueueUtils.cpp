@@ -32,9 +32,19 @@ QueueUtils::QueueFamilyIndices QueueUtils::findQueueFamilies(const VkPhysicalDev
 					indices.present_family = i; // Set the present family index in the QueueFamilyIndices struct
 				}
 
+				// A transfer-only family maps to the copy engines, so uploads don't compete with rendering
+				if ((queue_family.queueFlags & VK_QUEUE_TRANSFER_BIT) 
+					&& !(queue_family.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) {
+					indices.transfer_family = i;
+				}
+
 				i++; // Increment the counter
 			}
 		}
 
+		if (!indices.transfer_family.has_value()) {
+			indices.transfer_family = indices.graphics_family; // Graphics queues always support transfers
+		}
+
 		return indices; // Return the QueueFamilyIndices struct
 	}
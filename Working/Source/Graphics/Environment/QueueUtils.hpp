@@ -13,6 +13,7 @@ namespace QueueUtils {
     struct QueueFamilyIndices {
         std::optional<uint32_t> graphics_family;
         std::optional<uint32_t> present_family;
+        std::optional<uint32_t> transfer_family; /**< Dedicated transfer family if one exists, otherwise the graphics family. */
 
         /**
          * @brief Check if the queue families are complete
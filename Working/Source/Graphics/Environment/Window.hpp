@@ -27,6 +27,15 @@ public:
 		glfwGetWindowSize(window, &width, &height);
 		return {(uint32_t)width, (uint32_t)height};
 	}
+
+    /**
+     * @brief Size of the window's framebuffer in pixels; zero while the window is minimized.
+     */
+    inline std::pair<uint32_t, uint32_t> getFramebufferSize() const {
+        int width, height;
+        glfwGetFramebufferSize(window, &width, &height);
+        return {(uint32_t)width, (uint32_t)height};
+    }
 };
 
 #endif // !MEADOW_WINDOW_HPP
\ No newline at end of file
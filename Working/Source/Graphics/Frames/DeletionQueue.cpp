@@ -0,0 +1,48 @@
+#include "DeletionQueue.hpp"
+#include <vector>
+
+DeletionQueue::DeletionQueue() :
+    serial(0)
+{}
+
+DeletionQueue::~DeletionQueue() {
+    flush();
+}
+
+void DeletionQueue::push(std::function<void()> destroy) {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.push_back({serial, std::move(destroy)});
+}
+
+void DeletionQueue::beginFrame(uint64_t serial) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->serial = serial;
+}
+
+void DeletionQueue::collect(uint64_t completed_serial) {
+    // Run outside the lock, so a release may itself push (e.g. an object owning others)
+    std::vector<std::function<void()>> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        while (!entries.empty() && entries.front().serial <= completed_serial) {
+            ready.push_back(std::move(entries.front().destroy));
+            entries.pop_front();
+        }
+    }
+
+    for (auto& destroy : ready) {
+        destroy();
+    }
+}
+
+void DeletionQueue::flush() {
+    // Releases can push more releases; keep going until none are left
+    while (size() > 0) {
+        collect(UINT64_MAX);
+    }
+}
+
+size_t DeletionQueue::size() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return entries.size();
+}
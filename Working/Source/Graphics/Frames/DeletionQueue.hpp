@@ -0,0 +1,67 @@
+#ifndef _MEADOW_DELETION_QUEUE_HPP_
+#define _MEADOW_DELETION_QUEUE_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+/**
+ * @brief Defers destroying GPU objects until the frames that may still use them have finished.
+ *
+ * Each release is stamped with the serial of the frame being recorded when it was pushed.
+ * Frames calls collect() once a frame's fence has signalled, which runs every release
+ * stamped with that frame's serial or earlier. Frames are submitted in order on one queue,
+ * so nothing older can still be executing. Replacing a swapchain, a pipeline or an asset
+ * then costs nothing on the GPU, rather than draining it with vkDeviceWaitIdle.
+ *
+ * Releases may be pushed from any thread. They run on the thread calling collect().
+ */
+class DeletionQueue {
+    struct Entry {
+        uint64_t serial;
+        std::function<void()> destroy;
+    };
+
+    std::mutex mutex;
+    std::deque<Entry> entries; /**< Serials never decrease from front to back. */
+    uint64_t serial;
+
+public:
+    DeletionQueue();
+
+    ~DeletionQueue();
+
+    DeletionQueue(const DeletionQueue&) = delete;
+    DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+    /**
+     * @brief Queues destroy to run once the frame currently being recorded, and every
+     * frame before it, has finished on the GPU.
+     */
+    void push(std::function<void()> destroy);
+
+    /**
+     * @brief Stamps subsequent pushes with the serial of a newly begun frame.
+     */
+    void beginFrame(uint64_t serial);
+
+    /**
+     * @brief Runs every release stamped with completed_serial or earlier.
+     */
+    void collect(uint64_t completed_serial);
+
+    /**
+     * @brief Runs every queued release. The GPU must be idle, e.g. at shutdown.
+     */
+    void flush();
+
+    /**
+     * @brief Serial of the frame currently being recorded.
+     */
+    inline uint64_t getSerial() const { return serial; }
+
+    size_t size();
+};
+
+#endif // _MEADOW_DELETION_QUEUE_HPP_
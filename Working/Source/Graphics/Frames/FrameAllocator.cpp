@@ -0,0 +1,63 @@
+#include "FrameAllocator.hpp"
+#include "Config.h"
+#include <algorithm>
+
+namespace {
+    std::unique_ptr<std::byte[]> allocateBlock(size_t size) {
+        // Left uninitialized, unlike make_unique
+        return std::unique_ptr<std::byte[]>(new std::byte[size]);
+    }
+}
+
+FrameAllocator::Arena::Arena(size_t capacity) :
+    offset(0),
+    used(0),
+    peak(0)
+{
+    blocks.push_back({allocateBlock(capacity), capacity});
+}
+
+void FrameAllocator::Arena::reset() {
+    peak = std::max(peak, getUsed());
+
+    if (blocks.size() > 1) {
+        // Room for everything the last frame needed, and some to spare, in a single block
+        const size_t capacity = getUsed() + getUsed() / 2;
+        blocks.clear();
+        blocks.push_back({allocateBlock(capacity), capacity});
+    }
+
+    offset = 0;
+    used = 0;
+}
+
+void* FrameAllocator::Arena::do_allocate(size_t bytes, size_t alignment) {
+    Block* block = &blocks.back();
+    void* pointer = block->data.get() + offset;
+    size_t space = block->size - offset;
+
+    if (!std::align(alignment, bytes, pointer, space)) {
+        used += offset;
+        const size_t size = std::max(blocks.front().size, bytes + alignment);
+        blocks.push_back({allocateBlock(size), size});
+
+        block = &blocks.back();
+        pointer = block->data.get();
+        space = block->size;
+        std::align(alignment, bytes, pointer, space);
+    }
+
+    offset = static_cast<std::byte*>(pointer) - block->data.get() + bytes;
+    return pointer;
+}
+
+FrameAllocator::FrameAllocator() : current(0) {
+    for (uint32_t i = 0; i < CONSTANTS::FRAMES_IN_FLIGHT; i++) {
+        arenas.push_back(std::make_unique<Arena>(CONSTANTS::FRAME_ARENA_SIZE));
+    }
+}
+
+void FrameAllocator::beginFrame(uint32_t frame) {
+    current = frame;
+    arenas[current]->reset();
+}
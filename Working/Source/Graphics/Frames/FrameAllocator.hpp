@@ -0,0 +1,91 @@
+#ifndef _MEADOW_FRAME_ALLOCATOR_HPP_
+#define _MEADOW_FRAME_ALLOCATOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+/**
+ * @brief Bump allocators for CPU data that only lives for one frame, one per frame in flight.
+ *
+ * Frames calls beginFrame() once a frame's fence has signalled, which rewinds that
+ * frame's arena in one step. Everything allocated while recording it stays valid
+ * until the same frame comes round again. Hot-path code then builds its temporary
+ * arrays without touching the heap:
+ *
+ *     std::pmr::vector<VkImageMemoryBarrier> barriers(&context.getFrameAllocator().get());
+ *
+ * An arena that runs out chains an overflow block, then grows to fit the frame's peak
+ * when it is next reset, so steady-state frames make no malloc calls at all.
+ *
+ * Not thread-safe: allocate from the thread recording the frame.
+ */
+class FrameAllocator {
+public:
+    /**
+     * @brief A single frame's arena. Deallocation is a no-op; memory is reclaimed by reset().
+     */
+    class Arena : public std::pmr::memory_resource {
+        struct Block {
+            std::unique_ptr<std::byte[]> data;
+            size_t size;
+        };
+
+        std::vector<Block> blocks; /**< The arena first, then any overflow blocks. */
+        size_t offset; /**< Bytes used in the last block. */
+        size_t used; /**< Bytes used in every block before the last. */
+        size_t peak;
+
+    public:
+        explicit Arena(size_t capacity);
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        /**
+         * @brief Frees everything allocated since the last reset, regrowing to fit it if it overflowed.
+         */
+        void reset();
+
+        inline size_t getUsed() const { return used + offset; }
+
+        inline size_t getCapacity() const { return blocks.front().size; }
+
+        /**
+         * @brief The most ever used between two resets.
+         */
+        inline size_t getPeak() const { return peak; }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+
+        inline void do_deallocate(void*, size_t, size_t) override {}
+
+        inline bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+private:
+    std::vector<std::unique_ptr<Arena>> arenas;
+    uint32_t current;
+
+public:
+    FrameAllocator();
+
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    /**
+     * @brief Rewinds the arena of frame and makes it current. Whatever was allocated while
+     * that frame was last recorded must no longer be used.
+     */
+    void beginFrame(uint32_t frame);
+
+    /**
+     * @brief The arena of the frame being recorded.
+     */
+    inline Arena& get() const { return *arenas[current]; }
+};
+
+#endif // _MEADOW_FRAME_ALLOCATOR_HPP_
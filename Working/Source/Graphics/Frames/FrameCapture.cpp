@@ -0,0 +1,265 @@
+#include "FrameCapture.hpp"
+#include "Config.h"
+#include "Logging.hpp"
+#include "Png.hpp"
+#include "QueueUtils.hpp"
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t BYTES_PER_PIXEL = 4;
+
+    bool isBgra(VkFormat format) {
+        return format == VK_FORMAT_B8G8R8A8_SRGB || format == VK_FORMAT_B8G8R8A8_UNORM;
+    }
+
+    bool isRgba(VkFormat format) {
+        return format == VK_FORMAT_R8G8B8A8_SRGB || format == VK_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+FrameCapture::FrameCapture(const GraphicsContext& context, Swapchain& swapchain, JobSystem& jobs, Sink sink) :
+    context(context),
+    swapchain(swapchain),
+    jobs(jobs),
+    sink(std::move(sink)),
+    command_pool(VK_NULL_HANDLE),
+    copying(CONSTANTS::FRAMES_IN_FLIGHT, -1),
+    capturing(false),
+    frame_index(0),
+    captured(0),
+    dropped(0),
+    delivered(0)
+{
+    if (!(swapchain.getImageUsage() & VK_IMAGE_USAGE_TRANSFER_SRC_BIT)) {
+        throw std::runtime_error("Frame capture needs swapchain images that can be copied from");
+    }
+    if (!isBgra(swapchain.getFormat()) && !isRgba(swapchain.getFormat())) {
+        throw std::runtime_error("Frame capture only supports 8-bit RGBA and BGRA swapchain formats");
+    }
+
+    QueueUtils::QueueFamilyIndices queue_family_indices =
+        QueueUtils::findQueueFamilies(context.getPhysicalDevice(), context.getSurface());
+
+    VkCommandPoolCreateInfo pool_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+        .queueFamilyIndex = queue_family_indices.graphics_family.value()
+    };
+
+    if (vkCreateCommandPool(context.getLogicalDevice(), &pool_info, nullptr, &command_pool)) {
+        throw std::runtime_error("Failed to create frame capture command pool!");
+    }
+
+    command_buffers.resize(CONSTANTS::FRAMES_IN_FLIGHT);
+    VkCommandBufferAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = command_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = CONSTANTS::FRAMES_IN_FLIGHT
+    };
+
+    if (vkAllocateCommandBuffers(context.getLogicalDevice(), &alloc_info, command_buffers.data())) {
+        vkDestroyCommandPool(context.getLogicalDevice(), command_pool, nullptr);
+        throw std::runtime_error("Failed to allocate frame capture command buffers!");
+    }
+
+    // Buffers are only allocated once capturing starts, sized for the swapchain at the time
+    for (uint32_t i = 0; i < CONSTANTS::CAPTURE_RING_SIZE; i++) {
+        slots.push_back(std::make_unique<Slot>());
+        slots.back()->state.store(SlotState::Free);
+    }
+}
+
+FrameCapture::~FrameCapture() {
+    wait();
+    vkDestroyCommandPool(context.getLogicalDevice(), command_pool, nullptr);
+}
+
+void FrameCapture::start() {
+    frame_index = 0;
+    capturing = true;
+}
+
+VkCommandBuffer FrameCapture::record(uint32_t frame, uint32_t image_index) {
+    if (!capturing) {
+        return VK_NULL_HANDLE;
+    }
+
+    const uint64_t index = frame_index++;
+
+    Slot* slot = nullptr;
+    for (uint32_t i = 0; i < slots.size(); i++) {
+        if (slots[i]->state.load(std::memory_order_acquire) == SlotState::Free) {
+            slot = slots[i].get();
+            copying[frame] = (int32_t)i;
+            break;
+        }
+    }
+    if (!slot) {
+        dropped++;
+        return VK_NULL_HANDLE;
+    }
+
+    const VkExtent2D extent = swapchain.getExtent();
+    const VkDeviceSize size = (VkDeviceSize)extent.width * extent.height * BYTES_PER_PIXEL;
+    if (!slot->buffer || slot->buffer->getSize() < size) {
+        createBuffer(*slot, size);
+    }
+
+    slot->frame = {
+        .index = index,
+        .width = extent.width,
+        .height = extent.height,
+        .format = swapchain.getFormat(),
+        .pixels = (const uint8_t*)slot->buffer->getMapped()
+    };
+    slot->state.store(SlotState::Copying, std::memory_order_relaxed);
+
+    VkCommandBuffer command_buffer = command_buffers[frame];
+    VkCommandBufferBeginInfo begin_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+    if (vkBeginCommandBuffer(command_buffer, &begin_info) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin frame capture command buffer!");
+    }
+
+    const VkImageSubresourceRange color_range = {
+        .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+        .baseMipLevel = 0,
+        .levelCount = 1,
+        .baseArrayLayer = 0,
+        .layerCount = 1
+    };
+
+    // Chains with the render pass's exit dependency, which already made the color writes visible to transfers
+    VkImageMemoryBarrier to_transfer = {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask = 0,
+        .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+        .oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .image = swapchain.getImages()[image_index],
+        .subresourceRange = color_range
+    };
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &to_transfer);
+
+    VkBufferImageCopy region = {
+        .bufferOffset = 0,
+        .bufferRowLength = 0,
+        .bufferImageHeight = 0,
+        .imageSubresource = {
+            .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        },
+        .imageOffset = {0, 0, 0},
+        .imageExtent = {extent.width, extent.height, 1}
+    };
+    vkCmdCopyImageToBuffer(command_buffer, to_transfer.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        slot->buffer->getBuffer(), 1, &region);
+
+    // Back to PRESENT_SRC for the present, which waits on the frame's semaphore and so on this copy
+    VkImageMemoryBarrier to_present = to_transfer;
+    to_present.srcAccessMask = 0;
+    to_present.dstAccessMask = 0;
+    to_present.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    to_present.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+    VkBufferMemoryBarrier to_host = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+        .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = slot->buffer->getBuffer(),
+        .offset = 0,
+        .size = VK_WHOLE_SIZE
+    };
+    vkCmdPipelineBarrier(command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_HOST_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 1, &to_host, 1, &to_present);
+
+    if (vkEndCommandBuffer(command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record frame capture command buffer!");
+    }
+    return command_buffer;
+}
+
+void FrameCapture::collect(uint32_t frame) {
+    if (copying[frame] < 0) {
+        return;
+    }
+    Slot& slot = *slots[copying[frame]];
+    copying[frame] = -1;
+    captured++;
+
+    slot.state.store(SlotState::Sinking, std::memory_order_relaxed);
+    jobs.schedule([this, &slot]() {
+        try {
+            sink(slot.frame);
+        }
+        catch (const std::exception& e) {
+            Log::error << "[CAPTURE] Frame " << slot.frame.index << ": " << e.what() << std::endl;
+        }
+        delivered.fetch_add(1, std::memory_order_relaxed);
+        slot.state.store(SlotState::Free, std::memory_order_release);
+    }, &sinking);
+}
+
+void FrameCapture::wait() {
+    jobs.wait(sinking);
+}
+
+FrameCapture::Stats FrameCapture::getStats() const {
+    return {
+        .captured = captured,
+        .dropped = dropped,
+        .delivered = delivered.load(std::memory_order_relaxed)
+    };
+}
+
+FrameCapture::Sink FrameCapture::fileSink(std::string directory, Format format) {
+    return [directory = std::move(directory), format](const Frame& frame) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "/frame_%06llu.%s", (unsigned long long)frame.index,
+            format == Format::Png ? "png" : "raw");
+        const std::string path = directory + name;
+
+        if (format == Format::Png) {
+            Png::write(path.c_str(), frame.pixels, frame.width, frame.height,
+                frame.width * BYTES_PER_PIXEL, isBgra(frame.format));
+            return;
+        }
+
+        FILE* file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            throw std::runtime_error("Failed to open " + path + " for writing");
+        }
+        const size_t size = (size_t)frame.width * frame.height * BYTES_PER_PIXEL;
+        const size_t written = std::fwrite(frame.pixels, 1, size, file);
+        if (std::fclose(file) != 0 || written != size) {
+            throw std::runtime_error("Failed to write " + path);
+        }
+    };
+}
+
+void FrameCapture::createBuffer(Slot& slot, VkDeviceSize size) {
+    // The buffer is free, so no frame can still be copying into the old one
+    slot.buffer.reset();
+
+    // Cached memory makes the sink's reads far faster; not every device has it host-coherent
+    try {
+        slot.buffer = std::make_unique<Buffer>(context, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+    }
+    catch (const std::runtime_error&) {
+        slot.buffer = std::make_unique<Buffer>(context, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    }
+}
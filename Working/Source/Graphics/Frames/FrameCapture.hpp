@@ -0,0 +1,137 @@
+#ifndef _MEADOW_FRAME_CAPTURE_HPP_
+#define _MEADOW_FRAME_CAPTURE_HPP_
+
+#include <vulkan/vulkan.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "GraphicsContext.hpp"
+#include "Swapchain.hpp"
+#include "Buffer.hpp"
+#include "JobSystem.hpp"
+
+/**
+ * @brief Reads rendered frames back to the host without stalling.
+ *
+ * Each frame, record() copies the swapchain image into a free buffer from a ring of
+ * host-visible readback buffers, in a command buffer Frames submits right after the
+ * frame's own. Once the frame's fence signals, FRAMES_IN_FLIGHT frames later, collect()
+ * hands the still-mapped buffer to a sink on a worker thread, and the buffer returns to
+ * the ring when the sink is done. When sinks fall behind and the ring runs out, frames
+ * are dropped rather than waited for, and counted in getStats().
+ *
+ * Destroy the capture after the Frames it is attached to, which delivers the last
+ * frames in flight when it is destroyed.
+ */
+class FrameCapture {
+public:
+    enum class Format {
+        Raw, /**< Pixels exactly as read back, in the swapchain's format. */
+        Png
+    };
+
+    struct Frame {
+        uint64_t index; /**< Frames since start(), counting dropped ones. */
+        uint32_t width;
+        uint32_t height;
+        VkFormat format; /**< The swapchain format; always 4 bytes per pixel. */
+        const uint8_t* pixels; /**< Tightly packed rows. Only valid during the sink call. */
+    };
+
+    /**
+     * @brief Consumes a captured frame. Runs on a worker thread, possibly several at once.
+     */
+    using Sink = std::function<void(const Frame&)>;
+
+    struct Stats {
+        uint64_t captured; /**< Frames copied back. */
+        uint64_t dropped; /**< Frames skipped because every buffer was busy. */
+        uint64_t delivered; /**< Frames the sink has finished with. */
+    };
+
+private:
+    enum class SlotState : uint32_t {
+        Free,
+        Copying, /**< A frame in flight is copying into it. */
+        Sinking /**< The sink is reading it on a worker. */
+    };
+
+    struct Slot {
+        std::unique_ptr<Buffer> buffer;
+        Frame frame;
+        std::atomic<SlotState> state;
+    };
+
+    const GraphicsContext& context;
+    Swapchain& swapchain;
+    JobSystem& jobs;
+    Sink sink;
+
+    VkCommandPool command_pool;
+    std::vector<VkCommandBuffer> command_buffers; /**< One per frame in flight. */
+    std::vector<int32_t> copying; /**< Slot each frame in flight copies into, or -1. */
+    std::vector<std::unique_ptr<Slot>> slots;
+    JobCounter sinking;
+
+    bool capturing;
+    uint64_t frame_index;
+    uint64_t captured;
+    uint64_t dropped;
+    std::atomic<uint64_t> delivered;
+
+public:
+    /**
+     * @brief Throws if the swapchain images can't be copied from, or aren't 8 bits per channel RGBA/BGRA.
+     */
+    FrameCapture(const GraphicsContext& context, Swapchain& swapchain, JobSystem& jobs, Sink sink);
+
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    /**
+     * @brief Captures every frame from the next one on, numbering them from 0.
+     */
+    void start();
+
+    /**
+     * @brief Stops capturing new frames; frames already copied are still delivered.
+     */
+    inline void stop() { capturing = false; }
+
+    inline bool isCapturing() const { return capturing; }
+
+    /**
+     * @brief Records the copy of a swapchain image, which must be in PRESENT_SRC_KHR when the
+     * command buffer runs and is left that way. Called by Frames after recording the frame.
+     *
+     * @return The command buffer to submit after the frame's, or VK_NULL_HANDLE when
+     * nothing is captured.
+     */
+    VkCommandBuffer record(uint32_t frame, uint32_t image_index);
+
+    /**
+     * @brief Passes the frame's copy to the sink. Called by Frames once the frame's fence has signalled.
+     */
+    void collect(uint32_t frame);
+
+    /**
+     * @brief Blocks until the sink has finished with every frame collected so far.
+     */
+    void wait();
+
+    Stats getStats() const;
+
+    /**
+     * @brief A sink writing each frame to directory/frame_<index>.png or .raw.
+     */
+    static Sink fileSink(std::string directory, Format format);
+
+private:
+    void createBuffer(Slot& slot, VkDeviceSize size);
+};
+
+#endif // _MEADOW_FRAME_CAPTURE_HPP_
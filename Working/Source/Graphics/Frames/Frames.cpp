@@ -1,12 +1,14 @@
 #include "Frames.hpp"
 #include "Config.h"
+#include "Logging.hpp"
 #include <stdexcept>
 #include <iostream>
 
 
-Frames::Frames(const GraphicsContext& context, Swapchain& swapchain, 
-    Pipeline& pipeline) : 
-    context(context), swapchain(swapchain), pipeline(pipeline), current_frame(0)
+Frames::Frames(const GraphicsContext& context, Swapchain& swapchain) : 
+    context(context), swapchain(swapchain), 
+    submitted_serial(CONSTANTS::FRAMES_IN_FLIGHT, 0), frame_serial(0), render_graph(nullptr), frame_capture(nullptr), 
+    framebuffer_size(context.getFramebufferSize()), current_frame(0)
 {
     command_pools.reserve(CONSTANTS::FRAMES_IN_FLIGHT);
     for (uint32_t i = 0; i < CONSTANTS::FRAMES_IN_FLIGHT; i++) {
@@ -17,22 +19,25 @@ Frames::Frames(const GraphicsContext& context, Swapchain& swapchain,
 }
 
 Frames::~Frames() {
-    vkDeviceWaitIdle(context.getLogicalDevice());
-    cleanup();
-}
-
-void Frames::cleanup() {
-    for (uint32_t i = 0; i < CONSTANTS::FRAMES_IN_FLIGHT; i++) {
-        vkDestroySemaphore(context.getLogicalDevice(), image_available[i], nullptr);
-        vkDestroySemaphore(context.getLogicalDevice(), render_finished[i], nullptr);
-        vkDestroyFence(context.getLogicalDevice(), frame_rendered_fence[i], nullptr);
+    // Once every frame's fence has signalled, nothing up to the last submitted serial is in
+    // use; transfers on other queues keep going
+    std::vector<VkFence> fences;
+    for (const auto& fence : frame_rendered_fence) {
+        fences.push_back(fence);
+    }
+    vkWaitForFences(context.getLogicalDevice(), (uint32_t)fences.size(), fences.data(), VK_TRUE, UINT64_MAX);
+    context.getDeletionQueue().collect(frame_serial);
+    if (frame_capture) {
+        for (uint32_t i = 0; i < CONSTANTS::FRAMES_IN_FLIGHT; i++) {
+            frame_capture->collect(i);
+        }
     }
 }
 
 void Frames::createSyncObjs() {
-    image_available.resize(CONSTANTS::FRAMES_IN_FLIGHT);
-    render_finished.resize(CONSTANTS::FRAMES_IN_FLIGHT);
-    frame_rendered_fence.resize(CONSTANTS::FRAMES_IN_FLIGHT);
+    image_available.reserve(CONSTANTS::FRAMES_IN_FLIGHT);
+    render_finished.reserve(CONSTANTS::FRAMES_IN_FLIGHT);
+    frame_rendered_fence.reserve(CONSTANTS::FRAMES_IN_FLIGHT);
     VkSemaphoreCreateInfo semaphore_create_info = {
         .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO
         
@@ -43,43 +48,93 @@ void Frames::createSyncObjs() {
         .flags = VK_FENCE_CREATE_SIGNALED_BIT
     };
 
+    const VkDevice device = context.getLogicalDevice();
     for (uint32_t i = 0; i < CONSTANTS::FRAMES_IN_FLIGHT; i++) {
-        if (vkCreateSemaphore(context.getLogicalDevice(), &semaphore_create_info, nullptr, 
-                &image_available[i]) ||
-            vkCreateSemaphore(context.getLogicalDevice(), &semaphore_create_info, nullptr, 
-                &render_finished[i]) ||
-            vkCreateFence(context.getLogicalDevice(), &fence_create_info, nullptr, 
-                &frame_rendered_fence[i])) 
-        {
+        VkSemaphore available, finished;
+        VkFence fence;
+        if (vkCreateSemaphore(device, &semaphore_create_info, nullptr, &available)) {
+            throw std::runtime_error("Failed to create synchronization objects for a frame!");
+        }
+        image_available.emplace_back(available, SemaphoreHandle::deleter_type{device});
+
+        if (vkCreateSemaphore(device, &semaphore_create_info, nullptr, &finished)) {
+            throw std::runtime_error("Failed to create synchronization objects for a frame!");
+        }
+        render_finished.emplace_back(finished, SemaphoreHandle::deleter_type{device});
+
+        if (vkCreateFence(device, &fence_create_info, nullptr, &fence)) {
             throw std::runtime_error("Failed to create synchronization objects for a frame!");
         }
+        frame_rendered_fence.emplace_back(fence, FenceHandle::deleter_type{device});
     }
 }
 
 void Frames::drawFrame() {
-    vkWaitForFences(context.getLogicalDevice(), 1, 
-        &frame_rendered_fence[current_frame], VK_TRUE, UINT64_MAX);
+    if (!render_graph) {
+        throw std::runtime_error("Failed to draw a frame: no render graph was set!");
+    }
 
-    vkResetFences(context.getLogicalDevice(), 1, &frame_rendered_fence[current_frame]);
+    vkWaitForFences(context.getLogicalDevice(), 1, 
+        &frame_rendered_fence[current_frame].get(), VK_TRUE, UINT64_MAX);
 
     uint32_t image_index;
-    vkAcquireNextImageKHR(context.getLogicalDevice(), swapchain, UINT64_MAX, 
+    VkResult acquired = vkAcquireNextImageKHR(context.getLogicalDevice(), swapchain, UINT64_MAX, 
         image_available[current_frame], VK_NULL_HANDLE, &image_index);
-    
+    if (acquired == VK_ERROR_OUT_OF_DATE_KHR) {
+        // Nothing was submitted, so the fence is still signalled for the next attempt
+        recreateSwapchain();
+        return;
+    }
+    if (acquired != VK_SUCCESS && acquired != VK_SUBOPTIMAL_KHR) {
+        throw std::runtime_error("Failed to acquire a swapchain image!");
+    }
+
+    vkResetFences(context.getLogicalDevice(), 1, &frame_rendered_fence[current_frame].get());
+
+    // Frames complete in submission order, so everything released up to the frame that
+    // last used this fence is no longer in use
+    context.getDeletionQueue().collect(submitted_serial[current_frame]);
+    frame_serial++;
+    submitted_serial[current_frame] = frame_serial;
+    context.getDeletionQueue().beginFrame(frame_serial);
+    context.getFrameAllocator().beginFrame(current_frame);
+
+    context.getMemoryBudget().update();
+    if (CONSTANTS::MEMORY_REPORT_INTERVAL > 0 && frame_serial % CONSTANTS::MEMORY_REPORT_INTERVAL == 0) {
+        context.getMemoryBudget().report(Log::info);
+    }
+
+    if (frame_capture) {
+        frame_capture->collect(current_frame);
+    }
+
+    for (auto& callback : frame_reset_callbacks) {
+        callback(current_frame);
+    }
+
     vkResetCommandBuffer(command_pools[current_frame].getCommandBuffer(0), 0);
-    command_pools[current_frame].beginCommandBuffer(0, image_index, pipeline);
+    render_graph->reset();
+    render_graph_builder(*render_graph, image_index);
+    render_graph->compile();
+    command_pools[current_frame].recordRenderGraph(0, *render_graph);
+
+    // The capture copies the finished image in a second command buffer of the same submit
+    VkCommandBuffer command_buffers[2] = { command_pools[current_frame].getCommandBuffer(0), VK_NULL_HANDLE };
+    if (frame_capture) {
+        command_buffers[1] = frame_capture->record(current_frame, image_index);
+    }
 
     const VkPipelineStageFlags wait_stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
 
     VkSubmitInfo submit_info = {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
         .waitSemaphoreCount = 1,
-        .pWaitSemaphores = &image_available[current_frame],
+        .pWaitSemaphores = &image_available[current_frame].get(),
         .pWaitDstStageMask = &wait_stages,
-        .commandBufferCount = 1,
-        .pCommandBuffers = &command_pools[current_frame].getCommandBuffer(0),
+        .commandBufferCount = command_buffers[1] != VK_NULL_HANDLE ? 2u : 1u,
+        .pCommandBuffers = command_buffers,
         .signalSemaphoreCount = 1,
-        .pSignalSemaphores = &render_finished[current_frame]
+        .pSignalSemaphores = &render_finished[current_frame].get()
     };
 
     if (vkQueueSubmit(context.getPresentQueue(), 1, &submit_info, frame_rendered_fence[current_frame])) {
@@ -89,14 +144,35 @@ void Frames::drawFrame() {
     VkPresentInfoKHR present_info = {
         .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
         .waitSemaphoreCount = 1,
-        .pWaitSemaphores = &render_finished[current_frame],
+        .pWaitSemaphores = &render_finished[current_frame].get(),
         .swapchainCount = 1,
         .pSwapchains = swapchain,
         .pImageIndices = &image_index
     };
 
-    vkQueuePresentKHR(context.getPresentQueue(), &present_info);
+    VkResult presented = vkQueuePresentKHR(context.getPresentQueue(), &present_info);
     current_frame = (current_frame + 1) * (current_frame+1 < CONSTANTS::FRAMES_IN_FLIGHT);
 
-    
+    // A suboptimal image was still rendered and presented; it is replaced from the next frame
+    if (presented == VK_ERROR_OUT_OF_DATE_KHR || presented == VK_SUBOPTIMAL_KHR 
+        || acquired == VK_SUBOPTIMAL_KHR || context.getFramebufferSize() != framebuffer_size) 
+    {
+        recreateSwapchain();
+    }
+    else if (presented != VK_SUCCESS) {
+        throw std::runtime_error("Failed to present a swapchain image!");
+    }
+}
+
+void Frames::recreateSwapchain() {
+    // A minimized window has nothing to present to until it is restored
+    framebuffer_size = context.getFramebufferSize();
+    while (framebuffer_size.first == 0 || framebuffer_size.second == 0) {
+        glfwWaitEvents();
+        framebuffer_size = context.getFramebufferSize();
+    }
+
+    // The old images, attachments and framebuffers go through the deletion queue
+    swapchain.recreate();
+    render_graph->invalidateFramebuffers();
 }
\ No newline at end of file
@@ -3,41 +3,100 @@
 
 #include <vulkan/vulkan.h>
 #include <vector>
+#include <functional>
 #include "GraphicsContext.hpp"
+#include "DeviceHandle.hpp"
 #include "Swapchain.hpp"
 #include "CommandPool.hpp"
+#include "FrameCapture.hpp"
 
 
 /**
  * @brief The Frames class represents a collection of frames used for rendering graphics.
  * 
  * This class manages synchronization objects, such as semaphores and fences, 
- * as well as command pools for each frame. It provides functionality to draw a frame.
+ * as well as command pools for each frame. It provides functionality to draw a frame,
+ * recorded from a RenderGraph.
+ * It also drives the context's DeletionQueue: a release is carried out once the
+ * fence of the frame it was pushed during has signalled. The swapchain is recreated
+ * whenever acquiring or presenting reports it out of date or suboptimal, or the window resizes.
  */
 class Frames {
     const GraphicsContext& context;
     Swapchain& swapchain;
-    Pipeline& pipeline;
 
-    std::vector<VkSemaphore> image_available;
-    std::vector<VkSemaphore> render_finished;
-    std::vector<VkFence> frame_rendered_fence;
+    std::vector<SemaphoreHandle> image_available;
+    std::vector<SemaphoreHandle> render_finished;
+    std::vector<FenceHandle> frame_rendered_fence;
+    std::vector<uint64_t> submitted_serial; /**< Serial of the frame each fence was last submitted with. */
+    uint64_t frame_serial;
     std::vector<CommandPool> command_pools;
+    std::vector<std::function<void(uint32_t)>> frame_reset_callbacks;
+    RenderGraph* render_graph;
+    FrameCapture* frame_capture;
+    std::function<void(RenderGraph&, uint32_t)> render_graph_builder;
+    std::pair<uint32_t, uint32_t> framebuffer_size; /**< Window framebuffer size the swapchain was last sized for. */
     uint32_t current_frame;
 
 public:
-    Frames(const GraphicsContext& device, Swapchain& swapchain, Pipeline& pipeline);
+    Frames(const GraphicsContext& device, Swapchain& swapchain);
 
     ~Frames();
 
     void drawFrame(); //Draw the bloody frame to the screen!
+
+    /**
+     * @brief Registers a callback run in drawFrame() as soon as a frame's fence has signalled,
+     * before anything is recorded for it. The callback receives the frame-in-flight index, and
+     * may recycle any per-frame resources the GPU was using for that frame (e.g. descriptor pools).
+     */
+    inline void addFrameResetCallback(std::function<void(uint32_t)> callback) {
+        frame_reset_callbacks.push_back(std::move(callback));
+    }
+
+    /**
+     * @brief Sets the render graph every frame is recorded from; must be called before the first
+     * drawFrame(). Every frame the graph is reset, the builder declares its passes for the acquired
+     * swapchain image index, then the graph is compiled and executed. The swapchain image must be
+     * imported with UNDEFINED, COLOR_ATTACHMENT_OUTPUT and PRESENT_SRC_KHR to match the frame's semaphores.
+     */
+    inline void setRenderGraph(RenderGraph& render_graph, std::function<void(RenderGraph&, uint32_t)> builder) {
+        this->render_graph = &render_graph;
+        render_graph_builder = std::move(builder);
+    }
+
+    /**
+     * @brief Binds the global bindless set in every frame's command buffer. All pipelines
+     * recorded by this object must then use its set layout as set 0.
+     */
+    inline void setBindlessDescriptors(const BindlessDescriptors& bindless) {
+        for (auto& command_pool : command_pools) {
+            command_pool.setBindlessDescriptors(&bindless);
+        }
+    }
+
+    /**
+     * @brief The command pool of the frame being recorded, for render graph passes to bind
+     * pipelines and draw through (command buffer 0).
+     */
+    inline CommandPool& getCommandPool() { return command_pools[current_frame]; }
+
+    /**
+     * @brief Submits the capture's copy of each presented image along with the frame, and
+     * collects it once the frame's fence has signalled.
+     */
+    inline void setFrameCapture(FrameCapture& frame_capture) { this->frame_capture = &frame_capture; }
     
 private:
     void createSyncObjs();
 
     void resetSyncObjs();
 
-    void cleanup();
+    /**
+     * @brief Rebuilds the swapchain after it went out of date, became suboptimal or the window
+     * was resized, waiting while the window is minimized. Drops the render graph's framebuffers.
+     */
+    void recreateSwapchain();
 
 
 };
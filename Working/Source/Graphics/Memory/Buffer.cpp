@@ -0,0 +1,42 @@
+#include "Buffer.hpp"
+#include "Memory.hpp"
+#include <stdexcept>
+
+Buffer::Buffer(const GraphicsContext& context, VkDeviceSize size,
+    VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) :
+    context(context),
+    memory(VK_NULL_HANDLE, {&context}),
+    buffer(VK_NULL_HANDLE, {context.getLogicalDevice()}),
+    size(size),
+    mapped(nullptr)
+{
+    VkBufferCreateInfo buffer_create_info {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = size,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE
+    };
+
+    VkBuffer created;
+    if (vkCreateBuffer(context.getLogicalDevice(), &buffer_create_info, nullptr, &created)) {
+        throw std::runtime_error("Failed to create buffer!");
+    }
+    buffer.reset(created);
+
+    VkMemoryRequirements requirements;
+    vkGetBufferMemoryRequirements(context.getLogicalDevice(), buffer, &requirements);
+
+    // Host-visible buffers that are only ever copied from or into are upload or readback staging
+    const bool transfer_only = (usage & ~(VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT)) == 0;
+    const MemoryBudget::Category category =
+        (transfer_only && (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT))
+        ? MemoryBudget::Category::Staging : MemoryBudget::Category::Buffer;
+
+    memory.reset(Memory::allocate(context, requirements, properties, category));
+
+    vkBindBufferMemory(context.getLogicalDevice(), buffer, memory, 0);
+
+    if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        vkMapMemory(context.getLogicalDevice(), memory, 0, VK_WHOLE_SIZE, 0, &mapped);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef _MEADOW_BUFFER_HPP_
+#define _MEADOW_BUFFER_HPP_
+
+#include <vulkan/vulkan.h>
+#include "GraphicsContext.hpp"
+#include "DeviceHandle.hpp"
+#include "Memory.hpp"
+
+/**
+ * @brief A VkBuffer with its own dedicated memory allocation.
+ *
+ * Host-visible buffers are persistently mapped for their whole lifetime.
+ */
+class Buffer {
+    const GraphicsContext& context;
+
+    // Declared ahead of the buffer so it is freed after the buffer is destroyed
+    MemoryHandle memory;
+    BufferHandle buffer;
+    VkDeviceSize size;
+    void* mapped;
+
+public:
+    Buffer(const GraphicsContext& context, VkDeviceSize size,
+        VkBufferUsageFlags usage, VkMemoryPropertyFlags properties);
+
+    Buffer(Buffer&&) = default;
+
+    inline operator const VkBuffer&() const { return buffer.get(); }
+
+    inline const VkBuffer& getBuffer() const { return buffer.get(); }
+
+    inline VkDeviceSize getSize() const { return size; }
+
+    /**
+     * @brief The persistent mapping, or nullptr if the memory is not host visible.
+     */
+    inline void* getMapped() const { return mapped; }
+};
+
+#endif // _MEADOW_BUFFER_HPP_
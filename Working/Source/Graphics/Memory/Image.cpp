@@ -0,0 +1,77 @@
+#include "Image.hpp"
+#include "Memory.hpp"
+#include <stdexcept>
+
+Image::Image(const GraphicsContext& context, const VkImageCreateInfo& create_info,
+    VkMemoryPropertyFlags properties) :
+    context(context),
+    memory(VK_NULL_HANDLE, {&context}),
+    image(VK_NULL_HANDLE, {context.getLogicalDevice()}),
+    format(create_info.format),
+    extent(create_info.extent),
+    mip_levels(create_info.mipLevels),
+    array_layers(create_info.arrayLayers)
+{
+    VkImage created;
+    if (vkCreateImage(context.getLogicalDevice(), &create_info, nullptr, &created)) {
+        throw std::runtime_error("Failed to create image!");
+    }
+    image.reset(created);
+
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(context.getLogicalDevice(), image, &requirements);
+
+    const MemoryBudget::Category category = (create_info.usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+        ? MemoryBudget::Category::Transient : MemoryBudget::Category::Image;
+
+    memory.reset(Memory::allocate(context, requirements, properties, category));
+
+    vkBindImageMemory(context.getLogicalDevice(), image, memory, 0);
+}
+
+VkImageView Image::createView(VkImageViewType view_type, VkImageAspectFlags aspect,
+    uint32_t base_mip_level, uint32_t level_count) const
+{
+    VkImageViewCreateInfo view_create_info {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = image,
+        .viewType = view_type,
+        .format = format,
+        .components = {
+            .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+            .a = VK_COMPONENT_SWIZZLE_IDENTITY
+        },
+        .subresourceRange = {
+            .aspectMask = aspect,
+            .baseMipLevel = base_mip_level,
+            .levelCount = level_count,
+            .baseArrayLayer = 0,
+            .layerCount = array_layers
+        }
+    };
+
+    VkImageView view;
+    if (vkCreateImageView(context.getLogicalDevice(), &view_create_info, nullptr, &view)) {
+        throw std::runtime_error("Failed to create image view!");
+    }
+    return view;
+}
+
+VkImageAspectFlags Image::aspectMask(VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_D16_UNORM:
+        case VK_FORMAT_X8_D24_UNORM_PACK32:
+        case VK_FORMAT_D32_SFLOAT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        case VK_FORMAT_S8_UINT:
+            return VK_IMAGE_ASPECT_STENCIL_BIT;
+        case VK_FORMAT_D16_UNORM_S8_UINT:
+        case VK_FORMAT_D24_UNORM_S8_UINT:
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+        default:
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
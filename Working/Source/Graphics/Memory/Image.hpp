@@ -0,0 +1,58 @@
+#ifndef _MEADOW_IMAGE_HPP_
+#define _MEADOW_IMAGE_HPP_
+
+#include <vulkan/vulkan.h>
+#include "GraphicsContext.hpp"
+#include "DeviceHandle.hpp"
+#include "Memory.hpp"
+
+/**
+ * @brief A VkImage with its own dedicated memory allocation.
+ */
+class Image {
+    const GraphicsContext& context;
+
+    // Declared ahead of the image so it is freed after the image is destroyed
+    MemoryHandle memory;
+    ImageHandle image;
+    VkFormat format;
+    VkExtent3D extent;
+    uint32_t mip_levels;
+    uint32_t array_layers;
+
+public:
+    /**
+     * @brief Creates the image described by create_info and binds memory with the given properties.
+     */
+    Image(const GraphicsContext& context, const VkImageCreateInfo& create_info,
+        VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    Image(Image&&) = default;
+
+    /**
+     * @brief Creates a view of a range of the image's mip levels over all of its layers.
+     * The caller owns the returned view.
+     */
+    VkImageView createView(VkImageViewType view_type, VkImageAspectFlags aspect,
+        uint32_t base_mip_level = 0, uint32_t level_count = VK_REMAINING_MIP_LEVELS) const;
+
+    inline operator const VkImage&() const { return image.get(); }
+
+    inline const VkImage& getImage() const { return image.get(); }
+
+    inline VkFormat getFormat() const { return format; }
+
+    inline const VkExtent3D& getExtent() const { return extent; }
+
+    inline uint32_t getMipLevels() const { return mip_levels; }
+
+    inline uint32_t getArrayLayers() const { return array_layers; }
+
+    /**
+     * @brief The aspects a view of an image with this format covers: depth and/or stencil for
+     * depth formats, color otherwise.
+     */
+    static VkImageAspectFlags aspectMask(VkFormat format);
+};
+
+#endif // _MEADOW_IMAGE_HPP_
@@ -0,0 +1,55 @@
+#include "Memory.hpp"
+#include <stdexcept>
+
+std::optional<uint32_t> Memory::findMemoryType(const VkPhysicalDevice& physical_device,
+    uint32_t type_bits, VkMemoryPropertyFlags properties)
+{
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+
+    for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++) {
+        if ((type_bits & (1u << i))
+            && (memory_properties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    return std::nullopt;
+}
+
+VkDeviceMemory Memory::allocate(const GraphicsContext& context,
+    const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+    MemoryBudget::Category category)
+{
+    std::optional<uint32_t> memory_type =
+        findMemoryType(context.getPhysicalDevice(), requirements.memoryTypeBits, properties);
+    if (!memory_type.has_value() && (properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)) {
+        memory_type = findMemoryType(context.getPhysicalDevice(), requirements.memoryTypeBits,
+            properties & ~VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+    }
+    if (!memory_type.has_value()) {
+        throw std::runtime_error("Failed to find a suitable memory type!");
+    }
+
+    VkMemoryAllocateInfo allocate_info {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = requirements.size,
+        .memoryTypeIndex = memory_type.value()
+    };
+
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(context.getLogicalDevice(), &allocate_info, nullptr, &memory)) {
+        throw std::runtime_error("Failed to allocate device memory!");
+    }
+
+    context.getMemoryBudget().track(memory, memory_type.value(), requirements.size, category);
+    return memory;
+}
+
+void Memory::free(const GraphicsContext& context, VkDeviceMemory memory) {
+    if (memory == VK_NULL_HANDLE) {
+        return;
+    }
+    context.getMemoryBudget().untrack(memory);
+    vkFreeMemory(context.getLogicalDevice(), memory, nullptr);
+}
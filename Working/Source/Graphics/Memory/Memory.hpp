@@ -0,0 +1,53 @@
+#ifndef _MEADOW_MEMORY_HPP_
+#define _MEADOW_MEMORY_HPP_
+
+#include <vulkan/vulkan.h>
+#include <optional>
+#include "GraphicsContext.hpp"
+#include "MemoryBudget.hpp"
+#include "Handle.hpp"
+
+/**
+ * @brief Helpers for allocating device memory.
+ */
+namespace Memory {
+    /**
+     * @brief Finds a memory type allowed by type_bits that has all of the requested properties.
+     *
+     * @return The memory type index, or std::nullopt if the device has no such type.
+     */
+    std::optional<uint32_t> findMemoryType(const VkPhysicalDevice& physical_device,
+        uint32_t type_bits, VkMemoryPropertyFlags properties);
+
+    /**
+     * @brief Allocates memory satisfying the given requirements. Throws if no suitable type exists.
+     *
+     * VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT is treated as a preference: devices without lazily
+     * allocated memory (most desktop GPUs) get an ordinary allocation of the remaining properties.
+     * The allocation is counted against the context's MemoryBudget under category.
+     */
+    VkDeviceMemory allocate(const GraphicsContext& context,
+        const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties,
+        MemoryBudget::Category category);
+
+    /**
+     * @brief Frees memory from allocate() and removes it from the context's MemoryBudget.
+     */
+    void free(const GraphicsContext& context, VkDeviceMemory memory);
+
+    /**
+     * @brief Frees through free(), for a Handle owning memory from allocate().
+     */
+    struct Deleter {
+        const GraphicsContext* context = nullptr;
+
+        inline void operator()(VkDeviceMemory memory) const { free(*context, memory); }
+    };
+}
+
+/**
+ * @brief Move-only owner of memory from Memory::allocate().
+ */
+using MemoryHandle = Handle<VkDeviceMemory, Memory::Deleter>;
+
+#endif // _MEADOW_MEMORY_HPP_
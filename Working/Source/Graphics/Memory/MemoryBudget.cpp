@@ -0,0 +1,150 @@
+#include "MemoryBudget.hpp"
+#include "Config.h"
+#include <algorithm>
+
+namespace {
+    // Without VK_EXT_memory_budget, assume the rest of the system leaves this much of a heap to us
+    constexpr double FALLBACK_BUDGET_FRACTION = 0.8;
+
+    constexpr double MEBIBYTE = 1024.0 * 1024.0;
+}
+
+MemoryBudget::MemoryBudget() :
+    physical_device(VK_NULL_HANDLE),
+    extension_enabled(false),
+    categories{},
+    total_allocations(0)
+{}
+
+void MemoryBudget::init(VkPhysicalDevice physical_device, bool extension_enabled) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->physical_device = physical_device;
+    this->extension_enabled = extension_enabled;
+
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+
+    type_heaps.resize(memory_properties.memoryTypeCount);
+    for (uint32_t i = 0; i < memory_properties.memoryTypeCount; i++) {
+        type_heaps[i] = memory_properties.memoryTypes[i].heapIndex;
+    }
+
+    heaps.resize(memory_properties.memoryHeapCount);
+    for (uint32_t i = 0; i < memory_properties.memoryHeapCount; i++) {
+        heaps[i] = {
+            .size = memory_properties.memoryHeaps[i].size,
+            .flags = memory_properties.memoryHeaps[i].flags,
+            .budget = (VkDeviceSize)(memory_properties.memoryHeaps[i].size * FALLBACK_BUDGET_FRACTION),
+            .usage = 0,
+            .allocated = 0
+        };
+    }
+}
+
+void MemoryBudget::track(VkDeviceMemory memory, uint32_t memory_type, VkDeviceSize size, Category category) {
+    std::lock_guard<std::mutex> lock(mutex);
+    const uint32_t heap = type_heaps[memory_type];
+    allocations[memory] = {heap, size, category};
+
+    heaps[heap].allocated += size;
+    categories[(size_t)category].bytes += size;
+    categories[(size_t)category].allocations++;
+    total_allocations++;
+}
+
+void MemoryBudget::untrack(VkDeviceMemory memory) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = allocations.find(memory);
+    if (it == allocations.end()) {
+        return;
+    }
+
+    const Allocation& allocation = it->second;
+    heaps[allocation.heap].allocated -= allocation.size;
+    categories[(size_t)allocation.category].bytes -= allocation.size;
+    categories[(size_t)allocation.category].allocations--;
+    allocations.erase(it);
+}
+
+void MemoryBudget::update() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!extension_enabled) {
+        for (auto& heap : heaps) {
+            heap.usage = heap.allocated;
+        }
+        return;
+    }
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budget_properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT
+    };
+    VkPhysicalDeviceMemoryProperties2 memory_properties {
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2,
+        .pNext = &budget_properties
+    };
+    vkGetPhysicalDeviceMemoryProperties2(physical_device, &memory_properties);
+
+    for (uint32_t i = 0; i < heaps.size(); i++) {
+        heaps[i].budget = budget_properties.heapBudget[i];
+        heaps[i].usage = budget_properties.heapUsage[i];
+    }
+}
+
+std::vector<MemoryBudget::Heap> MemoryBudget::getHeaps() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return heaps;
+}
+
+MemoryBudget::CategoryStats MemoryBudget::getCategory(Category category) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return categories[(size_t)category];
+}
+
+uint64_t MemoryBudget::getTotalAllocations() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return total_allocations;
+}
+
+float MemoryBudget::getPressure() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    float pressure = 0.0f;
+    for (const auto& heap : heaps) {
+        if (heap.budget > 0) {
+            pressure = std::max(pressure, (float)heap.usage / (float)heap.budget);
+        }
+    }
+    return pressure;
+}
+
+bool MemoryBudget::isUnderPressure() const {
+    return getPressure() > CONSTANTS::MEMORY_PRESSURE_THRESHOLD;
+}
+
+void MemoryBudget::report(std::ostream& stream) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (uint32_t i = 0; i < heaps.size(); i++) {
+        const Heap& heap = heaps[i];
+        stream << "[MEMORY] Heap " << i << ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) ? " (device local)" : "")
+            << ": " << heap.usage / MEBIBYTE << " / " << heap.budget / MEBIBYTE << " MiB used, "
+            << heap.allocated / MEBIBYTE << " MiB by the engine, " << heap.size / MEBIBYTE << " MiB total" << std::endl;
+    }
+    for (size_t i = 0; i < categories.size(); i++) {
+        stream << "[MEMORY] " << categoryName((Category)i) << ": " << categories[i].bytes / MEBIBYTE
+            << " MiB in " << categories[i].allocations << " allocations" << std::endl;
+    }
+}
+
+const char* MemoryBudget::categoryName(Category category) {
+    switch (category) {
+        case Category::Buffer:
+            return "Buffers";
+        case Category::Image:
+            return "Images";
+        case Category::Staging:
+            return "Staging";
+        case Category::Transient:
+            return "Transient";
+        default:
+            return "Unknown";
+    }
+}
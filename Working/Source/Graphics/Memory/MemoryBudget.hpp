@@ -0,0 +1,117 @@
+#ifndef _MEADOW_MEMORY_BUDGET_HPP_
+#define _MEADOW_MEMORY_BUDGET_HPP_
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <mutex>
+#include <ostream>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Tracks device memory use per heap and per category against the driver's budget.
+ *
+ * Every allocation made through Memory::allocate() is recorded here, so the engine's own
+ * usage is always known. Where VK_EXT_memory_budget is enabled, update() also fetches each
+ * heap's budget and the process-wide usage the driver sees. Without it, a heap's budget is
+ * taken as a fixed fraction of its size, and its usage as the engine's own allocations.
+ *
+ * Frames calls update() every frame and logs a report every CONSTANTS::MEMORY_REPORT_INTERVAL
+ * frames. Streaming systems check isUnderPressure() before allocating more.
+ */
+class MemoryBudget {
+public:
+    enum class Category : uint32_t {
+        Buffer,
+        Image,
+        Staging, /**< Host-visible upload sources and readback targets. */
+        Transient, /**< Render targets that only live within a frame, including render graph memory. */
+        Count
+    };
+
+    struct Heap {
+        VkDeviceSize size;
+        VkMemoryHeapFlags flags;
+        VkDeviceSize budget; /**< How much this process can use before allocations may fail or evict. */
+        VkDeviceSize usage; /**< This process's usage as the driver reports it. */
+        VkDeviceSize allocated; /**< Allocated through Memory::allocate(). */
+    };
+
+    struct CategoryStats {
+        VkDeviceSize bytes;
+        uint32_t allocations;
+    };
+
+private:
+    struct Allocation {
+        uint32_t heap;
+        VkDeviceSize size;
+        Category category;
+    };
+
+    VkPhysicalDevice physical_device;
+    bool extension_enabled;
+
+    mutable std::mutex mutex;
+    std::vector<uint32_t> type_heaps; /**< Heap of each memory type. */
+    std::vector<Heap> heaps;
+    std::array<CategoryStats, (size_t)Category::Count> categories;
+    uint64_t total_allocations;
+    std::unordered_map<VkDeviceMemory, Allocation> allocations;
+
+public:
+    MemoryBudget();
+
+    /**
+     * @param extension_enabled Whether VK_EXT_memory_budget was enabled on the device.
+     */
+    void init(VkPhysicalDevice physical_device, bool extension_enabled);
+
+    /**
+     * @brief Records an allocation. Safe to call from any thread.
+     */
+    void track(VkDeviceMemory memory, uint32_t memory_type, VkDeviceSize size, Category category);
+
+    /**
+     * @brief Forgets an allocation about to be freed. Safe to call from any thread.
+     */
+    void untrack(VkDeviceMemory memory);
+
+    /**
+     * @brief Fetches the current budget and usage of every heap from the driver.
+     */
+    void update();
+
+    /**
+     * @brief A snapshot of every heap, indexed like VkPhysicalDeviceMemoryProperties::memoryHeaps.
+     */
+    std::vector<Heap> getHeaps() const;
+
+    CategoryStats getCategory(Category category) const;
+
+    /**
+     * @brief Allocations made since init(), including those freed since.
+     */
+    uint64_t getTotalAllocations() const;
+
+    /**
+     * @brief The highest usage-to-budget ratio of any heap, as of the last update().
+     */
+    float getPressure() const;
+
+    /**
+     * @brief Whether some heap is past CONSTANTS::MEMORY_PRESSURE_THRESHOLD of its budget.
+     */
+    bool isUnderPressure() const;
+
+    inline bool isExtensionEnabled() const { return extension_enabled; }
+
+    /**
+     * @brief Writes one line per heap and one per category.
+     */
+    void report(std::ostream& stream) const;
+
+    static const char* categoryName(Category category);
+};
+
+#endif // _MEADOW_MEMORY_BUDGET_HPP_
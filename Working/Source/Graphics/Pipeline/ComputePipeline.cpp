@@ -0,0 +1,27 @@
+#include "ComputePipeline.hpp"
+#include <stdexcept>
+
+ComputePipeline::ComputePipeline(const GraphicsContext& graphics_context, const ShaderCollection& shaders,
+    const SetLayouts& set_layouts, const PushConstantRanges& push_constants) :
+    ComputePipeline::PipelineBase(graphics_context, VK_PIPELINE_BIND_POINT_COMPUTE),
+    shaders(shaders)
+{
+    if (shaders.size() != 1 || shaders[0].stage != VK_SHADER_STAGE_COMPUTE_BIT) {
+        throw std::runtime_error("Compute pipelines require exactly one compute shader");
+    }
+
+    createPipelineLayout(set_layouts, push_constants);
+
+    VkComputePipelineCreateInfo pipeline_create_info {
+        .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+        .stage = shaderStageCreateInfo(shaders[0]),
+        .layout = pipeline_layout,
+        .basePipelineHandle = VK_NULL_HANDLE,
+        .basePipelineIndex = -1
+    };
+
+    if (vkCreateComputePipelines(graphics_context.getLogicalDevice(), graphics_context.getPipelineCache(), 1, &pipeline_create_info, nullptr, &pipeline)) {
+        throw std::runtime_error("Failed to create compute pipeline");
+    }
+    owned_pipeline.reset(pipeline);
+}
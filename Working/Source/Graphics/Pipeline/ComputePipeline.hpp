@@ -0,0 +1,31 @@
+#ifndef _MEADOW_COMPUTE_PIPELINE_HPP_
+#define _MEADOW_COMPUTE_PIPELINE_HPP_
+
+#include "GraphicsContext.hpp"
+#include "Shader.hpp"
+#include "PipelineBase.hpp"
+
+/**
+ * @brief Represents a compute pipeline built from a single compute shader.
+ *
+ * Shares its layout and cache handling with the graphics Pipeline through
+ * PipelineBase, but has no viewport or render pass state.
+ */
+class ComputePipeline : public PipelineBase {
+    const ShaderCollection& shaders;
+
+public:
+    /**
+     * @brief Creates a compute pipeline.
+     *
+     * @param graphics_context The graphics context owning the device.
+     * @param shaders A collection holding exactly one VK_SHADER_STAGE_COMPUTE_BIT shader.
+     * @param set_layouts Descriptor set layouts, in set order.
+     * @param push_constants Push constant ranges, see PushConstants::range().
+     */
+    ComputePipeline(const GraphicsContext& graphics_context, const ShaderCollection& shaders,
+        const SetLayouts& set_layouts = {},
+        const PushConstantRanges& push_constants = {});
+};
+
+#endif // _MEADOW_COMPUTE_PIPELINE_HPP_
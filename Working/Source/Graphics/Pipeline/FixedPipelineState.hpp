@@ -0,0 +1,222 @@
+#ifndef _MEADOW_FIXED_PIPELINE_STATE_HPP_
+#define _MEADOW_FIXED_PIPELINE_STATE_HPP_
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <stdexcept>
+#include "PipelineDesc.hpp"
+
+/**
+ * @brief The fixed-function fields of a PipelineDesc as a literal value, from which the
+ * matching Vulkan create info structs are built by constexpr functions.
+ *
+ * Used as a template argument to PipelineTemplate, the structs are built and validated
+ * by the compiler and land in read-only data. Pipelines described at run time build the
+ * same structs on the stack instead.
+ */
+struct FixedPipelineState {
+    using DepthMode = PipelineDesc::DepthMode;
+
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPolygonMode polygon_mode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cull_mode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace front_face = VK_FRONT_FACE_CLOCKWISE;
+    bool blend = false;
+    DepthMode depth_mode = DepthMode::TestWrite;
+
+    constexpr bool operator==(const FixedPipelineState& other) const = default;
+
+    /**
+     * @brief The fields of desc this state covers.
+     */
+    static inline FixedPipelineState of(const PipelineDesc& desc) {
+        return {
+            .topology = desc.topology,
+            .polygon_mode = desc.polygon_mode,
+            .cull_mode = desc.cull_mode,
+            .front_face = desc.front_face,
+            .blend = desc.blend,
+            .depth_mode = desc.depth_mode
+        };
+    }
+
+    /**
+     * @brief Why this state can't make a pipeline, or nullptr if it can.
+     */
+    constexpr const char* error() const {
+        if (topology > VK_PRIMITIVE_TOPOLOGY_PATCH_LIST) {
+            return "Unknown primitive topology";
+        }
+        if (polygon_mode > VK_POLYGON_MODE_POINT) {
+            return "Unsupported polygon mode";
+        }
+        if (cull_mode > VK_CULL_MODE_FRONT_AND_BACK) {
+            return "Unknown cull mode";
+        }
+        if (blend && depth_mode == DepthMode::Prepass) {
+            return "A depth prepass has no color attachment to blend";
+        }
+        return nullptr;
+    }
+
+    constexpr VkPipelineInputAssemblyStateCreateInfo inputAssembly() const {
+        return {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
+            .topology = topology,
+            .primitiveRestartEnable = VK_FALSE
+        };
+    }
+
+    constexpr VkPipelineRasterizationStateCreateInfo rasterization() const {
+        return {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
+            .depthClampEnable = VK_FALSE,
+            .rasterizerDiscardEnable = VK_FALSE,
+            .polygonMode = polygon_mode,
+            .cullMode = cull_mode,
+            .frontFace = front_face,
+            .depthBiasEnable = VK_FALSE,
+            .depthBiasConstantFactor = 0.0f,
+            .lineWidth = 1.0f
+        };
+    }
+
+    constexpr VkPipelineDepthStencilStateCreateInfo depthStencil() const {
+        return {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+            .depthTestEnable = depth_mode != DepthMode::Disabled,
+            .depthWriteEnable = depth_mode == DepthMode::TestWrite || depth_mode == DepthMode::Prepass,
+            .depthCompareOp = depth_mode == DepthMode::Equal ? VK_COMPARE_OP_EQUAL : VK_COMPARE_OP_LESS,
+            .depthBoundsTestEnable = VK_FALSE,
+            .stencilTestEnable = VK_FALSE,
+            .minDepthBounds = 0.0f,
+            .maxDepthBounds = 1.0f
+        };
+    }
+
+    constexpr VkPipelineColorBlendAttachmentState blendAttachment() const {
+        return {
+            .blendEnable = blend,
+            .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
+            .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
+            .colorBlendOp = VK_BLEND_OP_ADD,
+            .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
+            .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
+            .alphaBlendOp = VK_BLEND_OP_ADD,
+            .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+        };
+    }
+
+    /**
+     * @param attachment The state from blendAttachment(), which must outlive the result.
+     */
+    constexpr VkPipelineColorBlendStateCreateInfo colorBlend(const VkPipelineColorBlendAttachmentState* attachment) const {
+        return {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
+            .logicOpEnable = VK_FALSE,
+            .logicOp = VK_LOGIC_OP_COPY,
+            .attachmentCount = depth_mode == DepthMode::Prepass ? 0u : 1u,
+            .pAttachments = attachment,
+            .blendConstants = {0.0f, 0.0f, 0.0f, 0.0f}
+        };
+    }
+};
+
+/**
+ * @brief The create info structs built from a FixedPipelineState, wherever they are stored.
+ */
+struct FixedPipelineInfo {
+    FixedPipelineState state;
+    const VkPipelineInputAssemblyStateCreateInfo* input_assembly;
+    const VkPipelineRasterizationStateCreateInfo* rasterization;
+    const VkPipelineDepthStencilStateCreateInfo* depth_stencil;
+    const VkPipelineColorBlendStateCreateInfo* color_blend;
+};
+
+namespace FixedPipeline {
+    template<VkSampleCountFlagBits Samples>
+    constexpr VkPipelineMultisampleStateCreateInfo multisampleInfo() {
+        static_assert(std::has_single_bit((uint32_t)Samples) && Samples <= VK_SAMPLE_COUNT_64_BIT,
+            "The sample count must be a single VkSampleCountFlagBits bit");
+        return {
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
+            .rasterizationSamples = Samples,
+            .sampleShadingEnable = VK_FALSE,
+            .minSampleShading = 1.0f,
+            .pSampleMask = nullptr,
+            .alphaToCoverageEnable = VK_FALSE,
+            .alphaToOneEnable = VK_FALSE
+        };
+    }
+
+    // The sample count only comes from the swapchain at run time, but has just seven values
+    inline constexpr std::array<VkPipelineMultisampleStateCreateInfo, 7> MULTISAMPLE_INFOS {
+        multisampleInfo<VK_SAMPLE_COUNT_1_BIT>(),
+        multisampleInfo<VK_SAMPLE_COUNT_2_BIT>(),
+        multisampleInfo<VK_SAMPLE_COUNT_4_BIT>(),
+        multisampleInfo<VK_SAMPLE_COUNT_8_BIT>(),
+        multisampleInfo<VK_SAMPLE_COUNT_16_BIT>(),
+        multisampleInfo<VK_SAMPLE_COUNT_32_BIT>(),
+        multisampleInfo<VK_SAMPLE_COUNT_64_BIT>()
+    };
+
+    /**
+     * @brief The read-only multisample state for a single sample count bit. Throws
+     * std::runtime_error for zero or a combination of bits.
+     */
+    constexpr const VkPipelineMultisampleStateCreateInfo& multisample(VkSampleCountFlagBits samples) {
+        if (!std::has_single_bit((uint32_t)samples) || samples > VK_SAMPLE_COUNT_64_BIT) {
+            throw std::runtime_error("Invalid pipeline sample count");
+        }
+        return MULTISAMPLE_INFOS[std::countr_zero((uint32_t)samples)];
+    }
+}
+
+/**
+ * @brief Fixed pipeline state validated and laid out at compile time.
+ *
+ * An invalid state fails the build rather than pipeline creation. Descriptions made
+ * with describe() point Pipeline at the static structs, so creating the pipeline
+ * builds none of them:
+ *
+ *     using Opaque = PipelineTemplate<FixedPipelineState{ .depth_mode = PipelineDesc::DepthMode::Equal }>;
+ *     PipelineDesc desc = Opaque::describe(Pipeline::describe(render_pass, samples, shaders));
+ */
+template<FixedPipelineState S>
+struct PipelineTemplate {
+    static_assert(S.error() == nullptr, "Invalid fixed pipeline state, see FixedPipelineState::error()");
+
+    static constexpr FixedPipelineState state = S;
+
+    static constexpr VkPipelineInputAssemblyStateCreateInfo input_assembly = S.inputAssembly();
+    static constexpr VkPipelineRasterizationStateCreateInfo rasterization = S.rasterization();
+    static constexpr VkPipelineDepthStencilStateCreateInfo depth_stencil = S.depthStencil();
+    static constexpr VkPipelineColorBlendAttachmentState blend_attachment = S.blendAttachment();
+    static constexpr VkPipelineColorBlendStateCreateInfo color_blend = S.colorBlend(&blend_attachment);
+
+    static constexpr FixedPipelineInfo info {
+        .state = S,
+        .input_assembly = &input_assembly,
+        .rasterization = &rasterization,
+        .depth_stencil = &depth_stencil,
+        .color_blend = &color_blend
+    };
+
+    /**
+     * @brief desc with its fixed-function fields replaced by this template's.
+     */
+    static inline PipelineDesc describe(PipelineDesc desc) {
+        desc.topology = S.topology;
+        desc.polygon_mode = S.polygon_mode;
+        desc.cull_mode = S.cull_mode;
+        desc.front_face = S.front_face;
+        desc.blend = S.blend;
+        desc.depth_mode = S.depth_mode;
+        desc.fixed_state = &info;
+        return desc;
+    }
+};
+
+#endif // _MEADOW_FIXED_PIPELINE_STATE_HPP_
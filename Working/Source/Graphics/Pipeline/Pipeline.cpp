@@ -1,126 +1,175 @@
 #include "Pipeline.hpp"
 #include "Config.h"
+#include "FixedPipelineState.hpp"
+#include <array>
+#include <optional>
 #include <stdexcept>
 
-Pipeline::Pipeline(
-    const GraphicsContext& graphics_context, 
-    Swapchain& swapchain, 
-    ShaderCollection& shaders,
-    bool blend) :
-    Pipeline::Viewport(swapchain.getExtent()),
-    graphics_context(graphics_context), 
-    swapchain(swapchain),
-    shaders(shaders)
-{
-    std::vector<VkPipelineShaderStageCreateInfo> shader_stages;
-    for (int i = 0; i < shaders.size; i++) {
-        VkPipelineShaderStageCreateInfo shader_stage_create_info {
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-            .stage = shaders[i].stage,
-            .module = shaders[i].shader,
-            .pName = "main"
-        };
-        shader_stages.emplace_back(shader_stage_create_info);
-    }
+namespace {
+    // Graphics pipelines have at most vertex, two tessellation, geometry and fragment shaders
+    constexpr size_t MAX_GRAPHICS_STAGES = 5;
 
-    VkPipelineDynamicStateCreateInfo dynamic_state_create_info {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-        .dynamicStateCount = (uint32_t)CONSTANTS::DYNAMIC_STATES.size(),
-        .pDynamicStates = CONSTANTS::DYNAMIC_STATES.data()
+    struct ExtendedState {
+        VkDynamicState state;
+        bool ExtendedDynamicState::* level;
     };
 
-    VkPipelineVertexInputStateCreateInfo vertex_input_state_create_info {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-        .vertexBindingDescriptionCount = 0,
-        .vertexAttributeDescriptionCount = 0
-    };
+    constexpr std::array<ExtendedState, 11> EXTENDED_DYNAMIC_STATES {{
+        { VK_DYNAMIC_STATE_CULL_MODE_EXT, &ExtendedDynamicState::state1 },
+        { VK_DYNAMIC_STATE_FRONT_FACE_EXT, &ExtendedDynamicState::state1 },
+        { VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT, &ExtendedDynamicState::state1 },
+        { VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT, &ExtendedDynamicState::state1 },
+        { VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT, &ExtendedDynamicState::state1 },
+        { VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT, &ExtendedDynamicState::state1 },
+        { VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT, &ExtendedDynamicState::state2 },
+        { VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE_EXT, &ExtendedDynamicState::state2 },
+        { VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE_EXT, &ExtendedDynamicState::state2 },
+        { VK_DYNAMIC_STATE_POLYGON_MODE_EXT, &ExtendedDynamicState::state3_polygon_mode },
+        { VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT, &ExtendedDynamicState::state3_blend_enable }
+    }};
 
-    VkPipelineInputAssemblyStateCreateInfo input_assembly_state_create_info {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO,
-        .topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
-        .primitiveRestartEnable = VK_FALSE
+    struct DynamicStates {
+        std::array<VkDynamicState, CONSTANTS::DYNAMIC_STATES.size() + EXTENDED_DYNAMIC_STATES.size()> states;
+        uint32_t count;
     };
 
-    VkPipelineRasterizationStateCreateInfo rasterization_state_create_info {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO,
-        .depthClampEnable = VK_FALSE,
-        .rasterizerDiscardEnable = VK_FALSE,
-        .polygonMode = VK_POLYGON_MODE_FILL,
-        .cullMode = VK_CULL_MODE_BACK_BIT,
-        .frontFace = VK_FRONT_FACE_CLOCKWISE,
-        .depthBiasEnable = VK_FALSE,
-        .depthBiasConstantFactor = 0.0f,
-        .lineWidth = 1.0f,
+    DynamicStates dynamicStates(const ExtendedDynamicState& extended) {
+        DynamicStates result {};
+        for (VkDynamicState state : CONSTANTS::DYNAMIC_STATES) {
+            result.states[result.count++] = state;
+        }
+        for (const auto& entry : EXTENDED_DYNAMIC_STATES) {
+            if (extended.*entry.level) {
+                result.states[result.count++] = entry.state;
+            }
+        }
+        return result;
+    }
 
-    };
+    /**
+     * @brief Fixed state built at run time, for descriptions that didn't come from a PipelineTemplate.
+     */
+    struct BuiltFixedState {
+        VkPipelineInputAssemblyStateCreateInfo input_assembly;
+        VkPipelineRasterizationStateCreateInfo rasterization;
+        VkPipelineDepthStencilStateCreateInfo depth_stencil;
+        VkPipelineColorBlendAttachmentState blend_attachment;
+        VkPipelineColorBlendStateCreateInfo color_blend;
+        FixedPipelineInfo info;
 
-    VkPipelineMultisampleStateCreateInfo multisample_state_create_info {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO,
-        .rasterizationSamples = VK_SAMPLE_COUNT_1_BIT,
-        .sampleShadingEnable = VK_FALSE,
-        .minSampleShading = 1.0f,
-        .pSampleMask = nullptr,
-        .alphaToCoverageEnable = VK_FALSE,
-        .alphaToOneEnable = VK_FALSE
-    };
+        BuiltFixedState(const FixedPipelineState& state) :
+            input_assembly(state.inputAssembly()),
+            rasterization(state.rasterization()),
+            depth_stencil(state.depthStencil()),
+            blend_attachment(state.blendAttachment()),
+            color_blend(state.colorBlend(&blend_attachment)),
+            info{state, &input_assembly, &rasterization, &depth_stencil, &color_blend}
+        {}
 
-    VkPipelineColorBlendAttachmentState color_blend_attachment_state {
-        .blendEnable = blend,
-        .srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA,
-        .dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA,
-        .colorBlendOp = VK_BLEND_OP_ADD,
-        .srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE,
-        .dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO,
-        .alphaBlendOp = VK_BLEND_OP_ADD,
-        .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT
+        BuiltFixedState(const BuiltFixedState&) = delete;
+        BuiltFixedState& operator=(const BuiltFixedState&) = delete;
     };
+}
+
+Pipeline::Pipeline(const GraphicsContext& graphics_context, const PipelineDesc& desc, VkExtent2D extent,
+    VkPipelineLayout shared_layout, VkPipeline shared_pipeline) :
+    Pipeline::PipelineBase(graphics_context, VK_PIPELINE_BIND_POINT_GRAPHICS),
+    Pipeline::Viewport(extent),
+    desc(desc)
+{
+    if (shared_pipeline != VK_NULL_HANDLE) {
+        setPipelineLayout(shared_layout, desc.push_constants);
+        setPipeline(shared_pipeline);
+        return;
+    }
 
-    VkPipelineColorBlendStateCreateInfo color_blend_state_create_info {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
-        .logicOpEnable = VK_FALSE,
-        .logicOp = VK_LOGIC_OP_COPY,
-        .attachmentCount = 1,
-        .pAttachments = &color_blend_attachment_state,
-        .blendConstants = {0.0f, 0.0f, 0.0f, 0.0f}
+    if (desc.shaders.size() > MAX_GRAPHICS_STAGES) {
+        throw std::runtime_error("Too many shader stages for a graphics pipeline");
+    }
+    std::array<VkPipelineShaderStageCreateInfo, MAX_GRAPHICS_STAGES> shader_stages;
+    for (size_t i = 0; i < desc.shaders.size(); i++) {
+        shader_stages[i] = shaderStageCreateInfo(desc.shaders[i]);
+    }
+
+    const DynamicStates dynamic_states = dynamicStates(graphics_context.getExtendedDynamicState());
+    VkPipelineDynamicStateCreateInfo dynamic_state_create_info {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+        .dynamicStateCount = dynamic_states.count,
+        .pDynamicStates = dynamic_states.states.data()
     };
 
-    VkPipelineLayoutCreateInfo pipeline_layout_create_info {
-        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount = 0,
-        .pSetLayouts = nullptr,
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges = nullptr
+    VkPipelineVertexInputStateCreateInfo vertex_input_state_create_info {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
+        .vertexBindingDescriptionCount = (uint32_t)desc.vertex_input.bindings.size(),
+        .pVertexBindingDescriptions = desc.vertex_input.bindings.data(),
+        .vertexAttributeDescriptionCount = (uint32_t)desc.vertex_input.attributes.size(),
+        .pVertexAttributeDescriptions = desc.vertex_input.attributes.data()
     };
 
-    if (vkCreatePipelineLayout(graphics_context.getLogicalDevice(), &pipeline_layout_create_info, nullptr, &pipeline_layout)) {
-        throw std::runtime_error("Failed to create pipeline layout");
+    // Templated descriptions point at structs the compiler already built; anything else,
+    // including a templated description edited since, is validated and built here
+    const FixedPipelineState state = FixedPipelineState::of(desc);
+    const FixedPipelineInfo* fixed = desc.fixed_state;
+    std::optional<BuiltFixedState> built;
+    if (fixed == nullptr || fixed->state != state) {
+        if (const char* error = state.error()) {
+            throw std::runtime_error(error);
+        }
+        fixed = &built.emplace(state).info;
+    }
+
+    if (shared_layout != VK_NULL_HANDLE) {
+        setPipelineLayout(shared_layout, desc.push_constants);
+    }
+    else {
+        createPipelineLayout(desc.set_layouts, desc.push_constants);
     }
 
     VkGraphicsPipelineCreateInfo pipeline_create_info {
         .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
-        .stageCount = (uint32_t)shader_stages.size(),
+        .stageCount = (uint32_t)desc.shaders.size(),
         .pStages = shader_stages.data(),
         .pVertexInputState = &vertex_input_state_create_info,
-        .pInputAssemblyState = &input_assembly_state_create_info,
+        .pInputAssemblyState = fixed->input_assembly,
         .pViewportState = &viewport_state_create_info,
-        .pRasterizationState = &rasterization_state_create_info,
-        .pMultisampleState = &multisample_state_create_info,
-        .pDepthStencilState = nullptr,
-        .pColorBlendState = &color_blend_state_create_info,
+        .pRasterizationState = fixed->rasterization,
+        .pMultisampleState = &FixedPipeline::multisample(desc.samples),
+        .pDepthStencilState = fixed->depth_stencil,
+        .pColorBlendState = fixed->color_blend,
         .pDynamicState = &dynamic_state_create_info,
         .layout = pipeline_layout,
-        .renderPass = swapchain.getRenderPass(),
-        .subpass = 0,
+        .renderPass = desc.render_pass,
+        .subpass = desc.subpass,
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = -1
     };
 
-    if (vkCreateGraphicsPipelines(graphics_context.getLogicalDevice(), VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &pipeline)) {
+    if (vkCreateGraphicsPipelines(graphics_context.getLogicalDevice(), graphics_context.getPipelineCache(), 1, &pipeline_create_info, nullptr, &pipeline)) {
         throw std::runtime_error("Failed to create graphics pipeline");
     }
+    owned_pipeline.reset(pipeline);
 }
 
-Pipeline::~Pipeline() {
-    vkDestroyPipeline(graphics_context.getLogicalDevice(), pipeline, nullptr);
-    vkDestroyPipelineLayout(graphics_context.getLogicalDevice(), pipeline_layout, nullptr);
-}
\ No newline at end of file
+PipelineDesc Pipeline::describe(VkRenderPass render_pass,
+    VkSampleCountFlagBits samples,
+    const ShaderCollection& shaders,
+    bool blend,
+    const SetLayouts& set_layouts,
+    DepthMode depth_mode,
+    uint32_t subpass,
+    const VertexInput& vertex_input)
+{
+    PipelineDesc desc {
+        .set_layouts = set_layouts,
+        .vertex_input = vertex_input,
+        .blend = blend,
+        .depth_mode = depth_mode,
+        .samples = samples,
+        .render_pass = render_pass,
+        .subpass = subpass
+    };
+    for (const Shader& shader : shaders) {
+        desc.shaders.push_back(shader);
+    }
+    return desc;
+}
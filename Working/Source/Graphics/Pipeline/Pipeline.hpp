@@ -3,49 +3,66 @@
 
 #include <initializer_list>
 #include "GraphicsContext.hpp"
-#include "Swapchain.hpp"
 #include "Viewport.hpp"
 #include "Shader.hpp"
+#include "PipelineBase.hpp"
+#include "VertexInput.hpp"
+#include "PipelineDesc.hpp"
 
 
 /**
  * @brief Represents a graphics pipeline used for rendering.
  * 
- * The Pipeline class inherits from the Viewport class and encapsulates the necessary
- * functionality for creating and managing a Vulkan graphics pipeline. It provides
- * methods for setting up the pipeline layout, creating the pipeline, and accessing
- * the viewport and scissor settings.
+ * The Pipeline class inherits from PipelineBase, which owns the layout and pipeline
+ * handles, and from the Viewport class. It encapsulates the necessary functionality
+ * for creating a Vulkan graphics pipeline from a PipelineDesc and accessing the
+ * viewport and scissor settings. Use a PipelineStateCache to share one pipeline
+ * between everything that describes it identically.
+ *
+ * Fixed-function state comes from a PipelineTemplate when the description was made
+ * by one, and is otherwise validated and built on the stack at creation.
+ *
+ * When the device has extended dynamic state, the states it covers are left dynamic
+ * and must be set while recording, which DynamicStateRecorder does from getDesc().
  */
-class Pipeline : public Viewport {
-    const GraphicsContext& graphics_context;
-    Swapchain& swapchain;
-
-    VkPipelineLayout pipeline_layout;
-    VkPipeline pipeline;
-
-
-    const ShaderCollection& shaders;
-
+class Pipeline : public PipelineBase, public Viewport {
 public:
+    using DepthMode = PipelineDesc::DepthMode;
 
-    Pipeline(const GraphicsContext& graphics_context, 
-        Swapchain& swapchain, 
-        ShaderCollection& shaders,
-        bool blend = false);
-
-    ~Pipeline();
+private:
+    PipelineDesc desc;
 
-    inline operator VkPipeline&() { return pipeline; }
+public:
+    /**
+     * @brief Creates the pipeline a description asks for.
+     *
+     * @param extent Initial viewport and scissor size; both are dynamic state.
+     * @param shared_layout A layout matching desc.set_layouts owned by the caller, or
+     * VK_NULL_HANDLE to create one owned by this pipeline.
+     * @param shared_pipeline A pipeline owned by the caller, compiled from a description with
+     * the same baked form, or VK_NULL_HANDLE to compile one. Requires shared_layout.
+     */
+    Pipeline(const GraphicsContext& graphics_context, const PipelineDesc& desc, VkExtent2D extent,
+        VkPipelineLayout shared_layout = VK_NULL_HANDLE, VkPipeline shared_pipeline = VK_NULL_HANDLE);
+
+    /**
+     * @brief Describes a pipeline targeting a subpass of a render pass, such as one a
+     * RenderGraph created for a raster pass.
+     */
+    static PipelineDesc describe(VkRenderPass render_pass,
+        VkSampleCountFlagBits samples,
+        const ShaderCollection& shaders,
+        bool blend = false,
+        const SetLayouts& set_layouts = {},
+        DepthMode depth_mode = DepthMode::TestWrite,
+        uint32_t subpass = 0,
+        const VertexInput& vertex_input = {});
+
+    inline const PipelineDesc& getDesc() const { return desc; }
 
     inline VkViewport& getViewport() { return viewport; }
 
     inline VkRect2D& getScissor() { return scissor; }
-
-private:
-
-    void createPipelineLayout();
-
-
 };
 
 #endif
\ No newline at end of file
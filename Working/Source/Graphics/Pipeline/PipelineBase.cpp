@@ -0,0 +1,50 @@
+#include "PipelineBase.hpp"
+#include "PushConstants.hpp"
+#include <stdexcept>
+
+PipelineBase::PipelineBase(const GraphicsContext& graphics_context, VkPipelineBindPoint bind_point) :
+    graphics_context(graphics_context),
+    pipeline_layout(VK_NULL_HANDLE),
+    pipeline(VK_NULL_HANDLE),
+    owned_layout(VK_NULL_HANDLE, {graphics_context.getLogicalDevice()}),
+    owned_pipeline(VK_NULL_HANDLE, {graphics_context.getLogicalDevice()}),
+    bind_point(bind_point)
+{}
+
+void PipelineBase::createPipelineLayout(const SetLayouts& set_layouts, const PushConstantRanges& push_constants) {
+    PushConstants::validate(graphics_context, push_constants);
+
+    VkPipelineLayoutCreateInfo pipeline_layout_create_info {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = (uint32_t)set_layouts.size(),
+        .pSetLayouts = set_layouts.data(),
+        .pushConstantRangeCount = (uint32_t)push_constants.size(),
+        .pPushConstantRanges = push_constants.data()
+    };
+
+    if (vkCreatePipelineLayout(graphics_context.getLogicalDevice(), &pipeline_layout_create_info, nullptr, &pipeline_layout)) {
+        throw std::runtime_error("Failed to create pipeline layout");
+    }
+    owned_layout.reset(pipeline_layout);
+    push_constant_ranges = push_constants;
+}
+
+void PipelineBase::setPipelineLayout(VkPipelineLayout shared_layout, const PushConstantRanges& push_constants) {
+    owned_layout.reset();
+    pipeline_layout = shared_layout;
+    push_constant_ranges = push_constants;
+}
+
+void PipelineBase::setPipeline(VkPipeline shared_pipeline) {
+    owned_pipeline.reset();
+    pipeline = shared_pipeline;
+}
+
+VkPipelineShaderStageCreateInfo PipelineBase::shaderStageCreateInfo(const Shader& shader) {
+    return VkPipelineShaderStageCreateInfo {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+        .stage = shader.stage,
+        .module = shader.shader,
+        .pName = "main"
+    };
+}
@@ -0,0 +1,82 @@
+#ifndef _MEADOW_PIPELINE_BASE_HPP_
+#define _MEADOW_PIPELINE_BASE_HPP_
+
+#include <vulkan/vulkan.h>
+#include "GraphicsContext.hpp"
+#include "DeviceHandle.hpp"
+#include "PipelineDesc.hpp"
+#include "Shader.hpp"
+
+/**
+ * @brief Common state shared by graphics and compute pipelines.
+ *
+ * Owns the VkPipelineLayout and VkPipeline handles and knows which bind point
+ * the pipeline belongs to. Derived classes are responsible for filling in
+ * `pipeline` with the appropriate vkCreate*Pipelines call, using the shared
+ * pipeline cache held by the GraphicsContext, and handing it to `owned_pipeline`.
+ */
+class PipelineBase {
+protected:
+    const GraphicsContext& graphics_context;
+
+    VkPipelineLayout pipeline_layout;
+    PushConstantRanges push_constant_ranges;
+    VkPipeline pipeline;
+
+    // Null when the layout or pipeline is shared and owned elsewhere
+    PipelineLayoutHandle owned_layout;
+    PipelineHandle owned_pipeline;
+
+    const VkPipelineBindPoint bind_point;
+
+public:
+    PipelineBase(const GraphicsContext& graphics_context, VkPipelineBindPoint bind_point);
+
+    PipelineBase(const PipelineBase&) = delete;
+    PipelineBase& operator=(const PipelineBase&) = delete;
+
+    inline operator VkPipeline&() { return pipeline; }
+
+    inline const VkPipelineLayout& getLayout() const { return pipeline_layout; }
+
+    inline VkPipelineBindPoint getBindPoint() const { return bind_point; }
+
+    /**
+     * @brief The push constant ranges the layout was created with.
+     */
+    inline const PushConstantRanges& getPushConstantRanges() const { return push_constant_ranges; }
+
+protected:
+    /**
+     * @brief Creates the pipeline layout used by this pipeline.
+     *
+     * @param set_layouts Descriptor set layouts, in set order. Pass the
+     * BindlessDescriptors layout as set 0 to use the bindless model.
+     * @param push_constants Push constant ranges, see PushConstants::range().
+     */
+    void createPipelineLayout(const SetLayouts& set_layouts, const PushConstantRanges& push_constants = {});
+
+    /**
+     * @brief Uses a layout owned elsewhere, e.g. shared through a PipelineStateCache.
+     * It is not destroyed with this pipeline.
+     *
+     * @param push_constants The push constant ranges shared_layout was created with.
+     */
+    void setPipelineLayout(VkPipelineLayout shared_layout, const PushConstantRanges& push_constants = {});
+
+    /**
+     * @brief Uses a pipeline owned elsewhere, e.g. one compiled for a description differing
+     * only in dynamic state. It is not destroyed with this object.
+     */
+    void setPipeline(VkPipeline shared_pipeline);
+
+    /**
+     * @brief Builds the shader stage create info for a single shader.
+     *
+     * @param shader The shader module and stage.
+     * @return The stage create info, using "main" as the entry point.
+     */
+    static VkPipelineShaderStageCreateInfo shaderStageCreateInfo(const Shader& shader);
+};
+
+#endif // _MEADOW_PIPELINE_BASE_HPP_
@@ -0,0 +1,137 @@
+#include "PipelineDesc.hpp"
+#include "Hash.hpp"
+#include "PushConstants.hpp"
+
+uint64_t PipelineDesc::hash() const {
+    uint64_t result = Hash::FNV_OFFSET_BASIS;
+
+    // Counts go in ahead of each list so fields can't shift from one list into the next
+    result = Hash::value((uint32_t)shaders.size(), result);
+    for (const auto& shader : shaders) {
+        result = Hash::value(shader.stage, result);
+        result = Hash::value(shader.shader, result);
+    }
+
+    result = Hash::value((uint32_t)set_layouts.size(), result);
+    for (VkDescriptorSetLayout set_layout : set_layouts) {
+        result = Hash::value(set_layout, result);
+    }
+
+    result = Hash::value((uint32_t)push_constants.size(), result);
+    for (const auto& range : push_constants) {
+        result = Hash::value(range.stageFlags, result);
+        result = Hash::value(range.offset, result);
+        result = Hash::value(range.size, result);
+    }
+
+    result = Hash::value((uint32_t)vertex_input.bindings.size(), result);
+    for (const auto& binding : vertex_input.bindings) {
+        result = Hash::value(binding.binding, result);
+        result = Hash::value(binding.stride, result);
+        result = Hash::value(binding.inputRate, result);
+    }
+
+    result = Hash::value((uint32_t)vertex_input.attributes.size(), result);
+    for (const auto& attribute : vertex_input.attributes) {
+        result = Hash::value(attribute.location, result);
+        result = Hash::value(attribute.binding, result);
+        result = Hash::value(attribute.format, result);
+        result = Hash::value(attribute.offset, result);
+    }
+
+    result = Hash::value(topology, result);
+    result = Hash::value(polygon_mode, result);
+    result = Hash::value(cull_mode, result);
+    result = Hash::value(front_face, result);
+    result = Hash::value(blend, result);
+    result = Hash::value(depth_mode, result);
+    result = Hash::value(samples, result);
+    result = Hash::value(render_pass, result);
+    result = Hash::value(subpass, result);
+    return result;
+}
+
+bool PipelineDesc::operator==(const PipelineDesc& other) const {
+    if (shaders.size() != other.shaders.size()
+        || vertex_input.bindings.size() != other.vertex_input.bindings.size()
+        || vertex_input.attributes.size() != other.vertex_input.attributes.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < shaders.size(); i++) {
+        if (shaders[i].stage != other.shaders[i].stage || shaders[i].shader != other.shaders[i].shader) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < vertex_input.bindings.size(); i++) {
+        const auto& a = vertex_input.bindings[i];
+        const auto& b = other.vertex_input.bindings[i];
+        if (a.binding != b.binding || a.stride != b.stride || a.inputRate != b.inputRate) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < vertex_input.attributes.size(); i++) {
+        const auto& a = vertex_input.attributes[i];
+        const auto& b = other.vertex_input.attributes[i];
+        if (a.location != b.location || a.binding != b.binding || a.format != b.format || a.offset != b.offset) {
+            return false;
+        }
+    }
+
+    return set_layouts == other.set_layouts
+        && PushConstants::compatible(push_constants, other.push_constants)
+        && topology == other.topology
+        && polygon_mode == other.polygon_mode
+        && cull_mode == other.cull_mode
+        && front_face == other.front_face
+        && blend == other.blend
+        && depth_mode == other.depth_mode
+        && samples == other.samples
+        && render_pass == other.render_pass
+        && subpass == other.subpass;
+}
+
+PipelineDesc PipelineDesc::baked(const ExtendedDynamicState& dynamic_state) const {
+    PipelineDesc result = *this;
+
+    if (dynamic_state.state1) {
+        result.cull_mode = VK_CULL_MODE_NONE;
+        result.front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+
+        // Only the topology class is baked; the exact topology is dynamic within it
+        switch (topology) {
+            case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+                result.topology = VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+                break;
+            case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+            case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+                result.topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+                break;
+            case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+                result.topology = VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+                break;
+            default:
+                result.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+                break;
+        }
+
+        // A prepass still differs in having no color output
+        if (depth_mode != DepthMode::Prepass) {
+            result.depth_mode = DepthMode::TestWrite;
+        }
+    }
+
+    if (dynamic_state.state3_polygon_mode) {
+        result.polygon_mode = VK_POLYGON_MODE_FILL;
+    }
+
+    if (dynamic_state.state3_blend_enable) {
+        result.blend = false;
+    }
+
+    return result;
+}
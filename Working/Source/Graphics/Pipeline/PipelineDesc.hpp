@@ -0,0 +1,86 @@
+#ifndef _MEADOW_PIPELINE_DESC_HPP_
+#define _MEADOW_PIPELINE_DESC_HPP_
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include "Shader.hpp"
+#include "SmallVector.hpp"
+#include "VertexInput.hpp"
+#include "ExtendedDynamicState.hpp"
+
+struct FixedPipelineInfo;
+
+/**
+ * @brief Descriptor set layouts in set order, inline up to a handful of sets.
+ */
+using SetLayouts = SmallVector<VkDescriptorSetLayout, 4>;
+
+/**
+ * @brief Push constant ranges, inline for the one or two ranges a layout usually has.
+ */
+using PushConstantRanges = SmallVector<VkPushConstantRange, 2>;
+
+/**
+ * @brief Everything that determines a graphics pipeline, as a plain value.
+ *
+ * Two descriptions that compare equal produce interchangeable pipelines, and
+ * hash() is stable across runs, so a description can key a PipelineStateCache.
+ * Shaders and set layouts are compared by handle; push constant ranges by value. The render pass stands in for
+ * the render target formats and sample counts: without dynamic rendering, Vulkan
+ * still needs one to create a graphics pipeline.
+ *
+ * With extended dynamic state, the raster, depth and blend fields are set while
+ * recording (see DynamicStateRecorder) rather than compiled into the pipeline.
+ */
+struct PipelineDesc {
+    /**
+     * @brief How the pipeline uses the depth attachment.
+     */
+    enum class DepthMode {
+        Disabled,   /**< No depth test or writes. */
+        TestWrite,  /**< LESS test and depth writes, for rendering without a prepass. */
+        Prepass,    /**< LESS test and depth writes with no color output, for a depth prepass. */
+        Equal       /**< EQUAL test without writes, for shading against depth laid down by the prepass.
+                         The vertex shader must compute positions exactly as the prepass did (invariant gl_Position). */
+    };
+
+    // Lists are stored inline, so filling in a description allocates nothing
+    SmallVector<Shader, 5> shaders;
+    SetLayouts set_layouts;
+    PushConstantRanges push_constants; /**< See PushConstants::range(). */
+    VertexInput vertex_input;
+
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPolygonMode polygon_mode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cull_mode = VK_CULL_MODE_BACK_BIT;
+    VkFrontFace front_face = VK_FRONT_FACE_CLOCKWISE;
+
+    bool blend = false;
+    DepthMode depth_mode = DepthMode::TestWrite;
+
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    VkRenderPass render_pass = VK_NULL_HANDLE;
+    uint32_t subpass = 0;
+
+    /**
+     * @brief Prebuilt create infos for the fixed-function fields, set by PipelineTemplate::describe().
+     * Derived from the fields above, so left out of hash() and comparisons; ignored if they no
+     * longer match.
+     */
+    const FixedPipelineInfo* fixed_state = nullptr;
+
+    /**
+     * @brief Stable 64-bit hash of every field.
+     */
+    uint64_t hash() const;
+
+    bool operator==(const PipelineDesc& other) const;
+
+    /**
+     * @brief This description with every field the device sets dynamically replaced by a fixed
+     * value. Descriptions whose baked forms are equal can share one VkPipeline.
+     */
+    PipelineDesc baked(const ExtendedDynamicState& dynamic_state) const;
+};
+
+#endif // _MEADOW_PIPELINE_DESC_HPP_
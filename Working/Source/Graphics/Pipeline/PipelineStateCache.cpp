@@ -0,0 +1,99 @@
+#include "PipelineStateCache.hpp"
+#include "Hash.hpp"
+#include "PushConstants.hpp"
+#include <stdexcept>
+
+PipelineStateCache::PipelineStateCache(const GraphicsContext& context, VkExtent2D extent) :
+    context(context),
+    extent(extent),
+    pipeline_count(0),
+    compiled_count(0),
+    hits(0),
+    misses(0)
+{}
+
+PipelineStateCache::~PipelineStateCache() {
+    clear();
+}
+
+Pipeline& PipelineStateCache::get(const PipelineDesc& desc) {
+    std::vector<std::unique_ptr<Pipeline>>& bucket = pipelines[desc.hash()];
+    for (const auto& cached : bucket) {
+        if (cached->getDesc() == desc) {
+            hits++;
+            return *cached;
+        }
+    }
+
+    misses++;
+    pipeline_count++;
+    VkPipelineLayout layout = getLayout(desc.set_layouts, desc.push_constants);
+
+    // A description differing only in dynamic state reuses the compiled pipeline
+    PipelineDesc baked = desc.baked(context.getExtendedDynamicState());
+    std::vector<CompiledPipeline>& compiled_bucket = compiled[baked.hash()];
+    for (const auto& existing : compiled_bucket) {
+        if (existing.baked == baked) {
+            bucket.push_back(std::make_unique<Pipeline>(context, desc, extent, layout, existing.pipeline));
+            return *bucket.back();
+        }
+    }
+
+    bucket.push_back(std::make_unique<Pipeline>(context, desc, extent, layout));
+    compiled_bucket.push_back({std::move(baked), *bucket.back()});
+    compiled_count++;
+    return *bucket.back();
+}
+
+VkPipelineLayout PipelineStateCache::getLayout(const SetLayouts& set_layouts, const PushConstantRanges& push_constants) {
+    uint64_t hash = Hash::value((uint32_t)set_layouts.size());
+    for (VkDescriptorSetLayout set_layout : set_layouts) {
+        hash = Hash::value(set_layout, hash);
+    }
+    hash = Hash::value((uint32_t)push_constants.size(), hash);
+    for (const auto& range : push_constants) {
+        hash = Hash::value(range.stageFlags, hash);
+        hash = Hash::value(range.offset, hash);
+        hash = Hash::value(range.size, hash);
+    }
+
+    std::vector<CachedLayout>& bucket = layouts[hash];
+    for (const auto& cached : bucket) {
+        if (cached.set_layouts == set_layouts && PushConstants::compatible(cached.push_constants, push_constants)) {
+            return cached.layout;
+        }
+    }
+
+    PushConstants::validate(context, push_constants);
+
+    VkPipelineLayoutCreateInfo pipeline_layout_create_info {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount = (uint32_t)set_layouts.size(),
+        .pSetLayouts = set_layouts.data(),
+        .pushConstantRangeCount = (uint32_t)push_constants.size(),
+        .pPushConstantRanges = push_constants.data()
+    };
+
+    VkPipelineLayout layout;
+    if (vkCreatePipelineLayout(context.getLogicalDevice(), &pipeline_layout_create_info, nullptr, &layout)) {
+        throw std::runtime_error("Failed to create pipeline layout");
+    }
+
+    bucket.push_back({set_layouts, push_constants, layout});
+    return layout;
+}
+
+void PipelineStateCache::clear() {
+    // Pipelines first; they don't own the shared layouts
+    pipelines.clear();
+    compiled.clear();
+    pipeline_count = 0;
+    compiled_count = 0;
+
+    for (const auto& [hash, bucket] : layouts) {
+        for (const auto& cached : bucket) {
+            vkDestroyPipelineLayout(context.getLogicalDevice(), cached.layout, nullptr);
+        }
+    }
+    layouts.clear();
+}
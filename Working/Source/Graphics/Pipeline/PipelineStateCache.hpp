@@ -0,0 +1,100 @@
+#ifndef _MEADOW_PIPELINE_STATE_CACHE_HPP_
+#define _MEADOW_PIPELINE_STATE_CACHE_HPP_
+
+#include <vulkan/vulkan.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "GraphicsContext.hpp"
+#include "Pipeline.hpp"
+#include "PipelineDesc.hpp"
+
+/**
+ * @brief Deduplicates graphics pipelines by their PipelineDesc.
+ *
+ * get() hashes the description and returns the pipeline already built for an
+ * equal one, so only the first request for a given state pays for a driver
+ * compile. Pipeline layouts are deduplicated the same way by their set layouts
+ * and push constant ranges, and shared by every cached pipeline that uses them.
+ *
+ * With extended dynamic state, descriptions that differ only in dynamic fields
+ * (see PipelineDesc::baked()) get their own Pipeline object, carrying the state to
+ * set while recording, but share a single compiled VkPipeline.
+ *
+ * Not to be confused with the VkPipelineCache held by the GraphicsContext, which
+ * still speeds up the compiles that do happen.
+ */
+class PipelineStateCache {
+    struct CompiledPipeline {
+        PipelineDesc baked;
+        VkPipeline pipeline;
+    };
+
+    struct CachedLayout {
+        SetLayouts set_layouts;
+        PushConstantRanges push_constants;
+        VkPipelineLayout layout;
+    };
+
+    const GraphicsContext& context;
+    VkExtent2D extent;
+
+    // Buckets hold every description that hashed alike, so collisions only cost a comparison
+    std::unordered_map<uint64_t, std::vector<std::unique_ptr<Pipeline>>> pipelines;
+    std::unordered_map<uint64_t, std::vector<CompiledPipeline>> compiled;
+    std::unordered_map<uint64_t, std::vector<CachedLayout>> layouts;
+
+    uint32_t pipeline_count;
+    uint32_t compiled_count;
+    uint32_t hits;
+    uint32_t misses;
+
+public:
+    /**
+     * @param extent Initial viewport and scissor of the created pipelines; both are dynamic state.
+     */
+    PipelineStateCache(const GraphicsContext& context, VkExtent2D extent);
+
+    ~PipelineStateCache();
+
+    PipelineStateCache(const PipelineStateCache&) = delete;
+    PipelineStateCache& operator=(const PipelineStateCache&) = delete;
+
+    /**
+     * @brief Returns the pipeline for a description, creating it on first use. The
+     * reference stays valid until clear() or the cache is destroyed.
+     */
+    Pipeline& get(const PipelineDesc& desc);
+
+    /**
+     * @brief Returns the pipeline layout for a list of set layouts and push constant ranges,
+     * creating it on first use.
+     */
+    VkPipelineLayout getLayout(const SetLayouts& set_layouts, const PushConstantRanges& push_constants = {});
+
+    /**
+     * @brief Destroys every cached pipeline and layout, e.g. after the render passes they
+     * were built against were recreated. The GPU must no longer be using them.
+     */
+    void clear();
+
+    inline uint32_t getCount() const { return pipeline_count; }
+
+    /**
+     * @brief How many VkPipelines were actually compiled; lower than getCount() when
+     * descriptions differ only in dynamic state.
+     */
+    inline uint32_t getCompiledCount() const { return compiled_count; }
+
+    /**
+     * @brief How many get() calls returned an existing pipeline.
+     */
+    inline uint32_t getHits() const { return hits; }
+
+    /**
+     * @brief How many get() calls had to create a pipeline.
+     */
+    inline uint32_t getMisses() const { return misses; }
+};
+
+#endif // _MEADOW_PIPELINE_STATE_CACHE_HPP_
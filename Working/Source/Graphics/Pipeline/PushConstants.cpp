@@ -0,0 +1,33 @@
+#include "PushConstants.hpp"
+#include <stdexcept>
+
+bool PushConstants::compatible(const PushConstantRanges& a, const PushConstantRanges& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < a.size(); i++) {
+        if (a[i].stageFlags != b[i].stageFlags || a[i].offset != b[i].offset || a[i].size != b[i].size) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void PushConstants::validate(const GraphicsContext& context, const PushConstantRanges& ranges) {
+    if (ranges.empty()) {
+        return;
+    }
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(context.getPhysicalDevice(), &properties);
+
+    for (const auto& range : ranges) {
+        if (range.offset % 4 != 0 || range.size == 0 || range.size % 4 != 0) {
+            throw std::runtime_error("Push constant ranges must be made of 4-byte words");
+        }
+        if (range.offset + range.size > properties.limits.maxPushConstantsSize) {
+            throw std::runtime_error("Push constant range exceeds the device's maxPushConstantsSize");
+        }
+    }
+}
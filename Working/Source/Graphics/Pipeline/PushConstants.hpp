@@ -0,0 +1,51 @@
+#ifndef _MEADOW_PUSH_CONSTANTS_HPP_
+#define _MEADOW_PUSH_CONSTANTS_HPP_
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <type_traits>
+#include "GraphicsContext.hpp"
+#include "PipelineDesc.hpp"
+
+/**
+ * @brief Typed push constant ranges for pipeline layouts.
+ *
+ * Push constants reach shaders without a descriptor, which suits small per-draw
+ * values such as an object index or a material id. Vulkan keeps pushed values
+ * across pipeline binds as long as the layouts were created with identical push
+ * constant ranges, so pipelines meant to share per-draw data should declare the
+ * same ranges; PipelineStateCache then hands them the same layout outright.
+ */
+namespace PushConstants {
+    /**
+     * @brief Bytes every Vulkan implementation supports; larger ranges are checked
+     * against the device limit when the layout is created.
+     */
+    constexpr uint32_t GUARANTEED_SIZE = 128;
+
+    /**
+     * @brief The range holding one T at offset, visible to stages.
+     */
+    template<typename T>
+    constexpr VkPushConstantRange range(VkShaderStageFlags stages, uint32_t offset = 0) {
+        static_assert(std::is_trivially_copyable_v<T>, "Push constants are copied byte for byte");
+        static_assert(sizeof(T) % 4 == 0, "Push constant ranges are made of 4-byte words");
+        return {
+            .stageFlags = stages,
+            .offset = offset,
+            .size = (uint32_t)sizeof(T)
+        };
+    }
+
+    /**
+     * @brief Whether layouts with these ranges keep each other's pushed values across binds.
+     */
+    bool compatible(const PushConstantRanges& a, const PushConstantRanges& b);
+
+    /**
+     * @brief Throws if a range is misaligned or runs past the device's maxPushConstantsSize.
+     */
+    void validate(const GraphicsContext& context, const PushConstantRanges& ranges);
+}
+
+#endif // _MEADOW_PUSH_CONSTANTS_HPP_
@@ -3,47 +3,32 @@
 #include <fstream>
 #include <stdexcept>
 #include <vector>
-#include <iostream>
 
-Shader Shader::create(
-    const char* filename, 
-    const VkDevice& device, 
-    VkShaderStageFlagBits stage)
-{
-
-    Shader shader;
-
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) {
-        throw std::runtime_error("Failed to open file");
-    }
-    std::vector<char> code {std::istreambuf_iterator<char>(file), 
-        std::istreambuf_iterator<char>() };
+ShaderCollection::ShaderCollection(VkDevice device) : device(device) {}
 
+const Shader& ShaderCollection::add(const std::vector<char>& code, VkShaderStageFlagBits stage) {
     VkShaderModuleCreateInfo shader_create_info {
         .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
         .codeSize = code.size(),
         .pCode = reinterpret_cast<const uint32_t*>(code.data())
     };
-    if (vkCreateShaderModule(device, &shader_create_info, nullptr, &shader.shader)) {
+
+    VkShaderModule module;
+    if (vkCreateShaderModule(device, &shader_create_info, nullptr, &module)) {
         throw std::runtime_error("Failed to create shader module");
     }
+    modules.emplace_back(module, ShaderModuleHandle::deleter_type{device});
 
-    shader.device = &device;
-
-    shader.stage = stage;
-
-    return shader;
+    return shaders.emplace_back(Shader{ .shader = module, .stage = stage });
 }
 
-void Shader::destroy(const VkShaderModule& shader, const VkDevice& device) {
-    vkDestroyShaderModule(device, shader, nullptr);
-}
-
-ShaderCollection::ShaderCollection(int size) : collection(size) {}
-
-ShaderCollection::~ShaderCollection() {
-    for (int i = 0; i < size; i++) {
-        Shader::destroy(data[i].shader, *data[i].device);
+const Shader& ShaderCollection::load(const char* filename, VkShaderStageFlagBits stage) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file");
     }
-}
\ No newline at end of file
+    std::vector<char> code {std::istreambuf_iterator<char>(file), 
+        std::istreambuf_iterator<char>() };
+
+    return add(code, stage);
+}
@@ -2,74 +2,71 @@
 #define MEADOW_SHADER_HPP
 
 #include <vulkan/vulkan.h>
-#include <memory>
-#include "collection.hpp"
+#include <vector>
+#include "DeviceHandle.hpp"
+#include "SmallVector.hpp"
+
 /**
- * @brief Represents a shader module in Vulkan.
+ * @brief A shader module and the stage it runs in.
+ *
+ * Refers to a module owned by a ShaderCollection without owning it, so it can be
+ * copied into pipeline descriptions and compared by handle.
  */
 struct Shader {
     VkShaderModule shader; /**< The Vulkan shader module. */
     VkShaderStageFlagBits stage; /**< The stage of the shader. */
-    const VkDevice* device; /**< Pointer to the Vulkan device. */
+};
 
-    /**
-     * @brief Default constructor for Shader.
-     */
-    Shader() = default;
+/**
+ * @brief Owns the shader modules of a pipeline.
+ *
+ * Holds a handful of shaders inline, so a collection costs no allocation, and is
+ * move-only: the modules are destroyed with the collection they were loaded into.
+ */
+class ShaderCollection {
+    // Vertex, two tessellation, geometry and fragment
+    static constexpr size_t INLINE_SHADERS = 5;
 
+    VkDevice device;
+    SmallVector<ShaderModuleHandle, INLINE_SHADERS> modules;
+    SmallVector<Shader, INLINE_SHADERS> shaders;
+
+public:
     /**
-     * @brief Creates a shader module from a file.
-     * 
-     * @param filename The name of the file containing the shader code.
-     * @param device The Vulkan device.
-     * @param stage The stage of the shader.
-     * @return The created Shader object.
+     * @param device The device the shader modules are created on.
      */
-    static Shader create(const char* filename, const VkDevice& device, VkShaderStageFlagBits stage);
+    explicit ShaderCollection(VkDevice device);
+
+    ShaderCollection(ShaderCollection&&) = default;
+    ShaderCollection& operator=(ShaderCollection&&) = default;
 
     /**
-     * @brief Destroys a shader module.
+     * @brief Creates a shader module from SPIR-V already in memory, e.g. read through AsyncIO.
      * 
-     * @param shader The shader module to destroy.
-     * @param device The Vulkan device.
+     * @param code The SPIR-V words, as raw bytes.
+     * @param stage The stage of the shader.
+     * @return The added shader.
      */
-    static void destroy(const VkShaderModule& shader, const VkDevice& device);
-};
+    const Shader& add(const std::vector<char>& code, VkShaderStageFlagBits stage);
 
-/**
- * @brief A collection of Shader objects.
- * 
- * This class represents a collection of Shader objects. It inherits from the collection class and provides
- * additional functionality specific to shaders, specifically in regards to destruction.
- */
-class ShaderCollection : public collection<Shader> {
-public:
     /**
-     * @brief Constructs a ShaderCollection object with the specified size.
+     * @brief Creates a shader module from a SPIR-V file.
      * 
-     * @param size The size of the ShaderCollection.
+     * @param filename The name of the file containing the shader code.
+     * @param stage The stage of the shader.
+     * @return The added shader.
      */
-    ShaderCollection(int size);
+    const Shader& load(const char* filename, VkShaderStageFlagBits stage);
 
-    /**
-     * @brief Destructor for the ShaderCollection object.
-     */
-    ~ShaderCollection();
-};
+    inline size_t size() const { return shaders.size(); }
 
-// class Shader {
-//     VkShaderModule shader;
+    inline const Shader* data() const { return shaders.data(); }
 
-//     VkShaderStageFlagBits stage;
+    inline const Shader& operator[](size_t index) const { return shaders[index]; }
 
-//     const VkDevice& device;
+    inline const Shader* begin() const { return shaders.begin(); }
 
-// public:
-//     Shader(const char* filename, const VkDevice& device, VkShaderStageFlagBits stage);
-//     ~Shader();
-    
-//     inline const VkShaderStageFlagBits& getStage() { return stage; }
+    inline const Shader* end() const { return shaders.end(); }
+};
 
-//     inline operator VkShaderModule&() { return shader; }
-// };
-#endif // MEADOW_SHADER_HPP
\ No newline at end of file
+#endif // MEADOW_SHADER_HPP
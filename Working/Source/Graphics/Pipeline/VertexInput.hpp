@@ -0,0 +1,16 @@
+#ifndef _MEADOW_VERTEX_INPUT_HPP_
+#define _MEADOW_VERTEX_INPUT_HPP_
+
+#include <vulkan/vulkan.h>
+#include "SmallVector.hpp"
+
+/**
+ * @brief The vertex buffer bindings and attributes a pipeline reads.
+ * Empty for pipelines that generate their vertices in the shader.
+ */
+struct VertexInput {
+    SmallVector<VkVertexInputBindingDescription, 4> bindings;
+    SmallVector<VkVertexInputAttributeDescription, 8> attributes;
+};
+
+#endif // _MEADOW_VERTEX_INPUT_HPP_
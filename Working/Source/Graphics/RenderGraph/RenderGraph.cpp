@@ -0,0 +1,894 @@
+#include "RenderGraph.hpp"
+#include "Hash.hpp"
+#include "Image.hpp"
+#include "Memory.hpp"
+#include <algorithm>
+#include <memory_resource>
+#include <stdexcept>
+
+namespace {
+    struct AccessInfo {
+        VkImageLayout layout;
+        VkPipelineStageFlags stages;
+        VkAccessFlags access;
+        bool write;
+        VkImageUsageFlags usage;
+    };
+
+    AccessInfo accessInfo(RenderGraph::Access access, RenderGraph::PassType type) {
+        using Access = RenderGraph::Access;
+
+        const VkPipelineStageFlags shader_stages = type == RenderGraph::PassType::Compute
+            ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+            : VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+        const VkPipelineStageFlags depth_stages =
+            VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+
+        switch (access) {
+            case Access::ColorAttachment:
+                return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, true,
+                    VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT };
+            case Access::ResolveAttachment:
+                return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+                    VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT, true, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT };
+            case Access::DepthAttachment:
+                return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, depth_stages,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT, true,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+            case Access::DepthRead:
+                return { VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL, depth_stages,
+                    VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, false,
+                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT };
+            case Access::Sampled:
+                return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, shader_stages,
+                    VK_ACCESS_SHADER_READ_BIT, false, VK_IMAGE_USAGE_SAMPLED_BIT };
+            case Access::StorageRead:
+                return { VK_IMAGE_LAYOUT_GENERAL, shader_stages,
+                    VK_ACCESS_SHADER_READ_BIT, false, VK_IMAGE_USAGE_STORAGE_BIT };
+            case Access::StorageWrite:
+                return { VK_IMAGE_LAYOUT_GENERAL, shader_stages,
+                    VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT, true, VK_IMAGE_USAGE_STORAGE_BIT };
+            case Access::IndirectRead:
+                return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT,
+                    VK_ACCESS_INDIRECT_COMMAND_READ_BIT, false, 0 };
+            case Access::TransferRead:
+                return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_ACCESS_TRANSFER_READ_BIT, false, VK_IMAGE_USAGE_TRANSFER_SRC_BIT };
+            case Access::TransferWrite:
+                return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                    VK_ACCESS_TRANSFER_WRITE_BIT, true, VK_IMAGE_USAGE_TRANSFER_DST_BIT };
+        }
+        return {};
+    }
+
+    bool isAttachment(RenderGraph::Access access) {
+        return access == RenderGraph::Access::ColorAttachment
+            || access == RenderGraph::Access::ResolveAttachment
+            || access == RenderGraph::Access::DepthAttachment
+            || access == RenderGraph::Access::DepthRead;
+    }
+
+    // Synchronization state of a resource while walking the live passes
+    struct ResourceState {
+        VkImageLayout layout;
+        VkPipelineStageFlags write_stages;
+        VkAccessFlags write_access;
+        VkPipelineStageFlags read_stages;
+        VkPipelineStageFlags visible_stages;
+    };
+}
+
+//#region <PassBuilder>
+    RenderGraph::ResourceHandle RenderGraph::PassBuilder::createTexture(const char* name, const TextureDesc& desc) {
+        return graph.createTexture(name, desc);
+    }
+
+    void RenderGraph::PassBuilder::writeColor(ResourceHandle resource, std::optional<VkClearColorValue> clear) {
+        std::optional<VkClearValue> clear_value;
+        if (clear) {
+            clear_value = VkClearValue { .color = *clear };
+        }
+        graph.addUsage(pass, resource, Access::ColorAttachment, clear_value);
+    }
+
+    void RenderGraph::PassBuilder::resolveColor(ResourceHandle source, ResourceHandle target) {
+        graph.addUsage(pass, target, Access::ResolveAttachment, std::nullopt, source);
+    }
+
+    void RenderGraph::PassBuilder::writeDepth(ResourceHandle resource, std::optional<VkClearDepthStencilValue> clear) {
+        std::optional<VkClearValue> clear_value;
+        if (clear) {
+            clear_value = VkClearValue { .depthStencil = *clear };
+        }
+        graph.addUsage(pass, resource, Access::DepthAttachment, clear_value);
+    }
+
+    void RenderGraph::PassBuilder::readDepth(ResourceHandle resource) { graph.addUsage(pass, resource, Access::DepthRead); }
+
+    void RenderGraph::PassBuilder::readTexture(ResourceHandle resource) { graph.addUsage(pass, resource, Access::Sampled); }
+
+    void RenderGraph::PassBuilder::readStorage(ResourceHandle resource) { graph.addUsage(pass, resource, Access::StorageRead); }
+
+    void RenderGraph::PassBuilder::writeStorage(ResourceHandle resource) { graph.addUsage(pass, resource, Access::StorageWrite); }
+
+    void RenderGraph::PassBuilder::readIndirect(ResourceHandle resource) { graph.addUsage(pass, resource, Access::IndirectRead); }
+
+    void RenderGraph::PassBuilder::readTransfer(ResourceHandle resource) { graph.addUsage(pass, resource, Access::TransferRead); }
+
+    void RenderGraph::PassBuilder::writeTransfer(ResourceHandle resource) { graph.addUsage(pass, resource, Access::TransferWrite); }
+
+    void RenderGraph::PassBuilder::setSideEffects() { graph.passes[pass].side_effects = true; }
+//#endregion
+
+RenderGraph::RenderGraph(const GraphicsContext& context) :
+    context(context),
+    compiled_hash(0),
+    final_src_stages(0)
+{}
+
+RenderGraph::~RenderGraph() {
+    destroyCompiled();
+}
+
+void RenderGraph::reset() {
+    resources.clear();
+    passes.clear();
+}
+
+RenderGraph::ResourceHandle RenderGraph::importImage(const char* name, VkImage image, VkImageView view, const TextureDesc& desc,
+    VkImageLayout initial_layout, VkPipelineStageFlags initial_stage, VkImageLayout final_layout)
+{
+    return addResource({
+        .name = name,
+        .imported = true,
+        .is_buffer = false,
+        .output = true,
+        .desc = desc,
+        .usage = 0,
+        .image = image,
+        .view = view,
+        .buffer = VK_NULL_HANDLE,
+        .initial_layout = initial_layout,
+        .initial_stage = initial_stage,
+        .final_layout = final_layout
+    });
+}
+
+RenderGraph::ResourceHandle RenderGraph::createTexture(const char* name, const TextureDesc& desc) {
+    return addResource({
+        .name = name,
+        .imported = false,
+        .is_buffer = false,
+        .output = false,
+        .desc = desc,
+        .usage = 0,
+        .image = VK_NULL_HANDLE,
+        .view = VK_NULL_HANDLE,
+        .buffer = VK_NULL_HANDLE,
+        .initial_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .initial_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        .final_layout = VK_IMAGE_LAYOUT_UNDEFINED
+    });
+}
+
+RenderGraph::ResourceHandle RenderGraph::importBuffer(const char* name, VkBuffer buffer) {
+    return addResource({
+        .name = name,
+        .imported = true,
+        .is_buffer = true,
+        .output = true,
+        .desc = {},
+        .usage = 0,
+        .image = VK_NULL_HANDLE,
+        .view = VK_NULL_HANDLE,
+        .buffer = buffer,
+        .initial_layout = VK_IMAGE_LAYOUT_UNDEFINED,
+        .initial_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        .final_layout = VK_IMAGE_LAYOUT_UNDEFINED
+    });
+}
+
+void RenderGraph::markOutput(ResourceHandle resource) {
+    resources[resource].output = true;
+}
+
+void RenderGraph::addPass(const char* name, PassType type,
+    const std::function<void(PassBuilder&)>& setup, ExecuteFunction execute)
+{
+    passes.push_back({
+        .name = name,
+        .type = type,
+        .usages = {},
+        .execute = std::move(execute),
+        .side_effects = false
+    });
+
+    PassBuilder builder(*this, (uint32_t)passes.size() - 1);
+    setup(builder);
+}
+
+RenderGraph::ResourceHandle RenderGraph::addResource(Resource resource) {
+    resources.push_back(std::move(resource));
+    return (ResourceHandle)resources.size() - 1;
+}
+
+void RenderGraph::addUsage(uint32_t pass, ResourceHandle resource, Access access, std::optional<VkClearValue> clear,
+    ResourceHandle source)
+{
+    passes[pass].usages.push_back({resource, access, clear, source});
+    resources[resource].usage |= accessInfo(access, passes[pass].type).usage;
+}
+
+void RenderGraph::compile() {
+    uint64_t hash = hashTopology();
+    if (hash == compiled_hash && !compiled_passes.empty()) {
+        return;
+    }
+
+    destroyCompiled();
+    compiled_hash = hash;
+
+    std::vector<bool> live = cullPasses();
+    std::vector<uint32_t> live_passes;
+    for (uint32_t i = 0; i < passes.size(); i++) {
+        if (live[i]) {
+            live_passes.push_back(i);
+        }
+    }
+
+    compiled_passes.resize(live_passes.size());
+    for (uint32_t i = 0; i < live_passes.size(); i++) {
+        compiled_passes[i] = {
+            .pass = live_passes[i],
+            .src_stages = 0,
+            .dst_stages = 0,
+            .barriers = {},
+            .render_pass = VK_NULL_HANDLE,
+            .attachments = {},
+            .clear_values = {},
+            .extent = {0, 0}
+        };
+    }
+
+    allocateTransients(live_passes);
+    computeBarriers();
+    createRenderPasses();
+}
+
+void RenderGraph::execute(VkCommandBuffer command_buffer) {
+    auto image_of = [this](ResourceHandle resource) {
+        return resources[resource].imported ? resources[resource].image : transient_images[resource];
+    };
+
+    auto record_barriers = [&](const std::vector<Barrier>& barriers, VkPipelineStageFlags src_stages, VkPipelineStageFlags dst_stages) {
+        if (src_stages == 0) {
+            return;
+        }
+
+        std::pmr::vector<VkImageMemoryBarrier> image_barriers(&context.getFrameAllocator().get());
+        std::pmr::vector<VkBufferMemoryBarrier> buffer_barriers(&context.getFrameAllocator().get());
+        for (const auto& barrier : barriers) {
+            const Resource& resource = resources[barrier.resource];
+            if (resource.is_buffer) {
+                buffer_barriers.push_back({
+                    .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+                    .srcAccessMask = barrier.src_access,
+                    .dstAccessMask = barrier.dst_access,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .buffer = resource.buffer,
+                    .offset = 0,
+                    .size = VK_WHOLE_SIZE
+                });
+            }
+            else {
+                image_barriers.push_back({
+                    .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                    .srcAccessMask = barrier.src_access,
+                    .dstAccessMask = barrier.dst_access,
+                    .oldLayout = barrier.old_layout,
+                    .newLayout = barrier.new_layout,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .image = image_of(barrier.resource),
+                    .subresourceRange = {
+                        .aspectMask = Image::aspectMask(resource.desc.format),
+                        .baseMipLevel = 0,
+                        .levelCount = VK_REMAINING_MIP_LEVELS,
+                        .baseArrayLayer = 0,
+                        .layerCount = VK_REMAINING_ARRAY_LAYERS
+                    }
+                });
+            }
+        }
+
+        vkCmdPipelineBarrier(command_buffer, src_stages, dst_stages, 0, 0, nullptr,
+            (uint32_t)buffer_barriers.size(), buffer_barriers.data(),
+            (uint32_t)image_barriers.size(), image_barriers.data());
+    };
+
+    for (auto& compiled : compiled_passes) {
+        const Pass& pass = passes[compiled.pass];
+
+        record_barriers(compiled.barriers, compiled.src_stages, compiled.dst_stages);
+
+        if (compiled.render_pass == VK_NULL_HANDLE) {
+            pass.execute(command_buffer);
+            continue;
+        }
+
+        // Clear values may change from frame to frame without changing the topology
+        for (uint32_t i = 0; i < compiled.attachments.size(); i++) {
+            for (const auto& usage : pass.usages) {
+                if (usage.resource == compiled.attachments[i] && usage.clear) {
+                    compiled.clear_values[i] = *usage.clear;
+                }
+            }
+        }
+
+        VkRenderPassBeginInfo render_pass_info = {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+            .renderPass = compiled.render_pass,
+            .framebuffer = getFramebuffer(compiled),
+            .renderArea = {
+                .offset = {0, 0},
+                .extent = compiled.extent
+            },
+            .clearValueCount = (uint32_t)compiled.clear_values.size(),
+            .pClearValues = compiled.clear_values.data()
+        };
+
+        vkCmdBeginRenderPass(command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
+        pass.execute(command_buffer);
+        vkCmdEndRenderPass(command_buffer);
+    }
+
+    record_barriers(final_barriers, final_src_stages, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+}
+
+VkRenderPass RenderGraph::getRenderPass(const char* pass_name) const {
+    for (const auto& compiled : compiled_passes) {
+        if (passes[compiled.pass].name == pass_name) {
+            return compiled.render_pass;
+        }
+    }
+    return VK_NULL_HANDLE;
+}
+
+VkImageView RenderGraph::getImageView(ResourceHandle resource) const {
+    return resources[resource].imported ? resources[resource].view : transient_views[resource];
+}
+
+void RenderGraph::invalidateFramebuffers() {
+    if (framebuffers.empty()) {
+        return;
+    }
+
+    std::vector<VkFramebuffer> old_framebuffers;
+    for (auto& [key, framebuffer] : framebuffers) {
+        old_framebuffers.push_back(framebuffer);
+    }
+    framebuffers.clear();
+
+    // Frames in flight may still be rendering into them
+    VkDevice device = context.getLogicalDevice();
+    context.getDeletionQueue().push([device, old_framebuffers]() {
+        for (VkFramebuffer framebuffer : old_framebuffers) {
+            vkDestroyFramebuffer(device, framebuffer, nullptr);
+        }
+    });
+}
+
+uint64_t RenderGraph::hashTopology() const {
+    uint64_t hash = Hash::value(resources.size());
+    for (const auto& resource : resources) {
+        hash = Hash::value(resource.imported, hash);
+        hash = Hash::value(resource.is_buffer, hash);
+        hash = Hash::value(resource.output, hash);
+        hash = Hash::value(resource.desc.format, hash);
+        hash = Hash::value(resource.desc.extent.width, hash);
+        hash = Hash::value(resource.desc.extent.height, hash);
+        hash = Hash::value(resource.desc.samples, hash);
+        hash = Hash::value(resource.usage, hash);
+        hash = Hash::value(resource.initial_layout, hash);
+        hash = Hash::value(resource.initial_stage, hash);
+        hash = Hash::value(resource.final_layout, hash);
+    }
+    for (const auto& pass : passes) {
+        hash = Hash::string(pass.name, hash);
+        hash = Hash::value(pass.type, hash);
+        hash = Hash::value(pass.side_effects, hash);
+        for (const auto& usage : pass.usages) {
+            hash = Hash::value(usage.resource, hash);
+            hash = Hash::value(usage.access, hash);
+            hash = Hash::value(usage.clear.has_value(), hash);
+            hash = Hash::value(usage.source, hash);
+        }
+    }
+    return hash;
+}
+
+std::vector<bool> RenderGraph::cullPasses() const {
+    // Walk backwards from the outputs. A pass is live if something still needs a resource
+    // it writes; it then needs everything it reads, including attachments it loads.
+    std::vector<bool> needed(resources.size());
+    for (uint32_t i = 0; i < resources.size(); i++) {
+        needed[i] = resources[i].output;
+    }
+
+    std::vector<bool> live(passes.size(), false);
+    for (uint32_t p = (uint32_t)passes.size(); p-- > 0;) {
+        const Pass& pass = passes[p];
+
+        bool is_live = pass.side_effects;
+        for (const auto& usage : pass.usages) {
+            if (accessInfo(usage.access, pass.type).write && needed[usage.resource]) {
+                is_live = true;
+            }
+        }
+        if (!is_live) {
+            continue;
+        }
+        live[p] = true;
+
+        // Attachments cleared by this pass don't depend on earlier writers
+        for (const auto& usage : pass.usages) {
+            if (usage.clear) {
+                needed[usage.resource] = false;
+            }
+        }
+        for (const auto& usage : pass.usages) {
+            if (!usage.clear) {
+                needed[usage.resource] = true;
+            }
+        }
+    }
+
+    return live;
+}
+
+void RenderGraph::allocateTransients(const std::vector<uint32_t>& live_passes) {
+    transient_images.assign(resources.size(), VK_NULL_HANDLE);
+    transient_views.assign(resources.size(), VK_NULL_HANDLE);
+
+    // Lifetimes, in live pass indices
+    std::vector<uint32_t> first_use(resources.size(), UINT32_MAX);
+    std::vector<uint32_t> last_use(resources.size(), 0);
+    for (uint32_t i = 0; i < live_passes.size(); i++) {
+        for (const auto& usage : passes[live_passes[i]].usages) {
+            first_use[usage.resource] = std::min(first_use[usage.resource], i);
+            last_use[usage.resource] = std::max(last_use[usage.resource], i);
+        }
+    }
+
+    struct Transient {
+        ResourceHandle resource;
+        VkMemoryRequirements requirements;
+    };
+    std::vector<Transient> transients;
+
+    for (ResourceHandle r = 0; r < resources.size(); r++) {
+        const Resource& resource = resources[r];
+        if (resource.imported || first_use[r] == UINT32_MAX) {
+            continue;
+        }
+
+        VkImageCreateInfo image_create_info {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+            .imageType = VK_IMAGE_TYPE_2D,
+            .format = resource.desc.format,
+            .extent = { resource.desc.extent.width, resource.desc.extent.height, 1 },
+            .mipLevels = 1,
+            .arrayLayers = 1,
+            .samples = resource.desc.samples,
+            .tiling = VK_IMAGE_TILING_OPTIMAL,
+            .usage = resource.usage,
+            .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+            .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+        };
+
+        if (vkCreateImage(context.getLogicalDevice(), &image_create_info, nullptr, &transient_images[r])) {
+            throw std::runtime_error("Failed to create transient image!");
+        }
+
+        Transient transient { r, {} };
+        vkGetImageMemoryRequirements(context.getLogicalDevice(), transient_images[r], &transient.requirements);
+        transients.push_back(transient);
+    }
+
+    // Greedy interval packing: biggest first, into the first block whose occupants' lifetimes
+    // don't overlap this one and whose memory types are compatible
+    std::sort(transients.begin(), transients.end(), [](const Transient& a, const Transient& b) {
+        return a.requirements.size > b.requirements.size;
+    });
+
+    std::vector<std::vector<std::pair<uint32_t, uint32_t>>> block_lifetimes;
+    std::vector<VkDeviceSize> block_alignments;
+    std::vector<uint32_t> block_of(resources.size(), UINT32_MAX);
+
+    for (const auto& transient : transients) {
+        ResourceHandle r = transient.resource;
+
+        uint32_t chosen = UINT32_MAX;
+        for (uint32_t b = 0; b < memory_blocks.size() && chosen == UINT32_MAX; b++) {
+            if (!(memory_blocks[b].type_bits & transient.requirements.memoryTypeBits)) {
+                continue;
+            }
+            bool overlaps = std::any_of(block_lifetimes[b].begin(), block_lifetimes[b].end(),
+                [&](const std::pair<uint32_t, uint32_t>& lifetime) {
+                    return first_use[r] <= lifetime.second && lifetime.first <= last_use[r];
+                });
+            if (!overlaps) {
+                chosen = b;
+            }
+        }
+
+        if (chosen == UINT32_MAX) {
+            chosen = (uint32_t)memory_blocks.size();
+            memory_blocks.push_back({
+                .memory = VK_NULL_HANDLE,
+                .size = 0,
+                .type_bits = transient.requirements.memoryTypeBits,
+                .occupants = {}
+            });
+            block_lifetimes.emplace_back();
+            block_alignments.push_back(1);
+        }
+
+        MemoryBlock& block = memory_blocks[chosen];
+        block.size = std::max(block.size, transient.requirements.size);
+        block.type_bits &= transient.requirements.memoryTypeBits;
+        block.occupants.push_back(r);
+        block_lifetimes[chosen].emplace_back(first_use[r], last_use[r]);
+        block_alignments[chosen] = std::max(block_alignments[chosen], transient.requirements.alignment);
+        block_of[r] = chosen;
+    }
+
+    for (uint32_t b = 0; b < memory_blocks.size(); b++) {
+        MemoryBlock& block = memory_blocks[b];
+        VkMemoryRequirements requirements {
+            .size = block.size,
+            .alignment = block_alignments[b],
+            .memoryTypeBits = block.type_bits
+        };
+        block.memory = Memory::allocate(context, requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            MemoryBudget::Category::Transient);
+
+        std::sort(block.occupants.begin(), block.occupants.end(), [&](ResourceHandle lhs, ResourceHandle rhs) {
+            return first_use[lhs] < first_use[rhs];
+        });
+
+        for (ResourceHandle r : block.occupants) {
+            vkBindImageMemory(context.getLogicalDevice(), transient_images[r], block.memory, 0);
+
+            VkImageViewCreateInfo view_create_info {
+                .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+                .image = transient_images[r],
+                .viewType = VK_IMAGE_VIEW_TYPE_2D,
+                .format = resources[r].desc.format,
+                .components = {
+                    .r = VK_COMPONENT_SWIZZLE_IDENTITY,
+                    .g = VK_COMPONENT_SWIZZLE_IDENTITY,
+                    .b = VK_COMPONENT_SWIZZLE_IDENTITY,
+                    .a = VK_COMPONENT_SWIZZLE_IDENTITY
+                },
+                .subresourceRange = {
+                    .aspectMask = Image::aspectMask(resources[r].desc.format),
+                    .baseMipLevel = 0,
+                    .levelCount = 1,
+                    .baseArrayLayer = 0,
+                    .layerCount = 1
+                }
+            };
+
+            if (vkCreateImageView(context.getLogicalDevice(), &view_create_info, nullptr, &transient_views[r])) {
+                throw std::runtime_error("Failed to create transient image view!");
+            }
+        }
+    }
+}
+
+void RenderGraph::computeBarriers() {
+    // Every stage and write access a resource sees during the frame. The next occupant of an
+    // aliased block, including the first occupant in the following frame, waits on these.
+    std::vector<VkPipelineStageFlags> all_stages(resources.size(), 0);
+    std::vector<VkAccessFlags> all_writes(resources.size(), 0);
+    for (const auto& compiled : compiled_passes) {
+        const Pass& pass = passes[compiled.pass];
+        for (const auto& usage : pass.usages) {
+            AccessInfo info = accessInfo(usage.access, pass.type);
+            all_stages[usage.resource] |= info.stages;
+            all_writes[usage.resource] |= info.write ? info.access : 0;
+        }
+    }
+
+    std::vector<ResourceState> states(resources.size());
+    for (ResourceHandle r = 0; r < resources.size(); r++) {
+        states[r] = {
+            .layout = resources[r].initial_layout,
+            .write_stages = resources[r].initial_stage,
+            .write_access = 0,
+            .read_stages = 0,
+            .visible_stages = 0
+        };
+    }
+    for (const auto& block : memory_blocks) {
+        for (uint32_t i = 0; i < block.occupants.size(); i++) {
+            ResourceHandle predecessor = block.occupants[(i + block.occupants.size() - 1) % block.occupants.size()];
+            states[block.occupants[i]].write_stages = all_stages[predecessor];
+            states[block.occupants[i]].write_access = all_writes[predecessor];
+        }
+    }
+
+    for (auto& compiled : compiled_passes) {
+        const Pass& pass = passes[compiled.pass];
+
+        for (const auto& usage : pass.usages) {
+            AccessInfo info = accessInfo(usage.access, pass.type);
+            ResourceState& state = states[usage.resource];
+            bool is_buffer = resources[usage.resource].is_buffer;
+
+            bool layout_change = !is_buffer && state.layout != info.layout;
+            bool read_after_write = state.write_access && (info.stages & ~state.visible_stages);
+            bool write_after_read = info.write && state.read_stages;
+
+            if (layout_change || read_after_write || write_after_read || (info.write && state.write_access)) {
+                compiled.src_stages |= state.write_stages | state.read_stages;
+                compiled.dst_stages |= info.stages;
+
+                // A pure write-after-read only needs the execution dependency above
+                if (layout_change || state.write_access) {
+                    compiled.barriers.push_back({
+                        .resource = usage.resource,
+                        .old_layout = state.layout,
+                        .new_layout = layout_change ? info.layout : state.layout,
+                        .src_access = state.write_access,
+                        .dst_access = info.access
+                    });
+                }
+
+                state.visible_stages = 0;
+            }
+
+            if (!is_buffer) {
+                state.layout = info.layout;
+            }
+            if (info.write) {
+                state.write_stages = info.stages;
+                state.write_access = info.access;
+                state.read_stages = 0;
+                state.visible_stages = info.stages;
+            }
+            else {
+                state.read_stages |= info.stages;
+                state.visible_stages |= info.stages;
+            }
+        }
+
+        if (compiled.src_stages == 0 && compiled.dst_stages != 0) {
+            compiled.src_stages = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        }
+    }
+
+    // Leave imported images in the layout their owner expects
+    final_barriers.clear();
+    final_src_stages = 0;
+    for (ResourceHandle r = 0; r < resources.size(); r++) {
+        const Resource& resource = resources[r];
+        if (!resource.imported || resource.is_buffer || resource.final_layout == VK_IMAGE_LAYOUT_UNDEFINED
+            || states[r].layout == resource.final_layout)
+        {
+            continue;
+        }
+
+        final_src_stages |= states[r].write_stages | states[r].read_stages;
+        final_barriers.push_back({
+            .resource = r,
+            .old_layout = states[r].layout,
+            .new_layout = resource.final_layout,
+            .src_access = states[r].write_access,
+            .dst_access = 0
+        });
+    }
+}
+
+void RenderGraph::createRenderPasses() {
+    // Whether a resource has contents worth loading when a pass starts, and whether any
+    // later live pass (or the outside world) still needs them when it ends
+    std::vector<bool> has_contents(resources.size());
+    std::vector<uint32_t> last_use(resources.size(), 0);
+    for (ResourceHandle r = 0; r < resources.size(); r++) {
+        has_contents[r] = resources[r].imported && resources[r].initial_layout != VK_IMAGE_LAYOUT_UNDEFINED;
+    }
+    for (uint32_t i = 0; i < compiled_passes.size(); i++) {
+        for (const auto& usage : passes[compiled_passes[i].pass].usages) {
+            last_use[usage.resource] = i;
+        }
+    }
+
+    for (uint32_t i = 0; i < compiled_passes.size(); i++) {
+        CompiledPass& compiled = compiled_passes[i];
+        const Pass& pass = passes[compiled.pass];
+
+        if (pass.type != PassType::Raster) {
+            for (const auto& usage : pass.usages) {
+                has_contents[usage.resource] = has_contents[usage.resource] || accessInfo(usage.access, pass.type).write;
+            }
+            continue;
+        }
+
+        std::vector<VkAttachmentDescription> attachments;
+        std::vector<VkAttachmentReference> color_references;
+        std::vector<ResourceHandle> color_resources;
+        std::vector<std::pair<ResourceHandle, VkAttachmentReference>> resolves;
+        std::optional<VkAttachmentReference> depth_reference;
+
+        for (const auto& usage : pass.usages) {
+            if (!isAttachment(usage.access)) {
+                continue;
+            }
+
+            const Resource& resource = resources[usage.resource];
+            AccessInfo info = accessInfo(usage.access, pass.type);
+            bool needed_later = resource.output || last_use[usage.resource] > i;
+
+            // A resolve overwrites every texel, so its target is never loaded
+            VkAttachmentLoadOp load_op = usage.clear ? VK_ATTACHMENT_LOAD_OP_CLEAR
+                : has_contents[usage.resource] && usage.access != Access::ResolveAttachment ? VK_ATTACHMENT_LOAD_OP_LOAD
+                : VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+            VkAttachmentStoreOp store_op = needed_later ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
+            bool stencil = Image::aspectMask(resource.desc.format) & VK_IMAGE_ASPECT_STENCIL_BIT;
+
+            // Layout transitions are done by the graph's barriers, so the render pass never changes layouts
+            attachments.push_back({
+                .format = resource.desc.format,
+                .samples = resource.desc.samples,
+                .loadOp = load_op,
+                .storeOp = store_op,
+                .stencilLoadOp = stencil ? load_op : VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+                .stencilStoreOp = stencil ? store_op : VK_ATTACHMENT_STORE_OP_DONT_CARE,
+                .initialLayout = info.layout,
+                .finalLayout = info.layout
+            });
+
+            VkAttachmentReference reference = {
+                .attachment = (uint32_t)attachments.size() - 1,
+                .layout = info.layout
+            };
+            if (usage.access == Access::ColorAttachment) {
+                color_references.push_back(reference);
+                color_resources.push_back(usage.resource);
+            }
+            else if (usage.access == Access::ResolveAttachment) {
+                resolves.emplace_back(usage.source, reference);
+            }
+            else {
+                depth_reference = reference;
+            }
+
+            compiled.attachments.push_back(usage.resource);
+            compiled.clear_values.push_back(usage.clear.value_or(VkClearValue{}));
+            compiled.extent = resource.desc.extent;
+            has_contents[usage.resource] = has_contents[usage.resource] || info.write;
+        }
+
+        // Resolve references pair up with the color references by index
+        std::vector<VkAttachmentReference> resolve_references;
+        if (!resolves.empty()) {
+            resolve_references.assign(color_references.size(), { VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_UNDEFINED });
+        }
+        for (const auto& [source, reference] : resolves) {
+            auto color = std::find(color_resources.begin(), color_resources.end(), source);
+            if (color == color_resources.end()) {
+                throw std::runtime_error("Failed to create render graph render pass: " + pass.name
+                    + " resolves an image that is not one of its color attachments");
+            }
+            resolve_references[color - color_resources.begin()] = reference;
+        }
+
+        VkSubpassDescription subpass_description = {
+            .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+            .colorAttachmentCount = (uint32_t)color_references.size(),
+            .pColorAttachments = color_references.data(),
+            .pResolveAttachments = resolve_references.empty() ? nullptr : resolve_references.data(),
+            .pDepthStencilAttachment = depth_reference ? &depth_reference.value() : nullptr
+        };
+
+        VkRenderPassCreateInfo render_create_info {
+            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+            .attachmentCount = (uint32_t)attachments.size(),
+            .pAttachments = attachments.data(),
+            .subpassCount = 1,
+            .pSubpasses = &subpass_description,
+            .dependencyCount = 0,
+            .pDependencies = nullptr
+        };
+
+        if (vkCreateRenderPass(context.getLogicalDevice(), &render_create_info, nullptr, &compiled.render_pass)) {
+            throw std::runtime_error("Failed to create render graph render pass");
+        }
+
+        // Storage and sampled accesses in a raster pass also leave contents behind
+        for (const auto& usage : pass.usages) {
+            has_contents[usage.resource] = has_contents[usage.resource] || accessInfo(usage.access, pass.type).write;
+        }
+    }
+}
+
+VkFramebuffer RenderGraph::getFramebuffer(const CompiledPass& compiled) {
+    std::vector<VkImageView> views;
+    uint64_t key = Hash::value(compiled.render_pass);
+    for (ResourceHandle attachment : compiled.attachments) {
+        views.push_back(getImageView(attachment));
+        key = Hash::value(views.back(), key);
+    }
+
+    auto found = framebuffers.find(key);
+    if (found != framebuffers.end()) {
+        return found->second;
+    }
+
+    VkFramebufferCreateInfo framebuffer_info = {
+        .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+        .renderPass = compiled.render_pass,
+        .attachmentCount = (uint32_t)views.size(),
+        .pAttachments = views.data(),
+        .width = compiled.extent.width,
+        .height = compiled.extent.height,
+        .layers = 1
+    };
+
+    VkFramebuffer framebuffer;
+    if (vkCreateFramebuffer(context.getLogicalDevice(), &framebuffer_info, nullptr, &framebuffer)) {
+        throw std::runtime_error("Failed to create render graph framebuffer!");
+    }
+    framebuffers[key] = framebuffer;
+    return framebuffer;
+}
+
+void RenderGraph::destroyCompiled() {
+    if (compiled_passes.empty() && memory_blocks.empty()) {
+        return;
+    }
+
+    invalidateFramebuffers();
+
+    std::vector<VkRenderPass> render_passes;
+    for (auto& compiled : compiled_passes) {
+        render_passes.push_back(compiled.render_pass);
+    }
+    compiled_passes.clear();
+
+    std::vector<VkDeviceMemory> memory;
+    for (auto& block : memory_blocks) {
+        memory.push_back(block.memory);
+    }
+    memory_blocks.clear();
+
+    // Frames in flight may still use the old attachments; release them once those finish
+    VkDevice device = context.getLogicalDevice();
+    context.getDeletionQueue().push([
+        &context = context,
+        device,
+        render_passes = std::move(render_passes),
+        views = std::move(transient_views),
+        images = std::move(transient_images),
+        memory = std::move(memory)
+    ]() {
+        for (VkRenderPass render_pass : render_passes) {
+            vkDestroyRenderPass(device, render_pass, nullptr);
+        }
+        for (VkImageView view : views) {
+            vkDestroyImageView(device, view, nullptr);
+        }
+        for (VkImage image : images) {
+            vkDestroyImage(device, image, nullptr);
+        }
+        for (VkDeviceMemory block : memory) {
+            Memory::free(context, block);
+        }
+    });
+    transient_views.clear();
+    transient_images.clear();
+}
@@ -0,0 +1,280 @@
+#ifndef _MEADOW_RENDER_GRAPH_HPP_
+#define _MEADOW_RENDER_GRAPH_HPP_
+
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GraphicsContext.hpp"
+
+/**
+ * @brief A frame graph of passes that declare the resources they read and write.
+ *
+ * The graph is declared again every frame: call reset(), import external
+ * resources (such as the swapchain image), add passes, then compile() and
+ * execute(). From the declarations the graph
+ * - culls passes whose results never reach an output (an imported resource,
+ *   a resource marked with markOutput(), or a pass with side effects),
+ * - derives the layout transitions and pipeline barriers between passes,
+ *   batching each pass's barriers into a single vkCmdPipelineBarrier,
+ * - creates a VkRenderPass per raster pass, choosing load and store ops from
+ *   whether contents are cleared, inherited from an earlier pass or used later,
+ *   and resolving multisampled color into its single-sample target in the pass,
+ * - creates transient images and aliases their memory whenever their
+ *   lifetimes within the frame don't overlap.
+ *
+ * compile() hashes the declared topology (not the imported handles) and only
+ * rebuilds when it changes, so a steady-state frame just re-records the cached
+ * barriers with this frame's imported handles.
+ */
+class RenderGraph {
+public:
+    using ResourceHandle = uint32_t;
+
+    enum class PassType {
+        Raster,
+        Compute,
+        Transfer
+    };
+
+    enum class Access {
+        ColorAttachment,
+        ResolveAttachment,
+        DepthAttachment,
+        DepthRead,
+        Sampled,
+        StorageRead,
+        StorageWrite,
+        IndirectRead,
+        TransferRead,
+        TransferWrite
+    };
+
+    struct TextureDesc {
+        VkFormat format;
+        VkExtent2D extent;
+        VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+    };
+
+    using ExecuteFunction = std::function<void(VkCommandBuffer)>;
+
+    /**
+     * @brief Records a pass's resource declarations. Handed to the setup callback of addPass().
+     */
+    class PassBuilder {
+        RenderGraph& graph;
+        uint32_t pass;
+
+    public:
+        PassBuilder(RenderGraph& graph, uint32_t pass) : graph(graph), pass(pass) {}
+
+        /**
+         * @brief Declares a transient image owned by the graph.
+         */
+        ResourceHandle createTexture(const char* name, const TextureDesc& desc);
+
+        void writeColor(ResourceHandle resource, std::optional<VkClearColorValue> clear = std::nullopt);
+
+        /**
+         * @brief Resolves a multisampled color attachment of this pass into a single-sample
+         * image at the end of the pass. The source must also be declared with writeColor().
+         */
+        void resolveColor(ResourceHandle source, ResourceHandle target);
+
+        void writeDepth(ResourceHandle resource, std::optional<VkClearDepthStencilValue> clear = std::nullopt);
+
+        void readDepth(ResourceHandle resource);
+
+        void readTexture(ResourceHandle resource);
+
+        void readStorage(ResourceHandle resource);
+
+        void writeStorage(ResourceHandle resource);
+
+        void readIndirect(ResourceHandle resource);
+
+        void readTransfer(ResourceHandle resource);
+
+        void writeTransfer(ResourceHandle resource);
+
+        /**
+         * @brief Keeps the pass even if none of its writes are consumed.
+         */
+        void setSideEffects();
+    };
+
+private:
+    struct Resource {
+        std::string name;
+        bool imported;
+        bool is_buffer;
+        bool output;
+        TextureDesc desc;
+        VkImageUsageFlags usage;
+
+        VkImage image;
+        VkImageView view;
+        VkBuffer buffer;
+
+        VkImageLayout initial_layout;
+        VkPipelineStageFlags initial_stage;
+        VkImageLayout final_layout;
+    };
+
+    struct Usage {
+        ResourceHandle resource;
+        Access access;
+        std::optional<VkClearValue> clear;
+        ResourceHandle source; /**< For ResolveAttachment, the color attachment resolved into resource. */
+    };
+
+    struct Pass {
+        std::string name;
+        PassType type;
+        std::vector<Usage> usages;
+        ExecuteFunction execute;
+        bool side_effects;
+    };
+
+    struct Barrier {
+        ResourceHandle resource;
+        VkImageLayout old_layout;
+        VkImageLayout new_layout;
+        VkAccessFlags src_access;
+        VkAccessFlags dst_access;
+    };
+
+    struct CompiledPass {
+        uint32_t pass;
+        VkPipelineStageFlags src_stages;
+        VkPipelineStageFlags dst_stages;
+        std::vector<Barrier> barriers;
+
+        VkRenderPass render_pass;
+        std::vector<ResourceHandle> attachments;
+        std::vector<VkClearValue> clear_values;
+        VkExtent2D extent;
+    };
+
+    struct MemoryBlock {
+        VkDeviceMemory memory;
+        VkDeviceSize size;
+        uint32_t type_bits;
+        std::vector<ResourceHandle> occupants; /**< Sorted by first use. */
+    };
+
+    const GraphicsContext& context;
+
+    std::vector<Resource> resources;
+    std::vector<Pass> passes;
+
+    uint64_t compiled_hash;
+    std::vector<CompiledPass> compiled_passes;
+    std::vector<Barrier> final_barriers;
+    VkPipelineStageFlags final_src_stages;
+    std::vector<MemoryBlock> memory_blocks;
+    std::vector<VkImage> transient_images;
+    std::vector<VkImageView> transient_views;
+    std::unordered_map<uint64_t, VkFramebuffer> framebuffers;
+
+public:
+    RenderGraph(const GraphicsContext& context);
+
+    ~RenderGraph();
+
+    RenderGraph(const RenderGraph&) = delete;
+    RenderGraph& operator=(const RenderGraph&) = delete;
+
+    /**
+     * @brief Clears this frame's declarations. The compiled graph is kept for reuse.
+     */
+    void reset();
+
+    /**
+     * @brief Imports an image owned outside the graph, such as a swapchain image.
+     *
+     * @param initial_layout Layout the image is in when the frame starts (UNDEFINED to discard contents).
+     * @param initial_stage Stage the first use must wait on, e.g. the stage a semaphore wait was issued for.
+     * @param final_layout Layout the image is left in at the end of the frame.
+     */
+    ResourceHandle importImage(const char* name, VkImage image, VkImageView view, const TextureDesc& desc,
+        VkImageLayout initial_layout, VkPipelineStageFlags initial_stage, VkImageLayout final_layout);
+
+    /**
+     * @brief Declares a transient image owned by the graph, for resources shared by passes
+     * declared in different places (see PassBuilder::createTexture()).
+     */
+    ResourceHandle createTexture(const char* name, const TextureDesc& desc);
+
+    /**
+     * @brief Imports a buffer owned outside the graph.
+     */
+    ResourceHandle importBuffer(const char* name, VkBuffer buffer);
+
+    /**
+     * @brief Keeps the passes producing a transient resource alive even though nothing reads it.
+     */
+    void markOutput(ResourceHandle resource);
+
+    /**
+     * @brief Declares a pass.
+     *
+     * @param setup Called immediately to declare the pass's resources.
+     * @param execute Called from execute() to record the pass. Raster passes are
+     * recorded inside their render pass, with the graph's attachments bound.
+     */
+    void addPass(const char* name, PassType type,
+        const std::function<void(PassBuilder&)>& setup, ExecuteFunction execute);
+
+    /**
+     * @brief Culls, orders and allocates the declared graph, unless its topology is
+     * unchanged since the last compile.
+     */
+    void compile();
+
+    /**
+     * @brief Records every live pass and its barriers into a command buffer that is recording.
+     */
+    void execute(VkCommandBuffer command_buffer);
+
+    /**
+     * @brief The render pass created for a raster pass, for building compatible pipelines.
+     * Valid after compile(); VK_NULL_HANDLE if the pass was culled.
+     */
+    VkRenderPass getRenderPass(const char* pass_name) const;
+
+    /**
+     * @brief The image view of a resource, for binding transient images as inputs. Valid after compile().
+     */
+    VkImageView getImageView(ResourceHandle resource) const;
+
+    /**
+     * @brief Drops every cached framebuffer, e.g. after the swapchain images were recreated.
+     * They are destroyed through the deletion queue once the frames in flight are done.
+     */
+    void invalidateFramebuffers();
+
+private:
+    ResourceHandle addResource(Resource resource);
+
+    void addUsage(uint32_t pass, ResourceHandle resource, Access access, std::optional<VkClearValue> clear = std::nullopt,
+        ResourceHandle source = 0);
+
+    uint64_t hashTopology() const;
+
+    std::vector<bool> cullPasses() const;
+
+    void allocateTransients(const std::vector<uint32_t>& live_passes);
+
+    void computeBarriers();
+
+    void createRenderPasses();
+
+    VkFramebuffer getFramebuffer(const CompiledPass& compiled);
+
+    void destroyCompiled();
+};
+
+#endif // _MEADOW_RENDER_GRAPH_HPP_
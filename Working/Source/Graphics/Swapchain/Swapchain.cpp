@@ -1,8 +1,8 @@
 #include <algorithm>
 #include "Swapchain.hpp"
 #include "ansi.h"
+#include "Config.h"
 #include "Logging.hpp"
-#include "RenderPass.hpp"
 
 
 /**
@@ -27,19 +27,20 @@
  * 
  */
 Swapchain::Swapchain(const GraphicsContext& graphics_context) :
+    swapchain(VK_NULL_HANDLE),
     logical_device(graphics_context.getLogicalDevice()),
     swapchain_support(graphics_context.queryPhysicalSwapChainSupport()),     // Query swap chain support details
     surface_format(chooseSwapSurfaceFormat(swapchain_support.formats)),                       // Choose the surface format
     image_format(surface_format.format),             // Choose the image format
     extent(chooseSwapExtent(graphics_context.getWindow(), swapchain_support.capabilities)),   // Choose the swap extent)
+    image_usage(0),
     graphics_context(graphics_context),
-    render_pass(nullptr)
+    depth_format(findDepthFormat()),
+    samples(chooseSampleCount())
 {
     createSwapChain();
 
     createImageViews();
-
-    //createFramebuffers(graphics_context, render_pass);
 }
 
 /**
@@ -64,6 +65,10 @@ void Swapchain::createSwapChain() {
 
     extent = chooseSwapExtent(graphics_context.getWindow(), swapchain_support.capabilities);
 
+    // Copying out of the images lets FrameCapture read frames back
+    image_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+        | (swapchain_support.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+
     // Create swap chain create info
     VkSwapchainCreateInfoKHR create_info = {
         .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR,
@@ -73,7 +78,7 @@ void Swapchain::createSwapChain() {
         .imageColorSpace = surface_format.colorSpace,
         .imageExtent = extent,
         .imageArrayLayers = 1,
-        .imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT
+        .imageUsage = image_usage
     };
 
     // Find queue families for graphics and presentation
@@ -99,40 +104,28 @@ void Swapchain::createSwapChain() {
     create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
     create_info.presentMode = present_mode;
     create_info.clipped = VK_TRUE;
+    create_info.oldSwapchain = swapchain;
 
     // Create the swap chain
+    VkSwapchainKHR old_swapchain = swapchain;
     if (vkCreateSwapchainKHR(logical_device, &create_info, nullptr, &swapchain)) {
         throw std::runtime_error(RED_FG_BRIGHT "[ERROR] " WHITE_FG_BRIGHT "Swapchain.cpp " ANSI_NORMAL "failed to create swap chain!");
     }
 
+    // Frames in flight may still present the old images
+    if (old_swapchain != VK_NULL_HANDLE) {
+        VkDevice device = logical_device;
+        graphics_context.getDeletionQueue().push([device, old_swapchain]() {
+            vkDestroySwapchainKHR(device, old_swapchain, nullptr);
+        });
+    }
+
     vkGetSwapchainImagesKHR(logical_device, swapchain, &image_count, nullptr);
     images.resize(image_count);
     vkGetSwapchainImagesKHR(logical_device, swapchain, &image_count, images.data());    
     
 }
 
-void Swapchain::createFramebuffers(const GraphicsContext& graphics_context, const VkRenderPass& render_pass)
-{
-    framebuffers.resize(image_views.size());
-
-    for (uint32_t i = 0; i < image_views.size(); i++) {
-
-
-        VkFramebufferCreateInfo framebuffer_info = {
-            .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-            .renderPass = render_pass,
-            .attachmentCount = 1,
-            .pAttachments = &image_views[i],
-            .width = extent.width,
-            .height = extent.height,
-            .layers = 1
-        };
-        if (vkCreateFramebuffer(graphics_context.getLogicalDevice(), &framebuffer_info, nullptr, &framebuffers[i])) {
-            throw std::runtime_error("Failed to create framebuffer!");
-        }
-    }
-}
-
 void Swapchain::createImageViews() {
     image_views.resize(images.size());
     int i = 0;
@@ -165,11 +158,49 @@ void Swapchain::createImageViews() {
 
 }
 
-void Swapchain::cleanup() {
-    for (auto& framebuffer : framebuffers) {
-        vkDestroyFramebuffer(logical_device, framebuffer, nullptr);
+/**
+ * @brief Picks the most precise depth format usable as an optimally tiled depth attachment.
+ */
+VkFormat Swapchain::findDepthFormat() {
+    const VkFormat candidates[] = {
+        VK_FORMAT_D32_SFLOAT,
+        VK_FORMAT_D32_SFLOAT_S8_UINT,
+        VK_FORMAT_D24_UNORM_S8_UINT
+    };
+
+    for (VkFormat format : candidates) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(graphics_context.getPhysicalDevice(), format, &properties);
+        if (properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+            return format;
+        }
     }
 
+    throw std::runtime_error("Failed to find a supported depth format!");
+}
+
+/**
+ * @brief Picks the highest sample count up to CONSTANTS::MSAA_SAMPLES that the device
+ * supports for both color and depth framebuffer attachments, and for sampling depth,
+ * which the Hi-Z pyramid is built from.
+ */
+VkSampleCountFlagBits Swapchain::chooseSampleCount() {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(graphics_context.getPhysicalDevice(), &properties);
+
+    VkSampleCountFlags supported = properties.limits.framebufferColorSampleCounts
+        & properties.limits.framebufferDepthSampleCounts
+        & properties.limits.sampledImageDepthSampleCounts;
+
+    for (uint32_t count = CONSTANTS::MSAA_SAMPLES; count > 1; count >>= 1) {
+        if (supported & count) {
+            return (VkSampleCountFlagBits)count;
+        }
+    }
+    return VK_SAMPLE_COUNT_1_BIT;
+}
+
+void Swapchain::cleanup() {
     for (auto& image_view : image_views) {
         vkDestroyImageView(graphics_context.getLogicalDevice(), image_view, nullptr);
     }
@@ -181,18 +212,29 @@ void Swapchain::cleanup() {
     vkDestroySwapchainKHR(logical_device, swapchain, nullptr);
 }
 
+/**
+ * @brief Hands the image views to the deletion queue, to be destroyed once the frames in
+ * flight are done with them. The swapchain itself stays, as the oldSwapchain of its replacement.
+ */
+void Swapchain::retire() {
+    VkDevice device = logical_device;
+    graphics_context.getDeletionQueue().push([device, views = std::move(image_views)]() {
+        for (VkImageView view : views) {
+            vkDestroyImageView(device, view, nullptr);
+        }
+    });
+    image_views.clear();
+}
+
 void Swapchain::recreate() {
-    vkDeviceWaitIdle(graphics_context.getLogicalDevice());
+    retire();
 
-    cleanup();
+    // The surface's extent changes with the window
+    swapchain_support = graphics_context.queryPhysicalSwapChainSupport();
 
     createSwapChain();
 
     createImageViews();
-
-    if (render_pass != nullptr) {
-        createFramebuffers(graphics_context, *render_pass);
-    }
 }
 
 
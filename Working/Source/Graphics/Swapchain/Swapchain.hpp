@@ -4,8 +4,11 @@
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
 #include <vector>
+#include <array>
+#include <memory>
 #include "QueueUtils.hpp"
 #include "GraphicsContext.hpp"
+#include "Image.hpp"
 
 /**
  * @brief Class for managing the swap chain
@@ -18,13 +21,12 @@ class Swapchain {
     VkSurfaceFormatKHR surface_format;
     VkFormat image_format;
     VkExtent2D extent;
+    VkImageUsageFlags image_usage;
     std::vector<VkImage> images;
     std::vector<VkImageView> image_views;
-    std::vector<VkFramebuffer> framebuffers;
     const GraphicsContext& graphics_context;
-    VkRenderPass* render_pass;
-
-    const VkClearValue clear_value = {{{0.0f, 0.0f, 0.0f, 1.0f}}};
+    VkFormat depth_format;
+    VkSampleCountFlagBits samples;
 
 
 public:
@@ -33,36 +35,53 @@ public:
 
     ~Swapchain();
 
-    inline void setRenderPass(VkRenderPass& render_pass) { 
-        this->render_pass = &render_pass; 
-        recreate();
-    }
-
     inline operator VkSwapchainKHR&() { return swapchain; }
     inline operator VkSwapchainKHR*() { return &swapchain; }
 
     inline const VkFormat& getFormat() { return image_format; }
 
-    inline VkRenderPass& getRenderPass() { return *render_pass; }
+    /**
+     * @brief Format for the frame's depth target, which the render graph creates.
+     */
+    inline const VkFormat& getDepthFormat() { return depth_format; }
+
+    /**
+     * @brief Sample count for the frame's color and depth targets, which are resolved into
+     * the swapchain image when above one.
+     */
+    inline VkSampleCountFlagBits getSampleCount() const { return samples; }
 
     inline const VkExtent2D& getExtent() { return extent; }
 
-    inline const std::vector<VkFramebuffer>& getFramebuffers() { return framebuffers; }
+    /**
+     * @brief How the images may be used; includes TRANSFER_SRC wherever the surface allows it.
+     */
+    inline VkImageUsageFlags getImageUsage() const { return image_usage; }
+
+    inline const std::vector<VkImage>& getImages() { return images; }
 
-    inline const VkClearValue& getClearValue() { return clear_value; }
+    inline const std::vector<VkImageView>& getImageViews() { return image_views; }
 
+    /**
+     * @brief Rebuilds the swapchain and its image views, e.g. for a new window size. The
+     * old ones are released to the context's deletion queue rather than waiting for the GPU.
+     */
     void recreate();
 
 private:
 
     void createSwapChain();
 
-    void createFramebuffers(const GraphicsContext& graphics_context, const VkRenderPass& render_pass);
-
     void createImageViews();
 
+    VkFormat findDepthFormat();
+
+    VkSampleCountFlagBits chooseSampleCount();
+
     void cleanup();
 
+    void retire();
+
     VkSurfaceFormatKHR chooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& available_formats);
 
     VkPresentModeKHR chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& available_present_modes);
@@ -0,0 +1,78 @@
+#include "Ktx2.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    const unsigned char KTX2_IDENTIFIER[12] = {
+        0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+    };
+
+    const size_t HEADER_SIZE = 80; // Identifier, header fields and the DFD/KVD/SGD index
+    const size_t LEVEL_INDEX_ENTRY_SIZE = 24;
+
+    // bytesPlane0 of the basic descriptor block, past the DFD's total size word
+    const size_t DFD_BYTES_PLANE0_OFFSET = 4 + 16;
+
+    template <typename T>
+    T read(const std::byte* data, size_t offset) {
+        T value;
+        std::memcpy(&value, data + offset, sizeof(T));
+        return value;
+    }
+}
+
+Ktx2File::Ktx2File(const char* path) : file(path) {
+    const std::byte* data = file.getData();
+
+    if (file.getSize() < HEADER_SIZE || std::memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER))) {
+        throw std::runtime_error(std::string("Not a KTX2 file: ") + path);
+    }
+
+    format = (VkFormat)read<uint32_t>(data, 12);
+    width = read<uint32_t>(data, 20);
+    height = std::max(1u, read<uint32_t>(data, 24));
+    uint32_t depth = read<uint32_t>(data, 28);
+    layer_count = read<uint32_t>(data, 32);
+    face_count = read<uint32_t>(data, 36);
+    uint32_t level_count = std::max(1u, read<uint32_t>(data, 40));
+    uint32_t supercompression = read<uint32_t>(data, 44);
+    uint32_t dfd_offset = read<uint32_t>(data, 48);
+    uint32_t dfd_length = read<uint32_t>(data, 52);
+
+    if (format == VK_FORMAT_UNDEFINED) {
+        throw std::runtime_error(std::string("KTX2 file needs transcoding, which is not supported: ") + path);
+    }
+    if (supercompression != 0) {
+        throw std::runtime_error(std::string("Supercompressed KTX2 files are not supported: ") + path);
+    }
+    if (depth > 1 || (face_count != 1 && face_count != 6) || width == 0) {
+        throw std::runtime_error(std::string("Unsupported KTX2 image dimensions: ") + path);
+    }
+
+    if (dfd_length <= DFD_BYTES_PLANE0_OFFSET || (uint64_t)dfd_offset + dfd_length > file.getSize()) {
+        throw std::runtime_error(std::string("Missing KTX2 data format descriptor: ") + path);
+    }
+    block_size = read<uint8_t>(data, dfd_offset + DFD_BYTES_PLANE0_OFFSET);
+    if (block_size == 0) {
+        throw std::runtime_error(std::string("KTX2 texel block size is unsized: ") + path);
+    }
+
+    if (file.getSize() < HEADER_SIZE + level_count * LEVEL_INDEX_ENTRY_SIZE) {
+        throw std::runtime_error(std::string("Truncated KTX2 level index: ") + path);
+    }
+
+    levels.resize(level_count);
+    for (uint32_t i = 0; i < level_count; i++) {
+        size_t entry = HEADER_SIZE + i * LEVEL_INDEX_ENTRY_SIZE;
+        levels[i] = {
+            .byte_offset = read<uint64_t>(data, entry),
+            .byte_length = read<uint64_t>(data, entry + 8),
+            .uncompressed_byte_length = read<uint64_t>(data, entry + 16)
+        };
+
+        if (levels[i].byte_offset + levels[i].byte_length > file.getSize()) {
+            throw std::runtime_error(std::string("KTX2 level data out of bounds: ") + path);
+        }
+    }
+}
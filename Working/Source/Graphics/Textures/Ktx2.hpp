@@ -0,0 +1,78 @@
+#ifndef _MEADOW_KTX2_HPP_
+#define _MEADOW_KTX2_HPP_
+
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <vector>
+#include "MappedFile.hpp"
+
+/**
+ * @brief A memory-mapped KTX2 texture container.
+ *
+ * Only the header and level index are parsed up front; level data is read
+ * straight out of the mapping when a mip is uploaded. Supports 2D, array and
+ * cube textures stored without supercompression, in any format with a
+ * Vulkan equivalent (which KTX2 records directly as a VkFormat).
+ *
+ * https://registry.khronos.org/KTX/specs/2.0/ktxspec.v2.html
+ */
+class Ktx2File {
+public:
+    struct Level {
+        uint64_t byte_offset;
+        uint64_t byte_length;
+        uint64_t uncompressed_byte_length;
+    };
+
+private:
+    MappedFile file;
+
+    VkFormat format;
+    uint32_t block_size;
+    uint32_t width;
+    uint32_t height;
+    uint32_t layer_count;
+    uint32_t face_count;
+    std::vector<Level> levels;
+
+public:
+    /**
+     * @brief Maps and validates a KTX2 file. Throws std::runtime_error if it cannot be used.
+     */
+    explicit Ktx2File(const char* path);
+
+    inline VkFormat getFormat() const { return format; }
+
+    /**
+     * @brief Bytes per texel, or per compressed block, as recorded in the data format descriptor.
+     */
+    inline uint32_t getBlockSize() const { return block_size; }
+
+    inline uint32_t getWidth() const { return width; }
+
+    inline uint32_t getHeight() const { return height; }
+
+    /**
+     * @brief Number of Vulkan array layers, counting each cube face as a layer.
+     */
+    inline uint32_t getArrayLayers() const { return (layer_count ? layer_count : 1) * face_count; }
+
+    inline bool isCube() const { return face_count == 6; }
+
+    inline bool isArray() const { return layer_count > 0; }
+
+    inline uint32_t getLevelCount() const { return (uint32_t)levels.size(); }
+
+    inline uint32_t getLevelWidth(uint32_t level) const { return std::max(1u, width >> level); }
+
+    inline uint32_t getLevelHeight(uint32_t level) const { return std::max(1u, height >> level); }
+
+    inline uint64_t getLevelSize(uint32_t level) const { return levels[level].byte_length; }
+
+    /**
+     * @brief Pointer to the tightly packed data of a level, all layers and faces included.
+     */
+    inline const std::byte* getLevelData(uint32_t level) const { return file.getData() + levels[level].byte_offset; }
+};
+
+#endif // _MEADOW_KTX2_HPP_
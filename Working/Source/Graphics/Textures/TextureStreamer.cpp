@@ -0,0 +1,407 @@
+#include "TextureStreamer.hpp"
+#include "Config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory_resource>
+#include <numeric>
+#include <stdexcept>
+#include "Logging.hpp"
+
+namespace {
+    // Minimum staging offset alignment; each mip is further aligned to a multiple of its
+    // texel block size, since 3, 6 and 12 byte formats do not divide into this
+    const VkDeviceSize STAGING_ALIGNMENT = 16;
+
+    const uint32_t STAGING_BATCHES = 2;
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+TextureStreamer::TextureStreamer(const GraphicsContext& context, BindlessDescriptors* bindless) :
+    context(context),
+    bindless(bindless),
+    command_pool(VK_NULL_HANDLE),
+    batches(STAGING_BATCHES),
+    update_count(0),
+    stats{}
+{
+    VkCommandPoolCreateInfo pool_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = context.getQueueFamilies().transfer_family.value()
+    };
+
+    if (vkCreateCommandPool(context.getLogicalDevice(), &pool_info, nullptr, &command_pool)) {
+        throw std::runtime_error("Failed to create transfer command pool!");
+    }
+
+    VkCommandBufferAllocateInfo alloc_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .commandPool = command_pool,
+        .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandBufferCount = 1
+    };
+
+    VkFenceCreateInfo fence_create_info = {
+        .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO
+    };
+
+    for (auto& batch : batches) {
+        batch.in_flight = false;
+        batch.fence = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(context.getLogicalDevice(), &alloc_info, &batch.command_buffer) ||
+            vkCreateFence(context.getLogicalDevice(), &fence_create_info, nullptr, &batch.fence))
+        {
+            throw std::runtime_error("Failed to create texture upload batch!");
+        }
+    }
+}
+
+TextureStreamer::~TextureStreamer() {
+    for (auto& batch : batches) {
+        if (batch.in_flight) {
+            vkWaitForFences(context.getLogicalDevice(), 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        }
+        vkDestroyFence(context.getLogicalDevice(), batch.fence, nullptr);
+    }
+    vkDestroyCommandPool(context.getLogicalDevice(), command_pool, nullptr);
+
+    // The owner must make sure no frame still samples the textures (e.g. by waiting for the device)
+    for (auto& retired : retired_views) {
+        vkDestroyImageView(context.getLogicalDevice(), retired.view, nullptr);
+    }
+    for (auto& texture : textures) {
+        vkDestroyImageView(context.getLogicalDevice(), texture.view, nullptr);
+        if (bindless && texture.bindless_index != UINT32_MAX) {
+            bindless->release(BindlessDescriptors::SAMPLED_IMAGES, texture.bindless_index);
+        }
+    }
+}
+
+TextureStreamer::TextureHandle TextureStreamer::load(const char* path, float priority) {
+    Texture texture {
+        .path = path,
+        .file = std::make_unique<Ktx2File>(path),
+        .image = nullptr,
+        .view_type = VK_IMAGE_VIEW_TYPE_2D,
+        .view = VK_NULL_HANDLE,
+        .level_resident = {},
+        .resident_mip = 0,
+        .tail_mip = 0,
+        .bindless_index = UINT32_MAX,
+        .priority = priority,
+        .requested = std::chrono::steady_clock::now()
+    };
+    const Ktx2File& file = *texture.file;
+
+    uint32_t level_count = file.getLevelCount();
+    texture.level_resident.assign(level_count, false);
+    texture.resident_mip = level_count;
+
+    // The tail starts at the finest level no larger than TEXTURE_TAIL_SIZE, or the coarsest level if none are
+    texture.tail_mip = level_count - 1;
+    while (texture.tail_mip > 0
+        && std::max(file.getLevelWidth(texture.tail_mip - 1), file.getLevelHeight(texture.tail_mip - 1)) <= CONSTANTS::TEXTURE_TAIL_SIZE)
+    {
+        texture.tail_mip--;
+    }
+
+    if (file.isCube()) {
+        texture.view_type = file.getArrayLayers() > 6 ? VK_IMAGE_VIEW_TYPE_CUBE_ARRAY : VK_IMAGE_VIEW_TYPE_CUBE;
+    }
+    else if (file.isArray()) {
+        texture.view_type = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    }
+
+    // Textures are written on the transfer queue and sampled on the graphics queue
+    const QueueUtils::QueueFamilyIndices& families = context.getQueueFamilies();
+    uint32_t queue_family_indices[] = { families.graphics_family.value(), families.transfer_family.value() };
+    bool shared = queue_family_indices[0] != queue_family_indices[1];
+
+    VkImageCreateInfo image_create_info {
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .flags = file.isCube() ? (VkImageCreateFlags)VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT : 0u,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = file.getFormat(),
+        .extent = { file.getWidth(), file.getHeight(), 1 },
+        .mipLevels = level_count,
+        .arrayLayers = file.getArrayLayers(),
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        .sharingMode = shared ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE,
+        .queueFamilyIndexCount = shared ? 2u : 0u,
+        .pQueueFamilyIndices = shared ? queue_family_indices : nullptr,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
+    };
+    texture.image = std::make_unique<Image>(context, image_create_info);
+
+    TextureHandle handle = (TextureHandle)textures.size();
+    textures.push_back(std::move(texture));
+
+    for (uint32_t level = 0; level < level_count; level++) {
+        requests.push_back({handle, level, score(textures[handle], level)});
+        std::push_heap(requests.begin(), requests.end(), laterRequest);
+    }
+
+    return handle;
+}
+
+void TextureStreamer::setPriority(TextureHandle texture, float priority) {
+    textures[texture].priority = priority;
+    for (auto& request : requests) {
+        request.score = score(textures[request.texture], request.level);
+    }
+    std::make_heap(requests.begin(), requests.end(), laterRequest);
+}
+
+void TextureStreamer::update() {
+    update_count++;
+
+    // Views replaced more than FRAMES_IN_FLIGHT updates ago can no longer be in use
+    std::erase_if(retired_views, [this](const RetiredView& retired) {
+        if (update_count < retired.destroy_after) {
+            return false;
+        }
+        vkDestroyImageView(context.getLogicalDevice(), retired.view, nullptr);
+        return true;
+    });
+
+    for (auto& batch : batches) {
+        if (batch.in_flight && vkGetFenceStatus(context.getLogicalDevice(), batch.fence) == VK_SUCCESS) {
+            retireBatch(batch);
+        }
+    }
+
+    for (auto& batch : batches) {
+        if (!batch.in_flight && !requests.empty()) {
+            fillBatch(batch);
+        }
+    }
+}
+
+void TextureStreamer::retireBatch(UploadBatch& batch) {
+    vkResetFences(context.getLogicalDevice(), 1, &batch.fence);
+    batch.in_flight = false;
+
+    for (auto& [texture, level] : batch.mips) {
+        markResident(texture, level);
+    }
+    batch.mips.clear();
+
+    if (batch.oversize) {
+        trackStaging(0, batch.oversize->getSize());
+        batch.oversize.reset();
+    }
+}
+
+void TextureStreamer::fillBatch(UploadBatch& batch) {
+    struct Upload {
+        TextureHandle texture;
+        uint32_t level;
+        VkDeviceSize offset;
+    };
+    std::pmr::memory_resource* scratch = &context.getFrameAllocator().get();
+    std::pmr::vector<Upload> uploads(scratch);
+    Buffer* staging = nullptr;
+
+    const MipRequest& next = requests.front();
+    VkDeviceSize next_size = textures[next.texture].file->getLevelSize(next.level);
+
+    if (next_size > CONSTANTS::TEXTURE_STAGING_BUDGET) {
+        // The one-off staging buffer can wait for memory to free up; the mip stays queued
+        if (context.getMemoryBudget().isUnderPressure()) {
+            return;
+        }
+
+        // Too big for a batch, so give it a dedicated staging buffer of its own
+        batch.oversize = std::make_unique<Buffer>(context, next_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        trackStaging(next_size, 0);
+        staging = batch.oversize.get();
+
+        uploads.push_back({next.texture, next.level, 0});
+        std::pop_heap(requests.begin(), requests.end(), laterRequest);
+        requests.pop_back();
+    }
+    else {
+        if (!batch.staging) {
+            batch.staging = std::make_unique<Buffer>(context, CONSTANTS::TEXTURE_STAGING_BUDGET, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+            trackStaging(CONSTANTS::TEXTURE_STAGING_BUDGET, 0);
+        }
+        staging = batch.staging.get();
+
+        // Pack requests in priority order until the next one no longer fits
+        VkDeviceSize offset = 0;
+        while (!requests.empty()) {
+            const MipRequest& request = requests.front();
+            const Ktx2File& file = *textures[request.texture].file;
+            VkDeviceSize alignment = std::lcm(STAGING_ALIGNMENT, (VkDeviceSize)file.getBlockSize());
+            offset = (offset + alignment - 1) / alignment * alignment;
+
+            VkDeviceSize size = file.getLevelSize(request.level);
+            if (offset + size > CONSTANTS::TEXTURE_STAGING_BUDGET) {
+                break;
+            }
+
+            uploads.push_back({request.texture, request.level, offset});
+            offset += size;
+
+            std::pop_heap(requests.begin(), requests.end(), laterRequest);
+            requests.pop_back();
+        }
+    }
+
+    std::pmr::vector<VkImageMemoryBarrier> to_transfer(scratch);
+    std::pmr::vector<VkImageMemoryBarrier> to_shader_read(scratch);
+    for (const auto& upload : uploads) {
+        const Texture& texture = textures[upload.texture];
+        std::memcpy(static_cast<std::byte*>(staging->getMapped()) + upload.offset,
+            texture.file->getLevelData(upload.level), texture.file->getLevelSize(upload.level));
+
+        VkImageMemoryBarrier barrier = {
+            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+            .srcAccessMask = 0,
+            .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+            .image = texture.image->getImage(),
+            .subresourceRange = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .baseMipLevel = upload.level,
+                .levelCount = 1,
+                .baseArrayLayer = 0,
+                .layerCount = texture.image->getArrayLayers()
+            }
+        };
+        to_transfer.push_back(barrier);
+
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        to_shader_read.push_back(barrier);
+
+        batch.mips.emplace_back(upload.texture, upload.level);
+        stats.bytes_uploaded += texture.file->getLevelSize(upload.level);
+    }
+
+    VkCommandBufferBeginInfo begin_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+    };
+
+    if (vkBeginCommandBuffer(batch.command_buffer, &begin_info) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin recording texture uploads!");
+    }
+
+    vkCmdPipelineBarrier(batch.command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, (uint32_t)to_transfer.size(), to_transfer.data());
+
+    for (const auto& upload : uploads) {
+        const Texture& texture = textures[upload.texture];
+        VkBufferImageCopy region = {
+            .bufferOffset = upload.offset,
+            .bufferRowLength = 0,
+            .bufferImageHeight = 0,
+            .imageSubresource = {
+                .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                .mipLevel = upload.level,
+                .baseArrayLayer = 0,
+                .layerCount = texture.image->getArrayLayers()
+            },
+            .imageOffset = {0, 0, 0},
+            .imageExtent = {
+                texture.file->getLevelWidth(upload.level),
+                texture.file->getLevelHeight(upload.level),
+                1
+            }
+        };
+        vkCmdCopyBufferToImage(batch.command_buffer, staging->getBuffer(), texture.image->getImage(),
+            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    }
+
+    // Visibility to the graphics queue comes from waiting on the batch fence before the mip is used
+    vkCmdPipelineBarrier(batch.command_buffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 0, nullptr, (uint32_t)to_shader_read.size(), to_shader_read.data());
+
+    if (vkEndCommandBuffer(batch.command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to record texture uploads!");
+    }
+
+    VkSubmitInfo submit_info = {
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &batch.command_buffer
+    };
+
+    if (vkQueueSubmit(context.getTransferQueue(), 1, &submit_info, batch.fence)) {
+        throw std::runtime_error("Failed to submit texture uploads!");
+    }
+    batch.in_flight = true;
+}
+
+void TextureStreamer::markResident(TextureHandle handle, uint32_t level) {
+    Texture& texture = textures[handle];
+    texture.level_resident[level] = true;
+
+    // Only a contiguous range ending at the coarsest level can be exposed through a view
+    uint32_t resident_mip = texture.resident_mip;
+    while (resident_mip > 0 && texture.level_resident[resident_mip - 1]) {
+        resident_mip--;
+    }
+    if (resident_mip == texture.resident_mip) {
+        return;
+    }
+
+    bool was_ready = isReady(handle);
+    texture.resident_mip = resident_mip;
+    if (!isReady(handle)) {
+        return;
+    }
+
+    VkImageView view = texture.image->createView(texture.view_type, VK_IMAGE_ASPECT_COLOR_BIT, resident_mip);
+    if (texture.view != VK_NULL_HANDLE) {
+        retired_views.push_back({texture.view, update_count + CONSTANTS::FRAMES_IN_FLIGHT + 1});
+    }
+    texture.view = view;
+
+    if (bindless) {
+        if (texture.bindless_index == UINT32_MAX) {
+            texture.bindless_index = bindless->addSampledImage(view);
+        }
+        else {
+            bindless->updateSampledImage(texture.bindless_index, view);
+        }
+    }
+
+    if (!was_ready) {
+        Log::info << "[TEXTURE] " << texture.path << " ready after " << secondsSince(texture.requested) * 1000.0 << " ms" << std::endl;
+    }
+    if (resident_mip == 0) {
+        stats.textures_loaded++;
+        Log::info << "[TEXTURE] " << texture.path << " fully resident after " << secondsSince(texture.requested) * 1000.0
+            << " ms (peak staging " << stats.peak_staging_bytes / 1024 << " KiB)" << std::endl;
+    }
+}
+
+void TextureStreamer::trackStaging(VkDeviceSize allocated, VkDeviceSize freed) {
+    stats.staging_bytes = stats.staging_bytes + allocated - freed;
+    stats.peak_staging_bytes = std::max(stats.peak_staging_bytes, stats.staging_bytes);
+}
+
+bool TextureStreamer::laterRequest(const MipRequest& a, const MipRequest& b) {
+    return a.score > b.score;
+}
+
+float TextureStreamer::score(const Texture& texture, uint32_t level) const {
+    // Measured in mip levels: coarser mips and higher priorities come first
+    uint32_t size = std::max(texture.file->getLevelWidth(level), texture.file->getLevelHeight(level));
+    return std::log2((float)size) - texture.priority;
+}
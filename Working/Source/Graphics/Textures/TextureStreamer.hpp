@@ -0,0 +1,155 @@
+#ifndef _MEADOW_TEXTURE_STREAMER_HPP_
+#define _MEADOW_TEXTURE_STREAMER_HPP_
+
+#include <vulkan/vulkan.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "GraphicsContext.hpp"
+#include "BindlessDescriptors.hpp"
+#include "Buffer.hpp"
+#include "Image.hpp"
+#include "Ktx2.hpp"
+
+/**
+ * @brief Streams KTX2 textures to the GPU through the transfer queue.
+ *
+ * load() only maps the file and creates the image; level data is uploaded by
+ * update(), which is meant to be called once per frame and never blocks. Each
+ * call retires finished uploads and fills whichever staging batches are free
+ * with the next mips in priority order, up to CONSTANTS::TEXTURE_STAGING_BUDGET
+ * bytes per batch. A mip larger than the budget gets one-off staging of its own,
+ * held back while the context's MemoryBudget is under pressure.
+ *
+ * Mips are ordered coarsest first across all textures, with a texture's
+ * priority counting as that many mip levels of head start. A texture is usable
+ * as soon as its tail (every mip no larger than CONSTANTS::TEXTURE_TAIL_SIZE) is
+ * resident; its view only ever covers the resident mips, and is replaced as
+ * finer mips arrive. When constructed with a BindlessDescriptors, each texture
+ * is also given a bindless slot that tracks its current view.
+ */
+class TextureStreamer {
+public:
+    using TextureHandle = uint32_t;
+
+    struct Stats {
+        VkDeviceSize staging_bytes; /**< Staging memory currently allocated. */
+        VkDeviceSize peak_staging_bytes; /**< Highest staging_bytes seen so far. */
+        VkDeviceSize bytes_uploaded; /**< Total level data uploaded. */
+        uint32_t textures_loaded; /**< Textures with every mip resident. */
+    };
+
+private:
+    struct Texture {
+        std::string path;
+        std::unique_ptr<Ktx2File> file;
+        std::unique_ptr<Image> image;
+        VkImageViewType view_type;
+        VkImageView view;
+        std::vector<bool> level_resident;
+        uint32_t resident_mip; /**< Finest level of the resident range, the level count when none are. */
+        uint32_t tail_mip; /**< The texture is usable once resident_mip reaches this level. */
+        uint32_t bindless_index;
+        float priority;
+        std::chrono::steady_clock::time_point requested;
+    };
+
+    struct MipRequest {
+        TextureHandle texture;
+        uint32_t level;
+        float score;
+    };
+
+    struct UploadBatch {
+        std::unique_ptr<Buffer> staging;
+        std::unique_ptr<Buffer> oversize; /**< One-off staging for a single mip larger than the budget. */
+        VkCommandBuffer command_buffer;
+        VkFence fence;
+        std::vector<std::pair<TextureHandle, uint32_t>> mips;
+        bool in_flight;
+    };
+
+    struct RetiredView {
+        VkImageView view;
+        uint64_t destroy_after;
+    };
+
+    const GraphicsContext& context;
+    BindlessDescriptors* bindless;
+
+    VkCommandPool command_pool;
+    std::vector<UploadBatch> batches;
+
+    std::vector<Texture> textures;
+    std::vector<MipRequest> requests; /**< Min-heap on score. */
+    std::vector<RetiredView> retired_views;
+    uint64_t update_count;
+
+    Stats stats;
+
+public:
+    TextureStreamer(const GraphicsContext& context, BindlessDescriptors* bindless = nullptr);
+
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /**
+     * @brief Maps a KTX2 file, creates its image and queues all of its mips for upload.
+     *
+     * @param priority Head start over other textures, in mip levels.
+     */
+    TextureHandle load(const char* path, float priority = 0.0f);
+
+    /**
+     * @brief Changes the priority of a texture's mips that have not been uploaded yet.
+     */
+    void setPriority(TextureHandle texture, float priority);
+
+    /**
+     * @brief Retires completed uploads and submits the next ones. Call once per frame.
+     */
+    void update();
+
+    /**
+     * @brief Whether the texture's tail mips are resident, so it can be sampled.
+     */
+    inline bool isReady(TextureHandle texture) const { return textures[texture].resident_mip <= textures[texture].tail_mip; }
+
+    /**
+     * @brief Whether every mip of the texture is resident.
+     */
+    inline bool isFullyResident(TextureHandle texture) const { return textures[texture].resident_mip == 0; }
+
+    /**
+     * @brief A view of the resident mips, or VK_NULL_HANDLE until the texture is ready.
+     * Views are replaced as mips stream in, so don't hold on to one across frames.
+     */
+    inline VkImageView getImageView(TextureHandle texture) const { return isReady(texture) ? textures[texture].view : VK_NULL_HANDLE; }
+
+    /**
+     * @brief The texture's slot in the bindless sampled image array, once it is ready.
+     */
+    inline uint32_t getBindlessIndex(TextureHandle texture) const { return textures[texture].bindless_index; }
+
+    inline uint32_t getResidentMip(TextureHandle texture) const { return textures[texture].resident_mip; }
+
+    inline const Stats& getStats() const { return stats; }
+
+private:
+    void retireBatch(UploadBatch& batch);
+
+    void fillBatch(UploadBatch& batch);
+
+    void markResident(TextureHandle texture, uint32_t level);
+
+    void trackStaging(VkDeviceSize allocated, VkDeviceSize freed);
+
+    float score(const Texture& texture, uint32_t level) const;
+
+    static bool laterRequest(const MipRequest& a, const MipRequest& b);
+};
+
+#endif // _MEADOW_TEXTURE_STREAMER_HPP_
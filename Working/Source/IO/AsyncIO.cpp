@@ -0,0 +1,513 @@
+#include "AsyncIO.hpp"
+#include "Config.h"
+#include "Logging.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+    /**
+     * @brief One blocking positioned read for the fallback threads.
+     *
+     * @return Bytes read, or a negated error code.
+     */
+    int64_t readAt(const AsyncFile& file, uint64_t offset, char* destination, uint32_t length) {
+#ifdef _WIN32
+        OVERLAPPED overlapped {};
+        overlapped.Offset = (DWORD)offset;
+        overlapped.OffsetHigh = (DWORD)(offset >> 32);
+        DWORD read = 0;
+        if (!ReadFile(file.getNativeHandle(), destination, length, &read, &overlapped)) {
+            DWORD error = GetLastError();
+            return error == ERROR_HANDLE_EOF ? 0 : -(int64_t)error;
+        }
+        return read;
+#else
+        ssize_t read = pread(file.getNativeHandle(), destination, length, (off_t)offset);
+        return read < 0 ? -(int64_t)errno : read;
+#endif
+    }
+
+    Task<void> readChunk(AsyncIO& io, const AsyncFile& file, uint64_t offset, char* destination, uint32_t length) {
+        uint32_t read = co_await io.read(file, offset, destination, length);
+        if (read != length) {
+            throw std::runtime_error("Failed to read file: it ended early");
+        }
+    }
+
+#ifdef __linux__
+    int ringSetup(uint32_t entries, io_uring_params* params) {
+        return (int)syscall(__NR_io_uring_setup, entries, params);
+    }
+
+    int ringEnter(int ring, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+        return (int)syscall(__NR_io_uring_enter, ring, to_submit, min_complete, flags, nullptr, 0);
+    }
+
+    int ringRegister(int ring, uint32_t opcode, void* arg, uint32_t count) {
+        return (int)syscall(__NR_io_uring_register, ring, opcode, arg, count);
+    }
+#endif
+}
+
+AsyncFile::AsyncFile() :
+#ifdef _WIN32
+    handle(nullptr),
+#else
+    descriptor(-1),
+#endif
+    size(0)
+{}
+
+AsyncFile::AsyncFile(const char* path) : AsyncFile() {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error(std::string("Failed to open file ") + path);
+    }
+    handle = file;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        close();
+        throw std::runtime_error(std::string("Failed to query size of ") + path);
+    }
+    size = (uint64_t)file_size.QuadPart;
+#else
+    descriptor = open(path, O_RDONLY | O_CLOEXEC);
+    if (descriptor < 0) {
+        throw std::runtime_error(std::string("Failed to open file ") + path);
+    }
+
+    struct stat file_stat;
+    if (fstat(descriptor, &file_stat)) {
+        close();
+        throw std::runtime_error(std::string("Failed to query size of ") + path);
+    }
+    size = (uint64_t)file_stat.st_size;
+#endif
+}
+
+AsyncFile::~AsyncFile() {
+    close();
+}
+
+AsyncFile::AsyncFile(AsyncFile&& other) noexcept : AsyncFile() {
+    *this = std::move(other);
+}
+
+AsyncFile& AsyncFile::operator=(AsyncFile&& other) noexcept {
+    if (this != &other) {
+        close();
+#ifdef _WIN32
+        std::swap(handle, other.handle);
+#else
+        std::swap(descriptor, other.descriptor);
+#endif
+        std::swap(size, other.size);
+    }
+    return *this;
+}
+
+void AsyncFile::close() {
+#ifdef _WIN32
+    if (handle) {
+        CloseHandle(handle);
+    }
+    handle = nullptr;
+#else
+    if (descriptor >= 0) {
+        ::close(descriptor);
+    }
+    descriptor = -1;
+#endif
+    size = 0;
+}
+
+void AsyncIO::Request::await_suspend(std::coroutine_handle<> awaiting) {
+    continuation = awaiting;
+    io->submit(this);
+}
+
+uint32_t AsyncIO::Request::await_resume() const {
+    if (error) {
+        throw std::runtime_error("Failed to read file: error " + std::to_string(error));
+    }
+    return completed;
+}
+
+AsyncIO::AsyncIO(JobSystem& jobs) :
+    jobs(jobs),
+    ring(-1),
+    ring_entries(0),
+    sq_mapping(nullptr),
+    sq_mapping_size(0),
+    cq_mapping(nullptr),
+    cq_mapping_size(0),
+    sqe_mapping(nullptr),
+    sqe_mapping_size(0),
+    ring_error(0),
+    stopping(false)
+{
+    if (createRing()) {
+        completion_thread = std::thread(&AsyncIO::completionLoop, this);
+        return;
+    }
+
+    io_threads.reserve(CONSTANTS::IO_FALLBACK_THREADS);
+    for (uint32_t i = 0; i < CONSTANTS::IO_FALLBACK_THREADS; i++) {
+        io_threads.emplace_back(&AsyncIO::fallbackLoop, this);
+    }
+}
+
+AsyncIO::~AsyncIO() {
+    stopping.store(true);
+
+    if (usesIoUring()) {
+        {
+            // A request-less entry wakes the completion thread so it can see the stop
+            std::lock_guard<std::mutex> lock(submit_mutex);
+            if (!ring_error) {
+                backlog.push_back(nullptr);
+                submitBacklog();
+            }
+        }
+        completion_thread.join();
+        destroyRing();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex);
+        queue_ready.notify_all();
+    }
+    for (auto& thread : io_threads) {
+        thread.join();
+    }
+}
+
+Task<std::vector<char>> AsyncIO::readFile(std::string path) {
+    AsyncFile file(path.c_str());
+    std::vector<char> data(file.getSize());
+
+    std::vector<Task<void>> chunks;
+    for (uint64_t offset = 0; offset < data.size(); offset += CONSTANTS::IO_CHUNK_SIZE) {
+        uint32_t length = (uint32_t)std::min<uint64_t>(CONSTANTS::IO_CHUNK_SIZE, data.size() - offset);
+        chunks.push_back(readChunk(*this, file, offset, data.data() + offset, length));
+    }
+    co_await whenAll(std::move(chunks));
+
+    co_return data;
+}
+
+Task<std::vector<std::vector<char>>> AsyncIO::readFiles(std::vector<std::string> paths) {
+    std::vector<Task<std::vector<char>>> files;
+    files.reserve(paths.size());
+    for (std::string& path : paths) {
+        files.push_back(readFile(std::move(path)));
+    }
+    co_return co_await whenAll(std::move(files));
+}
+
+void AsyncIO::submit(Request* request) {
+    if (usesIoUring()) {
+        std::lock_guard<std::mutex> lock(submit_mutex);
+        if (ring_error) {
+            complete(request, -(int64_t)ring_error);
+            return;
+        }
+        backlog.push_back(request);
+        submitBacklog();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(queue_mutex);
+    queue.push_back(request);
+    queue_ready.notify_one();
+}
+
+bool AsyncIO::complete(Request* request, int64_t result) {
+    if (result == -EINTR || result == -EAGAIN) {
+        return true;
+    }
+
+    if (result < 0) {
+        request->error = (int)-result;
+    }
+    else {
+        request->completed += (uint32_t)result;
+        if (result > 0 && request->completed < request->length) {
+            return true;
+        }
+    }
+
+    // The request lives in the coroutine's frame, so it is gone once the coroutine resumes
+    std::coroutine_handle<> continuation = request->continuation;
+    jobs.schedule([continuation]() { continuation.resume(); });
+    return false;
+}
+
+void AsyncIO::fallbackLoop() {
+    while (true) {
+        Request* request;
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+            queue_ready.wait(lock, [this]() { return !queue.empty() || stopping.load(); });
+            if (queue.empty()) {
+                return;
+            }
+            request = queue.front();
+            queue.pop_front();
+        }
+
+        int64_t result;
+        do {
+            result = readAt(*request->file, request->offset + request->completed,
+                request->destination + request->completed, request->length - request->completed);
+        } while (complete(request, result));
+    }
+}
+
+#ifdef __linux__
+
+bool AsyncIO::createRing() {
+    io_uring_params params {};
+    int fd = ringSetup(CONSTANTS::IO_QUEUE_DEPTH, &params);
+    if (fd < 0) {
+        return false;
+    }
+    ring = fd;
+    ring_entries = params.sq_entries;
+
+    sq_mapping_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cq_mapping_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mapping = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mapping) {
+        sq_mapping_size = cq_mapping_size = std::max(sq_mapping_size, cq_mapping_size);
+    }
+
+    void* mapping = mmap(nullptr, sq_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+    if (mapping == MAP_FAILED) {
+        destroyRing();
+        return false;
+    }
+    sq_mapping = mapping;
+
+    if (single_mapping) {
+        cq_mapping = sq_mapping;
+    }
+    else {
+        mapping = mmap(nullptr, cq_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+        if (mapping == MAP_FAILED) {
+            destroyRing();
+            return false;
+        }
+        cq_mapping = mapping;
+    }
+
+    sqe_mapping_size = params.sq_entries * sizeof(io_uring_sqe);
+    mapping = mmap(nullptr, sqe_mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+    if (mapping == MAP_FAILED) {
+        destroyRing();
+        return false;
+    }
+    sqe_mapping = mapping;
+
+    char* sq = static_cast<char*>(sq_mapping);
+    sq_head = reinterpret_cast<uint32_t*>(sq + params.sq_off.head);
+    sq_tail = reinterpret_cast<uint32_t*>(sq + params.sq_off.tail);
+    sq_mask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+    sq_array = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+
+    char* cq = static_cast<char*>(cq_mapping);
+    cq_head = reinterpret_cast<uint32_t*>(cq + params.cq_off.head);
+    cq_tail = reinterpret_cast<uint32_t*>(cq + params.cq_off.tail);
+    cq_mask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+    cqes = cq + params.cq_off.cqes;
+
+    // IORING_OP_READ needs a 5.6 kernel; older rings fall back to the thread pool
+    std::vector<char> probe_storage(sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = reinterpret_cast<io_uring_probe*>(probe_storage.data());
+    if (ringRegister(ring, IORING_REGISTER_PROBE, probe, 256) < 0 || probe->last_op < IORING_OP_READ ||
+        !(probe->ops[IORING_OP_READ].flags & IO_URING_OP_SUPPORTED)) {
+        destroyRing();
+        return false;
+    }
+
+    return true;
+}
+
+void AsyncIO::destroyRing() {
+    if (sqe_mapping) {
+        munmap(sqe_mapping, sqe_mapping_size);
+    }
+    if (cq_mapping && cq_mapping != sq_mapping) {
+        munmap(cq_mapping, cq_mapping_size);
+    }
+    if (sq_mapping) {
+        munmap(sq_mapping, sq_mapping_size);
+    }
+    if (ring >= 0) {
+        close(ring);
+    }
+    sqe_mapping = cq_mapping = sq_mapping = nullptr;
+    ring = -1;
+}
+
+void AsyncIO::submitBacklog() {
+    io_uring_sqe* sqes = static_cast<io_uring_sqe*>(sqe_mapping);
+
+    // Only this thread writes the tail, under submit_mutex; the kernel consumes every entry
+    // during io_uring_enter, so keeping in_flight below the ring size also keeps the
+    // completion queue from overflowing
+    uint32_t tail = *sq_tail;
+    uint32_t queued = 0;
+    while (!backlog.empty() && in_flight.size() < ring_entries) {
+        Request* request = backlog.front();
+        backlog.pop_front();
+
+        uint32_t index = tail & sq_mask;
+        io_uring_sqe& sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        if (request) {
+            sqe.opcode = IORING_OP_READ;
+            sqe.fd = request->file->getNativeHandle();
+            sqe.off = request->offset + request->completed;
+            sqe.addr = (uint64_t)(uintptr_t)(request->destination + request->completed);
+            sqe.len = request->length - request->completed;
+        }
+        else {
+            sqe.opcode = IORING_OP_NOP;
+        }
+        sqe.user_data = (uint64_t)(uintptr_t)request;
+        sq_array[index] = index;
+
+        tail++;
+        queued++;
+        in_flight.insert(request);
+    }
+    if (queued == 0) {
+        return;
+    }
+    std::atomic_ref<uint32_t>(*sq_tail).store(tail, std::memory_order_release);
+
+    while (queued > 0) {
+        int submitted = ringEnter(ring, queued, 0, 0);
+        if (submitted < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                continue;
+            }
+
+            // The kernel took entries from the head, so the unsubmitted ones are the last
+            // queued; withdraw them from the ring and fail their reads
+            int error = errno;
+            Log::error << "[IO] Failed to submit " << queued << " reads to io_uring: " << std::strerror(error) << std::endl;
+            tail -= queued;
+            std::atomic_ref<uint32_t>(*sq_tail).store(tail, std::memory_order_release);
+            for (uint32_t i = 0; i < queued; i++) {
+                Request* request = reinterpret_cast<Request*>((uintptr_t)sqes[(tail + i) & sq_mask].user_data);
+                in_flight.erase(request);
+                if (request) {
+                    complete(request, -(int64_t)error);
+                }
+            }
+            return;
+        }
+        queued -= (uint32_t)submitted;
+    }
+}
+
+void AsyncIO::completionLoop() {
+    const io_uring_cqe* completions = static_cast<const io_uring_cqe*>(cqes);
+    std::vector<Request*> retries;
+    bool stop = false;
+
+    while (!stop) {
+        if (ringEnter(ring, 0, 1, IORING_ENTER_GETEVENTS) < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                continue;
+            }
+
+            // Anything else means the ring itself is broken, and retrying would only spin
+            int error = errno;
+            Log::error << "[IO] io_uring_enter failed: " << std::strerror(error) << std::endl;
+            std::lock_guard<std::mutex> lock(submit_mutex);
+            failPending(error);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(submit_mutex);
+        uint32_t head = *cq_head;
+        uint32_t tail = std::atomic_ref<uint32_t>(*cq_tail).load(std::memory_order_acquire);
+        for (; head != tail; head++) {
+            const io_uring_cqe& completion = completions[head & cq_mask];
+            Request* request = reinterpret_cast<Request*>((uintptr_t)completion.user_data);
+
+            // Erased before the coroutine can resume, as its next read may reuse the same address
+            in_flight.erase(request);
+            if (!request) {
+                stop = true;
+            }
+            else if (complete(request, completion.res)) {
+                retries.push_back(request);
+            }
+        }
+        std::atomic_ref<uint32_t>(*cq_head).store(head, std::memory_order_release);
+
+        backlog.insert(backlog.begin(), retries.begin(), retries.end());
+        retries.clear();
+        submitBacklog();
+    }
+}
+
+void AsyncIO::failPending(int error) {
+    ring_error = error;
+
+    for (Request* request : in_flight) {
+        if (request) {
+            complete(request, -(int64_t)error);
+        }
+    }
+    in_flight.clear();
+
+    for (Request* request : backlog) {
+        if (request) {
+            complete(request, -(int64_t)error);
+        }
+    }
+    backlog.clear();
+}
+
+#else
+
+bool AsyncIO::createRing() {
+    return false;
+}
+
+void AsyncIO::destroyRing() {}
+
+void AsyncIO::submitBacklog() {}
+
+void AsyncIO::completionLoop() {}
+
+void AsyncIO::failPending(int) {}
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef _MEADOW_ASYNC_IO_HPP_
+#define _MEADOW_ASYNC_IO_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "JobSystem.hpp"
+#include "Task.hpp"
+
+/**
+ * @brief A file opened for reading at arbitrary offsets. Move-only.
+ */
+class AsyncFile {
+#ifdef _WIN32
+    void* handle;
+#else
+    int descriptor;
+#endif
+    uint64_t size;
+
+public:
+    AsyncFile();
+
+    /**
+     * @brief Opens the file at the given path. Throws std::runtime_error on failure.
+     */
+    explicit AsyncFile(const char* path);
+
+    ~AsyncFile();
+
+    AsyncFile(AsyncFile&& other) noexcept;
+    AsyncFile& operator=(AsyncFile&& other) noexcept;
+
+    AsyncFile(const AsyncFile&) = delete;
+    AsyncFile& operator=(const AsyncFile&) = delete;
+
+    inline uint64_t getSize() const { return size; }
+
+#ifdef _WIN32
+    inline void* getNativeHandle() const { return handle; }
+#else
+    inline int getNativeHandle() const { return descriptor; }
+#endif
+
+private:
+    void close();
+};
+
+/**
+ * @brief Asynchronous file reads for coroutines.
+ *
+ * co_await read(...) suspends the coroutine while the read is in flight and
+ * resumes it as a job on the JobSystem once the data has arrived, so any
+ * number of coroutines can keep reads queued without tying up a thread each.
+ *
+ * On Linux the reads are submitted to an io_uring, with up to
+ * CONSTANTS::IO_QUEUE_DEPTH in flight at once; further reads wait in a
+ * backlog until slots free up. Where io_uring is unavailable (other
+ * platforms, old kernels, or sandboxes that forbid it) a small pool of
+ * threads performs blocking reads instead.
+ *
+ * Every read must have completed before the AsyncIO is destroyed.
+ */
+class AsyncIO {
+public:
+    /**
+     * @brief One read, owned by the awaiting coroutine's frame while it is suspended.
+     */
+    struct Request {
+        AsyncIO* io;
+        const AsyncFile* file;
+        uint64_t offset;
+        char* destination;
+        uint32_t length;
+        uint32_t completed;
+        int error;
+        std::coroutine_handle<> continuation;
+
+        inline bool await_ready() const noexcept { return length == 0; }
+
+        void await_suspend(std::coroutine_handle<> awaiting);
+
+        /**
+         * @return The number of bytes read, short only at the end of the file. Throws on I/O errors.
+         */
+        uint32_t await_resume() const;
+    };
+
+private:
+    JobSystem& jobs;
+
+    // io_uring backend
+    int ring;
+    uint32_t ring_entries;
+    void* sq_mapping;
+    size_t sq_mapping_size;
+    void* cq_mapping;
+    size_t cq_mapping_size;
+    void* sqe_mapping;
+    size_t sqe_mapping_size;
+    uint32_t* sq_head;
+    uint32_t* sq_tail;
+    uint32_t sq_mask;
+    uint32_t* sq_array;
+    uint32_t* cq_head;
+    uint32_t* cq_tail;
+    uint32_t cq_mask;
+    void* cqes;
+    std::mutex submit_mutex;
+    std::unordered_set<Request*> in_flight;
+    std::deque<Request*> backlog;
+    int ring_error;
+    std::thread completion_thread;
+
+    // Blocking fallback
+    std::vector<std::thread> io_threads;
+    std::mutex queue_mutex;
+    std::condition_variable queue_ready;
+    std::deque<Request*> queue;
+
+    std::atomic<bool> stopping;
+
+public:
+    /**
+     * @param jobs Where suspended coroutines are resumed once their reads complete.
+     */
+    explicit AsyncIO(JobSystem& jobs);
+
+    ~AsyncIO();
+
+    AsyncIO(const AsyncIO&) = delete;
+    AsyncIO& operator=(const AsyncIO&) = delete;
+
+    /**
+     * @brief Reads length bytes at offset into destination. The file and the destination must
+     * stay valid until the read completes.
+     */
+    inline Request read(const AsyncFile& file, uint64_t offset, void* destination, uint32_t length) {
+        return {this, &file, offset, static_cast<char*>(destination), length, 0, 0, nullptr};
+    }
+
+    /**
+     * @brief Reads a whole file, in chunks of up to CONSTANTS::IO_CHUNK_SIZE that are all in flight at once.
+     */
+    Task<std::vector<char>> readFile(std::string path);
+
+    /**
+     * @brief Reads several whole files concurrently, returning their contents in the same order.
+     */
+    Task<std::vector<std::vector<char>>> readFiles(std::vector<std::string> paths);
+
+    /**
+     * @brief Whether reads go through io_uring rather than the blocking fallback.
+     */
+    inline bool usesIoUring() const { return ring >= 0; }
+
+private:
+    void submit(Request* request);
+
+    bool createRing();
+
+    void destroyRing();
+
+    /**
+     * @brief Queues as many backlogged reads as the ring has room for. Requires submit_mutex.
+     */
+    void submitBacklog();
+
+    void completionLoop();
+
+    /**
+     * @brief Fails every queued and in-flight read once the ring has stopped working. Requires submit_mutex.
+     */
+    void failPending(int error);
+
+    void fallbackLoop();
+
+    /**
+     * @brief Records the outcome of one read call; reissues the rest of a short read,
+     * otherwise resumes the awaiting coroutine.
+     *
+     * @return Whether the request needs to be read again.
+     */
+    bool complete(Request* request, int64_t result);
+};
+
+#endif // _MEADOW_ASYNC_IO_HPP_
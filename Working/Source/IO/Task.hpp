@@ -0,0 +1,286 @@
+#ifndef _MEADOW_TASK_HPP_
+#define _MEADOW_TASK_HPP_
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "JobSystem.hpp"
+
+template <typename T>
+class Task;
+
+namespace TaskDetail {
+    /**
+     * @brief Resumes whoever awaited the task once it finishes, without growing the stack.
+     */
+    struct FinalAwaiter {
+        inline bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        inline void await_resume() const noexcept {}
+    };
+
+    struct PromiseBase {
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+
+        inline std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        inline FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        inline void unhandled_exception() { exception = std::current_exception(); }
+
+        inline void rethrow() const {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    };
+
+    template <typename T>
+    struct Promise : PromiseBase {
+        std::optional<T> value;
+
+        Task<T> get_return_object();
+
+        template <typename U>
+        void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+        T take() {
+            rethrow();
+            return std::move(*value);
+        }
+    };
+
+    template <>
+    struct Promise<void> : PromiseBase {
+        Task<void> get_return_object();
+
+        inline void return_void() const {}
+
+        inline void take() const { rethrow(); }
+    };
+
+    /**
+     * @brief A fire-and-forget coroutine that frees itself when it finishes.
+     */
+    struct Detached {
+        struct promise_type {
+            inline Detached get_return_object() const { return {}; }
+            inline std::suspend_never initial_suspend() const noexcept { return {}; }
+            inline std::suspend_never final_suspend() const noexcept { return {}; }
+            inline void return_void() const {}
+            inline void unhandled_exception() const { std::terminate(); }
+        };
+    };
+}
+
+/**
+ * @brief A lazily started coroutine producing a T.
+ *
+ * Nothing runs until the task is co_awaited (or handed to syncWait() or
+ * whenAll()); the awaiting coroutine is then resumed directly by the task's
+ * final suspend. Exceptions thrown inside the task are rethrown to the
+ * awaiter. Move-only; destroying an unfinished task that was started is a bug.
+ */
+template <typename T = void>
+class Task {
+public:
+    using promise_type = TaskDetail::Promise<T>;
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    Task() : handle(nullptr) {}
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    ~Task() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    inline bool await_ready() const noexcept { return !handle || handle.done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume() { return handle.promise().take(); }
+};
+
+namespace TaskDetail {
+    template <typename T>
+    Task<T> Promise<T>::get_return_object() {
+        return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> Promise<void>::get_return_object() {
+        return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+    }
+
+    /**
+     * @brief Shared by the tasks of one whenAll(); the last one to finish resumes the awaiter.
+     */
+    struct WhenAllState {
+        std::atomic<size_t> remaining;
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+        std::atomic<bool> failed;
+
+        explicit WhenAllState(size_t count) : remaining(count + 1), failed(false) {}
+
+        void arrive() {
+            if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                continuation.resume();
+            }
+        }
+    };
+
+    inline Detached runWhenAllTask(Task<void>& task, WhenAllState& state) {
+        try {
+            co_await task;
+        }
+        catch (...) {
+            if (!state.failed.exchange(true)) {
+                state.exception = std::current_exception();
+            }
+        }
+        state.arrive();
+    }
+
+    struct WhenAllAwaiter {
+        std::vector<Task<void>>& tasks;
+        WhenAllState& state;
+
+        inline bool await_ready() const noexcept { return tasks.empty(); }
+
+        bool await_suspend(std::coroutine_handle<> awaiting) {
+            state.continuation = awaiting;
+            for (Task<void>& task : tasks) {
+                runWhenAllTask(task, state);
+            }
+            // The extra count held while starting keeps every task from resuming us early;
+            // if they all finished synchronously, carry on without suspending
+            return state.remaining.fetch_sub(1, std::memory_order_acq_rel) != 1;
+        }
+
+        inline void await_resume() const {}
+    };
+
+    template <typename T>
+    Task<void> storeResult(Task<T> task, std::optional<T>& result) {
+        result.emplace(co_await task);
+    }
+}
+
+/**
+ * @brief Runs every task concurrently and finishes once all of them have.
+ * If any task throws, the first exception is rethrown after the rest are done.
+ */
+inline Task<void> whenAll(std::vector<Task<void>> tasks) {
+    TaskDetail::WhenAllState state(tasks.size());
+    co_await TaskDetail::WhenAllAwaiter{tasks, state};
+    if (state.exception) {
+        std::rethrow_exception(state.exception);
+    }
+}
+
+/**
+ * @brief Runs every task concurrently and returns their results in the same order.
+ */
+template <typename T>
+Task<std::vector<T>> whenAll(std::vector<Task<T>> tasks) {
+    std::vector<std::optional<T>> results(tasks.size());
+    std::vector<Task<void>> stores;
+    stores.reserve(tasks.size());
+    for (size_t i = 0; i < tasks.size(); i++) {
+        stores.push_back(TaskDetail::storeResult(std::move(tasks[i]), results[i]));
+    }
+    co_await whenAll(std::move(stores));
+
+    std::vector<T> values;
+    values.reserve(results.size());
+    for (std::optional<T>& result : results) {
+        values.push_back(std::move(*result));
+    }
+    co_return values;
+}
+
+namespace TaskDetail {
+    template <typename T>
+    struct SyncState {
+        std::atomic<bool> done;
+        std::exception_ptr exception;
+        std::optional<std::conditional_t<std::is_void_v<T>, bool, T>> result;
+    };
+
+    template <typename T>
+    Detached runSync(Task<T>& task, SyncState<T>& state) {
+        try {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+                state.result.emplace(true);
+            }
+            else {
+                state.result.emplace(co_await task);
+            }
+        }
+        catch (...) {
+            state.exception = std::current_exception();
+        }
+        state.done.store(true, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Blocks until the task finishes and returns its result, running jobs in the meantime
+ * so that continuations scheduled on the system can make progress even without workers.
+ */
+template <typename T>
+T syncWait(Task<T> task, JobSystem& jobs) {
+    TaskDetail::SyncState<T> state {};
+    TaskDetail::runSync(task, state);
+
+    while (!state.done.load(std::memory_order_acquire)) {
+        if (!jobs.runPending()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (state.exception) {
+        std::rethrow_exception(state.exception);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        return std::move(*state.result);
+    }
+}
+
+#endif // _MEADOW_TASK_HPP_
@@ -0,0 +1,198 @@
+#include "JobSystem.hpp"
+#include <algorithm>
+
+namespace {
+    // Which system's deque, if any, the current thread owns
+    thread_local JobSystem* current_system = nullptr;
+    thread_local uint32_t current_index = 0;
+
+    constexpr uint32_t IDLE_SPINS = 64;
+}
+
+JobSystem::JobSystem(uint32_t worker_count) :
+    queued_jobs(0),
+    sleeping_workers(0),
+    stopping(false)
+{
+    if (worker_count == DEFAULT_WORKERS) {
+        worker_count = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    }
+
+    for (uint32_t i = 0; i <= worker_count; i++) {
+        deques.push_back(std::make_unique<WorkStealingDeque<Job>>(DEQUE_CAPACITY));
+    }
+
+    current_system = this;
+    current_index = 0;
+
+    workers.reserve(worker_count);
+    for (uint32_t i = 1; i <= worker_count; i++) {
+        workers.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    stopping.store(true);
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        wake.notify_all();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (current_system == this) {
+        current_system = nullptr;
+    }
+}
+
+void JobSystem::schedule(std::function<void()> function, JobCounter* signal, JobCounter* dependency) {
+    Job* job = new Job{std::move(function), signal};
+    if (signal) {
+        signal->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (dependency) {
+        // finish() empties the list under the same lock after the counter hits zero,
+        // so the job is either picked up there or the counter is already zero here
+        std::lock_guard<std::mutex> lock(dependency->mutex);
+        if (!dependency->isDone()) {
+            dependency->continuations.push_back(job);
+            return;
+        }
+    }
+
+    enqueue(job);
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone() || counter.finishing.load(std::memory_order_acquire) > 0) {
+        if (!runPending()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+bool JobSystem::runPending() {
+    Job* job = findJob();
+    if (job) {
+        run(job);
+    }
+    return job != nullptr;
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t batch_size, const std::function<void(uint32_t, uint32_t)>& body) {
+    if (count == 0) {
+        return;
+    }
+    batch_size = std::max(1u, batch_size);
+    if (count <= batch_size) {
+        body(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (uint32_t begin = 0; begin < count; begin += batch_size) {
+        uint32_t end = std::min(begin + batch_size, count);
+        schedule([&body, begin, end]() { body(begin, end); }, &counter);
+    }
+    wait(counter);
+}
+
+void JobSystem::workerLoop(uint32_t index) {
+    current_system = this;
+    current_index = index;
+
+    uint32_t idle = 0;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        if (Job* job = findJob()) {
+            run(job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < IDLE_SPINS) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Announce the sleep before checking for work; enqueue() checks for sleepers after
+        // publishing work, so one of the two always sees the other
+        sleeping_workers.fetch_add(1);
+        {
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            wake.wait(lock, [this]() { return queued_jobs.load() > 0 || stopping.load(); });
+        }
+        sleeping_workers.fetch_sub(1);
+        idle = 0;
+    }
+}
+
+void JobSystem::enqueue(Job* job) {
+    bool pushed = current_system == this && deques[current_index]->push(job);
+    if (!pushed) {
+        std::lock_guard<std::mutex> lock(injected_mutex);
+        injected.push_back(job);
+    }
+
+    queued_jobs.fetch_add(1);
+    if (sleeping_workers.load() > 0) {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        wake.notify_one();
+    }
+}
+
+Job* JobSystem::findJob() {
+    Job* job = nullptr;
+
+    if (current_system == this) {
+        job = deques[current_index]->pop();
+    }
+
+    if (!job && queued_jobs.load(std::memory_order_relaxed) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(injected_mutex);
+            if (!injected.empty()) {
+                job = injected.front();
+                injected.pop_front();
+            }
+        }
+
+        // Steal from the other deques, starting after our own so thieves spread out
+        uint32_t start = current_system == this ? current_index : 0;
+        for (uint32_t i = 1; i <= deques.size() && !job; i++) {
+            job = deques[(start + i) % deques.size()]->steal();
+        }
+    }
+
+    if (job) {
+        queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+void JobSystem::run(Job* job) {
+    job->function();
+    if (job->signal) {
+        finish(*job->signal);
+    }
+    delete job;
+}
+
+void JobSystem::finish(JobCounter& counter) {
+    // A waiter may destroy the counter as soon as it sees zero, so keep it alive until
+    // this job is done touching it
+    counter.finishing.fetch_add(1, std::memory_order_relaxed);
+
+    std::vector<Job*> ready;
+    if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        std::lock_guard<std::mutex> lock(counter.mutex);
+        ready.swap(counter.continuations);
+    }
+
+    counter.finishing.fetch_sub(1, std::memory_order_release);
+
+    for (Job* job : ready) {
+        enqueue(job);
+    }
+}
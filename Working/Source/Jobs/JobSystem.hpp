@@ -0,0 +1,127 @@
+#ifndef _MEADOW_JOB_SYSTEM_HPP_
+#define _MEADOW_JOB_SYSTEM_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "WorkStealingDeque.hpp"
+
+struct Job;
+
+/**
+ * @brief Counts unfinished jobs. Jobs signal it when they finish; JobSystem::wait() blocks
+ * on it, and jobs scheduled with it as a dependency start once it reaches zero.
+ * Only destroy a counter after wait() on it has returned.
+ */
+class JobCounter {
+    friend class JobSystem;
+
+    std::atomic<uint32_t> pending;
+    std::atomic<uint32_t> finishing; /**< Jobs still inside finish(), which may touch the counter. */
+    std::mutex mutex;
+    std::vector<Job*> continuations;
+
+public:
+    JobCounter() : pending(0), finishing(0) {}
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    inline bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+};
+
+struct Job {
+    std::function<void()> function;
+    JobCounter* signal;
+};
+
+/**
+ * @brief A fixed pool of worker threads sharing work by stealing.
+ *
+ * Each worker, and the thread that created the system, owns a Chase-Lev
+ * deque. Jobs scheduled from a worker go to its own deque and run newest
+ * first, which keeps recently touched data in cache; idle workers steal the
+ * oldest jobs from others. Jobs scheduled from any other thread go through a
+ * shared injection queue. Workers with nothing to do sleep until new work arrives.
+ *
+ * The creating thread is not a worker; it runs jobs only while it waits.
+ */
+class JobSystem {
+    static constexpr uint32_t DEQUE_CAPACITY = 4096;
+
+    std::vector<std::unique_ptr<WorkStealingDeque<Job>>> deques; /**< [0] belongs to the creating thread. */
+    std::vector<std::thread> workers;
+
+    std::mutex injected_mutex;
+    std::deque<Job*> injected;
+
+    std::atomic<uint32_t> queued_jobs;
+    std::atomic<uint32_t> sleeping_workers;
+    std::atomic<bool> stopping;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+
+public:
+    static constexpr uint32_t DEFAULT_WORKERS = UINT32_MAX;
+
+    /**
+     * @param worker_count Background threads to start; by default one per hardware thread, minus the caller's.
+     * With 0, jobs only run while the creating thread waits.
+     */
+    explicit JobSystem(uint32_t worker_count = DEFAULT_WORKERS);
+
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * @brief Queues a job.
+     *
+     * @param signal Incremented now and decremented when the job finishes.
+     * @param dependency The job is held back until this counter reaches zero.
+     */
+    void schedule(std::function<void()> function, JobCounter* signal = nullptr, JobCounter* dependency = nullptr);
+
+    /**
+     * @brief Runs other jobs until the counter reaches zero.
+     */
+    void wait(JobCounter& counter);
+
+    /**
+     * @brief Runs one queued job on the calling thread, if there is one.
+     *
+     * @return Whether a job ran.
+     */
+    bool runPending();
+
+    /**
+     * @brief Calls body(begin, end) over [0, count) in batches of at most batch_size, spread
+     * across the pool, and returns once every batch has run.
+     */
+    void parallelFor(uint32_t count, uint32_t batch_size, const std::function<void(uint32_t, uint32_t)>& body);
+
+    /**
+     * @brief Worker threads plus the creating thread.
+     */
+    inline uint32_t getThreadCount() const { return (uint32_t)deques.size(); }
+
+private:
+    void workerLoop(uint32_t index);
+
+    void enqueue(Job* job);
+
+    Job* findJob();
+
+    void run(Job* job);
+
+    void finish(JobCounter& counter);
+};
+
+#endif // _MEADOW_JOB_SYSTEM_HPP_
@@ -0,0 +1,99 @@
+#ifndef _MEADOW_WORK_STEALING_DEQUE_HPP_
+#define _MEADOW_WORK_STEALING_DEQUE_HPP_
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+
+/**
+ * @brief A fixed-capacity Chase-Lev deque of pointers.
+ *
+ * The owning thread pushes and pops at the bottom without contention; any
+ * other thread may steal from the top. Only the last remaining element needs
+ * a compare-and-swap to settle a race between its owner and a thief. Memory
+ * orderings follow Lê et al., "Correct and Efficient Work-Stealing for Weak
+ * Memory Models" (2013).
+ */
+template <typename T>
+class WorkStealingDeque {
+    std::atomic<int64_t> top;
+    std::atomic<int64_t> bottom;
+    const int64_t mask;
+    std::unique_ptr<std::atomic<T*>[]> buffer;
+
+public:
+    /**
+     * @param capacity Rounded up to a power of two.
+     */
+    explicit WorkStealingDeque(uint32_t capacity) :
+        top(0),
+        bottom(0),
+        mask((int64_t)std::bit_ceil(capacity) - 1),
+        buffer(new std::atomic<T*>[std::bit_ceil(capacity)])
+    {}
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /**
+     * @brief Owner only. Fails when the deque is full.
+     */
+    bool push(T* item) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        if (b - t > mask) {
+            return false;
+        }
+
+        buffer[b & mask].store(item, std::memory_order_relaxed);
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Owner only. Takes the most recently pushed item, or nullptr.
+     */
+    T* pop() {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        T* item = buffer[b & mask].load(std::memory_order_relaxed);
+        if (t == b) {
+            // Last item: race any thief for it
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    /**
+     * @brief Any thread. Takes the oldest item, or nullptr if empty or another thread won it.
+     */
+    T* steal() {
+        int64_t t = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return nullptr;
+        }
+
+        T* item = buffer[t & mask].load(std::memory_order_relaxed);
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+};
+
+#endif // _MEADOW_WORK_STEALING_DEQUE_HPP_
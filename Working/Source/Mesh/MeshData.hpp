@@ -0,0 +1,25 @@
+#ifndef _MEADOW_MESH_DATA_HPP_
+#define _MEADOW_MESH_DATA_HPP_
+
+#include <cstdint>
+#include <vector>
+#include "Math.hpp"
+
+/**
+ * @brief A full-precision vertex, as meshes arrive from import.
+ */
+struct MeshVertex {
+    Math::Vec3 position;
+    Math::Vec3 normal;
+    float uv[2];
+};
+
+/**
+ * @brief An indexed triangle list at full precision, before optimization and packing.
+ */
+struct MeshData {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+#endif // _MEADOW_MESH_DATA_HPP_
@@ -0,0 +1,101 @@
+#include "MeshLod.hpp"
+#include "MeshOptimizer.hpp"
+#include "MeshSimplifier.hpp"
+#include "Config.h"
+#include <cmath>
+#include <limits>
+
+namespace {
+    // A level that doesn't get at least this much smaller than the last isn't worth keeping
+    constexpr float MIN_LEVEL_REDUCTION = 0.9f;
+
+    // Budget enforcement doubles the threshold at most this many times per selection
+    constexpr uint32_t MAX_BUDGET_STEPS = 12;
+}
+
+MeshLods MeshLods::generate(const MeshData& mesh, float reduction) {
+    std::vector<std::vector<uint32_t>> levels {mesh.indices};
+    std::vector<float> errors {0.0f};
+
+    while (levels.size() < CONSTANTS::LOD_MAX_LEVELS) {
+        const std::vector<uint32_t>& previous = levels.back();
+        size_t target = (size_t)(previous.size() / 3 * reduction) * 3;
+
+        float step_error = 0.0f;
+        std::vector<uint32_t> simplified = MeshSimplifier::simplify(previous, mesh.vertices, target,
+            std::numeric_limits<float>::max(), &step_error);
+        if (simplified.empty() || simplified.size() > previous.size() * MIN_LEVEL_REDUCTION) {
+            break;
+        }
+
+        // Each level is simplified from the last, so its deviation from the original adds up
+        errors.push_back(errors.back() + step_error);
+        levels.push_back(std::move(simplified));
+    }
+
+    MeshLods result;
+    result.mesh.vertices = mesh.vertices;
+    for (size_t i = 0; i < levels.size(); i++) {
+        MeshOptimizer::optimizeVertexCache(levels[i], (uint32_t)mesh.vertices.size());
+        MeshOptimizer::optimizeOverdraw(levels[i], mesh.vertices);
+
+        result.lods.push_back({
+            .index_offset = (uint32_t)result.mesh.indices.size(),
+            .index_count = (uint32_t)levels[i].size(),
+            .error = errors[i]
+        });
+        result.mesh.indices.insert(result.mesh.indices.end(), levels[i].begin(), levels[i].end());
+    }
+
+    // Remapping over the concatenation orders vertices by first use in the finest level, and
+    // coarser levels only use a subset of those
+    MeshOptimizer::optimizeVertexFetch(result.mesh.indices, result.mesh.vertices);
+    return result;
+}
+
+LodSelector::LodSelector(float viewport_height, float vertical_fov) : effective_pixel_error(CONSTANTS::LOD_PIXEL_ERROR) {
+    setProjection(viewport_height, vertical_fov);
+}
+
+void LodSelector::setProjection(float viewport_height, float vertical_fov) {
+    // Pixels covered by one unit at unit distance
+    projection_scale = viewport_height / (2.0f * std::tan(vertical_fov * 0.5f));
+}
+
+uint32_t LodSelector::select(const std::vector<MeshLod>& lods, float distance, float scale, float pixel_error) const {
+    if (distance <= 0.0f) {
+        return 0;
+    }
+
+    const float pixels_per_unit = scale * projection_scale / distance;
+    for (uint32_t level = (uint32_t)lods.size(); level-- > 1;) {
+        if (lods[level].error * pixels_per_unit <= pixel_error) {
+            return level;
+        }
+    }
+    return 0;
+}
+
+uint64_t LodSelector::selectAll(const std::vector<Query>& queries, std::vector<uint32_t>& selected) {
+    selected.resize(queries.size());
+
+    float threshold = CONSTANTS::LOD_PIXEL_ERROR;
+    uint64_t triangles = 0;
+    for (uint32_t step = 0; step <= MAX_BUDGET_STEPS; step++) {
+        triangles = 0;
+        bool all_coarsest = true;
+        for (size_t i = 0; i < queries.size(); i++) {
+            const std::vector<MeshLod>& lods = *queries[i].lods;
+            selected[i] = select(lods, queries[i].distance, queries[i].scale, threshold);
+            triangles += lods[selected[i]].index_count / 3;
+            all_coarsest = all_coarsest && selected[i] + 1 == lods.size();
+        }
+        if (triangles <= CONSTANTS::LOD_TRIANGLE_BUDGET || all_coarsest || step == MAX_BUDGET_STEPS) {
+            break;
+        }
+        threshold *= 2.0f;
+    }
+
+    effective_pixel_error = threshold;
+    return triangles;
+}
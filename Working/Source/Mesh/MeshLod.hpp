@@ -0,0 +1,89 @@
+#ifndef _MEADOW_MESH_LOD_HPP_
+#define _MEADOW_MESH_LOD_HPP_
+
+#include <cstdint>
+#include <vector>
+#include "MeshData.hpp"
+
+/**
+ * @brief One level of detail: a range of the shared index buffer and how far it may deviate
+ * from the full-detail mesh, in the mesh's own units.
+ */
+struct MeshLod {
+    uint32_t index_offset;
+    uint32_t index_count;
+    float error;
+};
+
+/**
+ * @brief A mesh with its chain of discrete LODs, finest first.
+ *
+ * All levels index one shared vertex buffer, and their index lists are
+ * concatenated into mesh.indices, so the whole chain packs and uploads as a
+ * single PackedMesh.
+ */
+struct MeshLods {
+    MeshData mesh;
+    std::vector<MeshLod> lods;
+
+    /**
+     * @brief Builds the chain offline: each level is simplified from the previous one to
+     * reduction times its triangles, up to CONSTANTS::LOD_MAX_LEVELS or until simplification
+     * stalls, and every level is then optimized for the vertex cache and overdraw.
+     */
+    static MeshLods generate(const MeshData& mesh, float reduction = 0.5f);
+};
+
+/**
+ * @brief Picks a LOD per object from its projected screen-space error.
+ *
+ * An object gets the coarsest level whose error, projected to the screen at
+ * the object's distance, stays under CONSTANTS::LOD_PIXEL_ERROR. Since an object's
+ * projected size shrinks with distance just like its error does, the
+ * triangles it contributes per covered pixel stay roughly constant, so total
+ * triangle throughput tracks screen coverage rather than object count. When
+ * the selection would still exceed CONSTANTS::LOD_TRIANGLE_BUDGET, the
+ * threshold is raised for that frame until it fits.
+ */
+class LodSelector {
+public:
+    struct Query {
+        const std::vector<MeshLod>* lods;
+        float distance; /**< From the camera to the object's bounding sphere surface, 0 if inside it. */
+        float scale;    /**< Largest scale factor of the object's world transform. */
+    };
+
+private:
+    float projection_scale;
+    float effective_pixel_error;
+
+public:
+    /**
+     * @param viewport_height In pixels.
+     * @param vertical_fov In radians.
+     */
+    LodSelector(float viewport_height, float vertical_fov);
+
+    void setProjection(float viewport_height, float vertical_fov);
+
+    /**
+     * @brief The coarsest level whose projected error is within pixel_error.
+     */
+    uint32_t select(const std::vector<MeshLod>& lods, float distance, float scale, float pixel_error) const;
+
+    /**
+     * @brief Selects a level for every query, raising the threshold as needed to stay within
+     * the triangle budget.
+     *
+     * @param selected Receives one level index per query.
+     * @return The triangles the selection draws.
+     */
+    uint64_t selectAll(const std::vector<Query>& queries, std::vector<uint32_t>& selected);
+
+    /**
+     * @brief The pixel threshold the last selectAll() ended up using.
+     */
+    inline float getEffectivePixelError() const { return effective_pixel_error; }
+};
+
+#endif // _MEADOW_MESH_LOD_HPP_
@@ -0,0 +1,311 @@
+#include "MeshOptimizer.hpp"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+    // Forsyth's tuning: a 32-entry LRU cache, with the last triangle's vertices scored flat
+    // so the next triangle does not simply reuse the same edge every time
+    constexpr uint32_t SCORING_CACHE_SIZE = 32;
+    constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+    constexpr float CACHE_DECAY_POWER = 1.5f;
+    constexpr float VALENCE_BOOST_SCALE = 2.0f;
+
+    // The cache overdraw clustering and analysis simulate, closer to real hardware
+    constexpr uint32_t FIFO_CACHE_SIZE = 16;
+
+    float vertexScore(int cache_position, uint32_t remaining_triangles) {
+        if (remaining_triangles == 0) {
+            return -1.0f;
+        }
+
+        float score = 0.0f;
+        if (cache_position >= 0) {
+            if (cache_position < 3) {
+                score = LAST_TRIANGLE_SCORE;
+            }
+            else {
+                float fraction = 1.0f - (float)(cache_position - 3) / (SCORING_CACHE_SIZE - 3);
+                score = std::pow(fraction, CACHE_DECAY_POWER);
+            }
+        }
+        return score + VALENCE_BOOST_SCALE / std::sqrt((float)remaining_triangles);
+    }
+
+    /**
+     * @brief A FIFO vertex cache tracked with insertion timestamps, so resetting it is O(1).
+     */
+    class FifoCache {
+        std::vector<uint32_t> inserted;
+        uint32_t time;
+        uint32_t size;
+
+    public:
+        FifoCache(uint32_t vertex_count, uint32_t size) : inserted(vertex_count, 0), time(size + 1), size(size) {}
+
+        /**
+         * @return 1 on a miss, 0 on a hit.
+         */
+        uint32_t access(uint32_t vertex) {
+            if (time - inserted[vertex] > size) {
+                inserted[vertex] = time++;
+                return 1;
+            }
+            return 0;
+        }
+
+        uint32_t accessTriangle(const uint32_t* triangle) {
+            return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+        }
+
+        void reset() {
+            time += size + 1;
+        }
+    };
+}
+
+void MeshOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertex_count) {
+    const uint32_t triangle_count = (uint32_t)indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    // Triangles around each vertex; the first remaining[v] entries are the ones not yet emitted
+    std::vector<uint32_t> remaining(vertex_count, 0);
+    for (uint32_t index : indices) {
+        remaining[index]++;
+    }
+    std::vector<uint32_t> adjacency_offset(vertex_count + 1, 0);
+    for (uint32_t v = 0; v < vertex_count; v++) {
+        adjacency_offset[v + 1] = adjacency_offset[v] + remaining[v];
+    }
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> cursor(adjacency_offset.begin(), adjacency_offset.end() - 1);
+        for (uint32_t i = 0; i < indices.size(); i++) {
+            adjacency[cursor[indices[i]]++] = i / 3;
+        }
+    }
+
+    std::vector<int> cache_position(vertex_count, -1);
+    std::vector<float> vertex_score(vertex_count);
+    for (uint32_t v = 0; v < vertex_count; v++) {
+        vertex_score[v] = vertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangle_score(triangle_count);
+    std::vector<bool> emitted(triangle_count, false);
+    for (uint32_t t = 0; t < triangle_count; t++) {
+        triangle_score[t] = vertex_score[indices[t * 3]] + vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+    }
+
+    int64_t best = std::max_element(triangle_score.begin(), triangle_score.end()) - triangle_score.begin();
+    uint32_t scan = 0;
+
+    std::vector<uint32_t> cache;
+    std::vector<uint32_t> new_cache;
+    cache.reserve(SCORING_CACHE_SIZE + 3);
+    new_cache.reserve(SCORING_CACHE_SIZE + 3);
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+
+    while (result.size() < indices.size()) {
+        if (best < 0) {
+            // Nothing around the cache is left; restart from the first unemitted triangle
+            while (emitted[scan]) {
+                scan++;
+            }
+            best = scan;
+        }
+
+        const uint32_t* triangle = &indices[best * 3];
+        emitted[best] = true;
+        result.insert(result.end(), triangle, triangle + 3);
+
+        new_cache.clear();
+        for (int corner = 0; corner < 3; corner++) {
+            uint32_t v = triangle[corner];
+
+            uint32_t* begin = &adjacency[adjacency_offset[v]];
+            uint32_t* end = begin + remaining[v];
+            *std::find(begin, end, (uint32_t)best) = *(end - 1);
+            remaining[v]--;
+
+            if (std::find(new_cache.begin(), new_cache.end(), v) == new_cache.end()) {
+                new_cache.push_back(v);
+            }
+        }
+        for (uint32_t v : cache) {
+            if (std::find(new_cache.begin(), new_cache.end(), v) == new_cache.end()) {
+                new_cache.push_back(v);
+            }
+        }
+
+        // Rescore everything that was or is now cached, including what just fell out
+        for (uint32_t i = 0; i < new_cache.size(); i++) {
+            uint32_t v = new_cache[i];
+            cache_position[v] = i < SCORING_CACHE_SIZE ? (int)i : -1;
+            vertex_score[v] = vertexScore(cache_position[v], remaining[v]);
+        }
+
+        best = -1;
+        float best_score = -1.0f;
+        for (uint32_t v : new_cache) {
+            for (uint32_t a = adjacency_offset[v]; a < adjacency_offset[v] + remaining[v]; a++) {
+                uint32_t t = adjacency[a];
+                const uint32_t* adjacent = &indices[t * 3];
+                triangle_score[t] = vertex_score[adjacent[0]] + vertex_score[adjacent[1]] + vertex_score[adjacent[2]];
+                if (triangle_score[t] > best_score) {
+                    best_score = triangle_score[t];
+                    best = t;
+                }
+            }
+        }
+
+        new_cache.resize(std::min<size_t>(new_cache.size(), SCORING_CACHE_SIZE));
+        std::swap(cache, new_cache);
+    }
+
+    indices = std::move(result);
+}
+
+void MeshOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices, float threshold) {
+    const uint32_t triangle_count = (uint32_t)indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    FifoCache cache((uint32_t)vertices.size(), FIFO_CACHE_SIZE);
+
+    // Hard boundaries: triangles that miss the cache on every vertex start a new run anyway
+    std::vector<uint32_t> hard_boundaries {0};
+    cache.accessTriangle(&indices[0]);
+    for (uint32_t t = 1; t < triangle_count; t++) {
+        if (cache.accessTriangle(&indices[t * 3]) == 3) {
+            hard_boundaries.push_back(t);
+        }
+    }
+    hard_boundaries.push_back(triangle_count);
+
+    // Soft boundaries: split a run again as soon as the part so far, started with a cold cache,
+    // is within threshold of the whole run's miss ratio
+    std::vector<uint32_t> clusters;
+    for (uint32_t h = 0; h + 1 < hard_boundaries.size(); h++) {
+        uint32_t begin = hard_boundaries[h];
+        uint32_t end = hard_boundaries[h + 1];
+
+        cache.reset();
+        uint32_t run_misses = 0;
+        for (uint32_t t = begin; t < end; t++) {
+            run_misses += cache.accessTriangle(&indices[t * 3]);
+        }
+        float target = threshold * run_misses / (end - begin);
+
+        cache.reset();
+        clusters.push_back(begin);
+        uint32_t cluster_begin = begin;
+        uint32_t misses = 0;
+        for (uint32_t t = begin; t + 1 < end; t++) {
+            misses += cache.accessTriangle(&indices[t * 3]);
+            if (misses <= target * (t - cluster_begin + 1)) {
+                clusters.push_back(t + 1);
+                cache.reset();
+                cluster_begin = t + 1;
+                misses = 0;
+            }
+        }
+    }
+    clusters.push_back(triangle_count);
+
+    const uint32_t cluster_count = (uint32_t)clusters.size() - 1;
+    std::vector<Math::Vec3> cluster_centroid(cluster_count, {0.0f, 0.0f, 0.0f});
+    std::vector<Math::Vec3> cluster_normal(cluster_count, {0.0f, 0.0f, 0.0f});
+    Math::Vec3 mesh_centroid {0.0f, 0.0f, 0.0f};
+    float mesh_area = 0.0f;
+
+    for (uint32_t c = 0; c < cluster_count; c++) {
+        float cluster_area = 0.0f;
+        for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++) {
+            const Math::Vec3& a = vertices[indices[t * 3]].position;
+            const Math::Vec3& b = vertices[indices[t * 3 + 1]].position;
+            const Math::Vec3& p = vertices[indices[t * 3 + 2]].position;
+
+            // Area-weighted, so slivers do not pull the cluster around
+            Math::Vec3 normal = Math::cross(b - a, p - a);
+            float area = Math::length(normal);
+            Math::Vec3 centroid = (a + b + p) * (1.0f / 3.0f);
+
+            cluster_centroid[c] = cluster_centroid[c] + centroid * area;
+            cluster_normal[c] = cluster_normal[c] + normal;
+            cluster_area += area;
+        }
+
+        mesh_centroid = mesh_centroid + cluster_centroid[c];
+        mesh_area += cluster_area;
+        if (cluster_area > 0.0f) {
+            cluster_centroid[c] = cluster_centroid[c] * (1.0f / cluster_area);
+        }
+    }
+    if (mesh_area > 0.0f) {
+        mesh_centroid = mesh_centroid * (1.0f / mesh_area);
+    }
+
+    std::vector<float> sort_key(cluster_count, 0.0f);
+    for (uint32_t c = 0; c < cluster_count; c++) {
+        float normal_length = Math::length(cluster_normal[c]);
+        if (normal_length > 0.0f) {
+            sort_key[c] = Math::dot(cluster_centroid[c] - mesh_centroid, cluster_normal[c] * (1.0f / normal_length));
+        }
+    }
+
+    std::vector<uint32_t> order(cluster_count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sort_key[a] > sort_key[b]; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (uint32_t c : order) {
+        result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    indices = std::move(result);
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<uint32_t>& indices, std::vector<MeshVertex>& vertices) {
+    std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+    uint32_t next = 0;
+    for (uint32_t& index : indices) {
+        if (remap[index] == UINT32_MAX) {
+            remap[index] = next++;
+        }
+        index = remap[index];
+    }
+
+    std::vector<MeshVertex> remapped(next);
+    for (uint32_t v = 0; v < vertices.size(); v++) {
+        if (remap[v] != UINT32_MAX) {
+            remapped[remap[v]] = vertices[v];
+        }
+    }
+    vertices = std::move(remapped);
+}
+
+void MeshOptimizer::optimize(MeshData& mesh, float overdraw_threshold) {
+    optimizeVertexCache(mesh.indices, (uint32_t)mesh.vertices.size());
+    optimizeOverdraw(mesh.indices, mesh.vertices, overdraw_threshold);
+    optimizeVertexFetch(mesh.indices, mesh.vertices);
+}
+
+float MeshOptimizer::analyzeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertex_count, uint32_t cache_size) {
+    const uint32_t triangle_count = (uint32_t)indices.size() / 3;
+    if (triangle_count == 0) {
+        return 0.0f;
+    }
+
+    FifoCache cache(vertex_count, cache_size);
+    uint32_t misses = 0;
+    for (uint32_t t = 0; t < triangle_count; t++) {
+        misses += cache.accessTriangle(&indices[t * 3]);
+    }
+    return (float)misses / triangle_count;
+}
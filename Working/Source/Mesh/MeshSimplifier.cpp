@@ -0,0 +1,304 @@
+#include "MeshSimplifier.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <unordered_map>
+
+namespace {
+    // Border planes count this much more than surface planes, so outlines barely move
+    constexpr double BORDER_WEIGHT = 10.0;
+
+    // A collapse is rejected if it turns any remaining triangle by more than about 75 degrees
+    constexpr double MIN_NORMAL_COSINE = 0.25;
+
+    /**
+     * @brief A sum of weighted squared plane distances: Q(p) = p.A.p + 2 b.p + c.
+     */
+    struct Quadric {
+        double a00, a01, a02, a11, a12, a22;
+        double b0, b1, b2;
+        double c;
+        double weight;
+
+        static Quadric fromPlane(const Math::Vec3& normal, double distance, double weight) {
+            double x = normal.x, y = normal.y, z = normal.z;
+            return {
+                weight * x * x, weight * x * y, weight * x * z, weight * y * y, weight * y * z, weight * z * z,
+                weight * x * distance, weight * y * distance, weight * z * distance,
+                weight * distance * distance,
+                weight
+            };
+        }
+
+        Quadric& operator+=(const Quadric& other) {
+            a00 += other.a00; a01 += other.a01; a02 += other.a02;
+            a11 += other.a11; a12 += other.a12; a22 += other.a22;
+            b0 += other.b0; b1 += other.b1; b2 += other.b2;
+            c += other.c;
+            weight += other.weight;
+            return *this;
+        }
+
+        double evaluate(const Math::Vec3& p) const {
+            double x = p.x, y = p.y, z = p.z;
+            double value = a00 * x * x + a11 * y * y + a22 * z * z
+                + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+                + 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+            return std::max(0.0, value);
+        }
+    };
+
+    enum class VertexKind : uint8_t {
+        Manifold, /**< Interior vertex; may collapse along any edge. */
+        Border,   /**< On one open border; may only collapse along it. */
+        Locked    /**< On a seam, a border corner or non-manifold geometry; never moves. */
+    };
+
+    struct Collapse {
+        uint32_t from;
+        uint32_t to;
+        double error;
+    };
+
+    uint64_t edgeKey(uint32_t a, uint32_t b) {
+        return (uint64_t)a << 32 | b;
+    }
+
+    Math::Vec3 triangleNormal(const Math::Vec3& a, const Math::Vec3& b, const Math::Vec3& c) {
+        return Math::cross(b - a, c - a);
+    }
+}
+
+std::vector<uint32_t> MeshSimplifier::simplify(const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+    size_t target_index_count, float max_error, float* result_error)
+{
+    const uint32_t vertex_count = (uint32_t)vertices.size();
+
+    // Vertices sharing a position form one group: they move together or not at all
+    std::vector<uint32_t> group(vertex_count);
+    std::vector<uint32_t> group_size(vertex_count, 0);
+    {
+        struct PositionHash {
+            size_t operator()(const Math::Vec3& p) const {
+                return std::bit_cast<uint32_t>(p.x) * 73856093u ^ std::bit_cast<uint32_t>(p.y) * 19349663u ^ std::bit_cast<uint32_t>(p.z) * 83492791u;
+            }
+        };
+        struct PositionEqual {
+            bool operator()(const Math::Vec3& a, const Math::Vec3& b) const { return a.x == b.x && a.y == b.y && a.z == b.z; }
+        };
+        std::unordered_map<Math::Vec3, uint32_t, PositionHash, PositionEqual> first_at;
+        first_at.reserve(vertex_count);
+        for (uint32_t v = 0; v < vertex_count; v++) {
+            group[v] = first_at.try_emplace(vertices[v].position, v).first->second;
+            group_size[group[v]]++;
+        }
+    }
+
+    // Directed edges between groups; an edge with no twin running the other way is a border
+    std::unordered_map<uint64_t, uint32_t> edge_uses;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        for (int corner = 0; corner < 3; corner++) {
+            uint32_t a = group[indices[i + corner]];
+            uint32_t b = group[indices[i + (corner + 1) % 3]];
+            if (a != b) {
+                edge_uses[edgeKey(a, b)]++;
+            }
+        }
+    }
+    auto isBorder = [&](uint32_t a, uint32_t b) { return !edge_uses.contains(edgeKey(b, a)); };
+
+    std::vector<uint32_t> border_edges(vertex_count, 0);
+    std::vector<bool> non_manifold(vertex_count, false);
+    for (const auto& [key, uses] : edge_uses) {
+        uint32_t a = (uint32_t)(key >> 32);
+        uint32_t b = (uint32_t)key;
+        if (uses > 1) {
+            non_manifold[a] = non_manifold[b] = true;
+        }
+        if (isBorder(a, b)) {
+            border_edges[a]++;
+            border_edges[b]++;
+        }
+    }
+
+    std::vector<VertexKind> kind(vertex_count, VertexKind::Locked);
+    for (uint32_t v = 0; v < vertex_count; v++) {
+        if (group[v] != v || group_size[v] > 1 || non_manifold[v]) {
+            continue;
+        }
+        if (border_edges[v] == 0) {
+            kind[v] = VertexKind::Manifold;
+        }
+        else if (border_edges[v] == 2) {
+            kind[v] = VertexKind::Border;
+        }
+    }
+
+    std::vector<Quadric> quadrics(vertex_count, Quadric {});
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        const Math::Vec3* corners[3];
+        for (int corner = 0; corner < 3; corner++) {
+            corners[corner] = &vertices[indices[i + corner]].position;
+        }
+        Math::Vec3 normal = triangleNormal(*corners[0], *corners[1], *corners[2]);
+        float double_area = Math::length(normal);
+        if (double_area == 0.0f) {
+            continue;
+        }
+        normal = normal * (1.0f / double_area);
+
+        Quadric plane = Quadric::fromPlane(normal, -Math::dot(normal, *corners[0]), double_area * 0.5);
+        for (int corner = 0; corner < 3; corner++) {
+            quadrics[group[indices[i + corner]]] += plane;
+        }
+
+        for (int corner = 0; corner < 3; corner++) {
+            uint32_t a = group[indices[i + corner]];
+            uint32_t b = group[indices[i + (corner + 1) % 3]];
+            if (a == b || !isBorder(a, b)) {
+                continue;
+            }
+            Math::Vec3 edge = *corners[(corner + 1) % 3] - *corners[corner];
+            Math::Vec3 border_normal = Math::cross(edge, normal);
+            float border_length = Math::length(border_normal);
+            if (border_length == 0.0f) {
+                continue;
+            }
+            border_normal = border_normal * (1.0f / border_length);
+
+            Quadric border = Quadric::fromPlane(border_normal, -Math::dot(border_normal, *corners[corner]),
+                BORDER_WEIGHT * Math::dot(edge, edge));
+            quadrics[a] += border;
+            quadrics[b] += border;
+        }
+    }
+
+    const double max_error_squared = (double)max_error * max_error;
+    double worst_error = 0.0;
+
+    std::vector<uint32_t> current = indices;
+    std::vector<uint32_t> adjacency_offset(vertex_count + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> candidates;
+    std::vector<uint32_t> collapse_to(vertex_count);
+    std::vector<bool> touched(vertex_count);
+
+    while (current.size() > target_index_count) {
+        // Triangles around each vertex, for the fold checks
+        std::fill(adjacency_offset.begin(), adjacency_offset.end(), 0);
+        for (uint32_t index : current) {
+            adjacency_offset[index + 1]++;
+        }
+        for (uint32_t v = 0; v < vertex_count; v++) {
+            adjacency_offset[v + 1] += adjacency_offset[v];
+        }
+        adjacency.resize(current.size());
+        {
+            std::vector<uint32_t> cursor(adjacency_offset.begin(), adjacency_offset.end() - 1);
+            for (uint32_t i = 0; i < current.size(); i++) {
+                adjacency[cursor[current[i]]++] = i / 3;
+            }
+        }
+
+        candidates.clear();
+        for (size_t i = 0; i < current.size(); i += 3) {
+            for (int corner = 0; corner < 3; corner++) {
+                uint32_t a = current[i + corner];
+                uint32_t b = current[i + (corner + 1) % 3];
+                if (group[a] == group[b]) {
+                    continue;
+                }
+
+                for (auto [from, to] : {std::pair{a, b}, std::pair{b, a}}) {
+                    bool allowed = kind[from] == VertexKind::Manifold ||
+                        (kind[from] == VertexKind::Border && (isBorder(group[from], group[to]) || isBorder(group[to], group[from])));
+                    if (!allowed) {
+                        continue;
+                    }
+
+                    Quadric combined = quadrics[from];
+                    combined += quadrics[group[to]];
+                    double error = combined.weight > 0.0 ? combined.evaluate(vertices[to].position) / combined.weight : 0.0;
+                    candidates.push_back({from, to, error});
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+        // Each collapse removes about two triangles; stop the pass once that reaches the target
+        const size_t collapse_limit = std::max<size_t>(1, (current.size() - target_index_count) / 6);
+        size_t collapses = 0;
+
+        for (uint32_t v = 0; v < vertex_count; v++) {
+            collapse_to[v] = v;
+        }
+        std::fill(touched.begin(), touched.end(), false);
+
+        for (const Collapse& collapse : candidates) {
+            if (collapses >= collapse_limit || collapse.error > max_error_squared) {
+                break;
+            }
+            if (touched[group[collapse.from]] || touched[group[collapse.to]]) {
+                continue;
+            }
+
+            // Reject collapses that would fold a surviving triangle over
+            const Math::Vec3& destination = vertices[collapse.to].position;
+            bool folds = false;
+            for (uint32_t a = adjacency_offset[collapse.from]; a < adjacency_offset[collapse.from + 1] && !folds; a++) {
+                const uint32_t* triangle = &current[adjacency[a] * 3];
+                if (group[triangle[0]] == group[collapse.to] || group[triangle[1]] == group[collapse.to] ||
+                    group[triangle[2]] == group[collapse.to]) {
+                    continue;
+                }
+
+                Math::Vec3 before[3];
+                Math::Vec3 after[3];
+                for (int corner = 0; corner < 3; corner++) {
+                    before[corner] = vertices[triangle[corner]].position;
+                    after[corner] = triangle[corner] == collapse.from ? destination : before[corner];
+                }
+                Math::Vec3 normal_before = triangleNormal(before[0], before[1], before[2]);
+                Math::Vec3 normal_after = triangleNormal(after[0], after[1], after[2]);
+                double alignment = Math::dot(normal_before, normal_after);
+                folds = alignment <= MIN_NORMAL_COSINE * Math::length(normal_before) * Math::length(normal_after);
+            }
+            if (folds) {
+                continue;
+            }
+
+            // Lock the whole one-ring so overlapping collapses can't combine into a fold
+            for (uint32_t a = adjacency_offset[collapse.from]; a < adjacency_offset[collapse.from + 1]; a++) {
+                const uint32_t* triangle = &current[adjacency[a] * 3];
+                touched[group[triangle[0]]] = touched[group[triangle[1]]] = touched[group[triangle[2]]] = true;
+            }
+
+            collapse_to[collapse.from] = collapse.to;
+            quadrics[group[collapse.to]] += quadrics[collapse.from];
+            worst_error = std::max(worst_error, collapse.error);
+            collapses++;
+        }
+
+        if (collapses == 0) {
+            break;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < current.size(); i += 3) {
+            uint32_t a = collapse_to[current[i]];
+            uint32_t b = collapse_to[current[i + 1]];
+            uint32_t c = collapse_to[current[i + 2]];
+            if (group[a] != group[b] && group[b] != group[c] && group[a] != group[c]) {
+                current[kept++] = a;
+                current[kept++] = b;
+                current[kept++] = c;
+            }
+        }
+        current.resize(kept);
+    }
+
+    if (result_error) {
+        *result_error = (float)std::sqrt(worst_error);
+    }
+    return current;
+}
@@ -0,0 +1,36 @@
+#ifndef _MEADOW_MESH_SIMPLIFIER_HPP_
+#define _MEADOW_MESH_SIMPLIFIER_HPP_
+
+#include <cstdint>
+#include <vector>
+#include "MeshData.hpp"
+
+/**
+ * @brief Offline triangle reduction with quadric error metrics.
+ *
+ * Garland and Heckbert's edge collapse: every vertex accumulates the planes of
+ * its triangles as a quadric, and edges are collapsed cheapest first, with the
+ * cost being the area-weighted mean squared distance from the moved vertex to
+ * those planes. Vertices only ever collapse onto one of their neighbours, so
+ * the result indexes the original vertex buffer and no attributes have to be
+ * interpolated.
+ *
+ * Open borders are kept in place by extra quadrics perpendicular to them, and
+ * can only collapse along themselves. Vertices on attribute seams (several
+ * vertices at one position) and non-manifold vertices never move, which keeps
+ * seams watertight at the cost of some reduction on heavily split meshes.
+ */
+namespace MeshSimplifier {
+    /**
+     * @brief Collapses edges until at most target_index_count indices remain, or until the
+     * next collapse would exceed max_error.
+     *
+     * @param max_error Largest allowed deviation, in the mesh's own units.
+     * @param result_error If given, receives the largest deviation actually introduced.
+     * @return The simplified index list, referencing the same vertices.
+     */
+    std::vector<uint32_t> simplify(const std::vector<uint32_t>& indices, const std::vector<MeshVertex>& vertices,
+        size_t target_index_count, float max_error, float* result_error = nullptr);
+}
+
+#endif // _MEADOW_MESH_SIMPLIFIER_HPP_
@@ -0,0 +1,172 @@
+#include "PackedMesh.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+PackedMesh PackedMesh::pack(const MeshData& mesh) {
+    PackedMesh packed {};
+
+    Math::Vec3 min {0.0f, 0.0f, 0.0f};
+    Math::Vec3 max {0.0f, 0.0f, 0.0f};
+    if (!mesh.vertices.empty()) {
+        min = max = mesh.vertices[0].position;
+    }
+    for (const MeshVertex& vertex : mesh.vertices) {
+        min = {std::min(min.x, vertex.position.x), std::min(min.y, vertex.position.y), std::min(min.z, vertex.position.z)};
+        max = {std::max(max.x, vertex.position.x), std::max(max.y, vertex.position.y), std::max(max.z, vertex.position.z)};
+    }
+
+    // Flat axes still get a non-zero scale so the decode never divides anything by zero
+    Math::Vec3 extent = max - min;
+    packed.position_offset = min;
+    packed.position_scale = {
+        extent.x > 0.0f ? extent.x : 1.0f,
+        extent.y > 0.0f ? extent.y : 1.0f,
+        extent.z > 0.0f ? extent.z : 1.0f
+    };
+
+    packed.vertices.reserve(mesh.vertices.size());
+    for (const MeshVertex& vertex : mesh.vertices) {
+        Math::Vec3 relative = vertex.position - min;
+
+        float u, v;
+        Quantization::encodeOctahedral(vertex.normal, u, v);
+
+        packed.vertices.push_back({
+            .position = {
+                Quantization::toUnorm16(relative.x / packed.position_scale.x),
+                Quantization::toUnorm16(relative.y / packed.position_scale.y),
+                Quantization::toUnorm16(relative.z / packed.position_scale.z),
+                0
+            },
+            .normal = {Quantization::toSnorm16(u), Quantization::toSnorm16(v)},
+            .uv = {Quantization::toHalf(vertex.uv[0]), Quantization::toHalf(vertex.uv[1])}
+        });
+    }
+
+    packed.index_count = (uint32_t)mesh.indices.size();
+    if (mesh.vertices.size() <= std::numeric_limits<uint16_t>::max()) {
+        packed.index_type = VK_INDEX_TYPE_UINT16;
+        packed.index_data.resize(mesh.indices.size() * sizeof(uint16_t));
+        for (size_t i = 0; i < mesh.indices.size(); i++) {
+            uint16_t index = (uint16_t)mesh.indices[i];
+            std::memcpy(packed.index_data.data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+        }
+    }
+    else {
+        packed.index_type = VK_INDEX_TYPE_UINT32;
+        packed.index_data.resize(mesh.indices.size() * sizeof(uint32_t));
+        std::memcpy(packed.index_data.data(), mesh.indices.data(), packed.index_data.size());
+    }
+
+    return packed;
+}
+
+VertexInput PackedMesh::getVertexInput() {
+    return {
+        .bindings = {{
+            .binding = 0,
+            .stride = sizeof(PackedVertex),
+            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX
+        }},
+        .attributes = {
+            {.location = 0, .binding = 0, .format = VK_FORMAT_R16G16B16A16_UNORM, .offset = offsetof(PackedVertex, position)},
+            {.location = 1, .binding = 0, .format = VK_FORMAT_R16G16_SNORM, .offset = offsetof(PackedVertex, normal)},
+            {.location = 2, .binding = 0, .format = VK_FORMAT_R16G16_SFLOAT, .offset = offsetof(PackedVertex, uv)}
+        }
+    };
+}
+
+uint16_t Quantization::toUnorm16(float value) {
+    return (uint16_t)std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f);
+}
+
+int16_t Quantization::toSnorm16(float value) {
+    return (int16_t)std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f);
+}
+
+uint16_t Quantization::toHalf(float value) {
+    uint32_t bits = std::bit_cast<uint32_t>(value);
+    uint16_t sign = (uint16_t)((bits >> 16) & 0x8000);
+    uint32_t magnitude = bits & 0x7fffffff;
+
+    if (magnitude >= 0x7f800000) {
+        // Infinity stays infinity, NaN stays a (quiet) NaN
+        return sign | (magnitude > 0x7f800000 ? 0x7e00 : 0x7c00);
+    }
+    if (magnitude >= 0x477ff000) {
+        // Rounds to beyond the largest half (65504)
+        return sign | 0x7c00;
+    }
+    if (magnitude < 0x38800000) {
+        // Subnormal half: shift the mantissa, with its implicit bit, into place and round to nearest even
+        if (magnitude < 0x33000000) {
+            return sign;
+        }
+        uint32_t exponent = magnitude >> 23;
+        uint32_t mantissa = (magnitude & 0x7fffff) | 0x800000;
+        uint32_t shift = 126 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half & 1))) {
+            half++;
+        }
+        return sign | (uint16_t)half;
+    }
+
+    // Normal half: rebias the exponent and round the mantissa to nearest even; a carry out of
+    // the mantissa correctly bumps the exponent
+    uint32_t half = (magnitude - 0x38000000) >> 13;
+    uint32_t remainder = magnitude & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1))) {
+        half++;
+    }
+    return sign | (uint16_t)half;
+}
+
+float Quantization::fromHalf(uint16_t half) {
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+
+    if (exponent == 0x1f) {
+        return std::bit_cast<float>(sign | 0x7f800000 | (mantissa << 13));
+    }
+    if (exponent == 0) {
+        float value = std::ldexp((float)mantissa, -24);
+        return sign ? -value : value;
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+void Quantization::encodeOctahedral(const Math::Vec3& normal, float& u, float& v) {
+    float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (l1 == 0.0f) {
+        u = v = 0.0f;
+        return;
+    }
+
+    u = normal.x / l1;
+    v = normal.y / l1;
+    if (normal.z < 0.0f) {
+        // Fold the lower hemisphere over the diagonals
+        float folded_u = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float folded_v = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u = folded_u;
+        v = folded_v;
+    }
+}
+
+Math::Vec3 Quantization::decodeOctahedral(float u, float v) {
+    Math::Vec3 normal {u, v, 1.0f - std::abs(u) - std::abs(v)};
+    if (normal.z < 0.0f) {
+        float x = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        float y = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        normal.x = x;
+        normal.y = y;
+    }
+    return normal * (1.0f / Math::length(normal));
+}
@@ -0,0 +1,81 @@
+#ifndef _MEADOW_PACKED_MESH_HPP_
+#define _MEADOW_PACKED_MESH_HPP_
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MeshData.hpp"
+#include "VertexInput.hpp"
+
+/**
+ * @brief A quantized vertex, 16 bytes against MeshVertex's 32.
+ *
+ * - position: R16G16B16A16_UNORM within the mesh's bounding box (w unused)
+ * - normal:   R16G16_SNORM octahedral encoding
+ * - uv:       R16G16_SFLOAT
+ *
+ * The vertex shader restores the object-space position as
+ * position_offset + position.xyz * position_scale, and the normal with the
+ * usual octahedral decode.
+ */
+struct PackedVertex {
+    uint16_t position[4];
+    int16_t normal[2];
+    uint16_t uv[2];
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must match its vertex input layout");
+
+/**
+ * @brief A mesh in its GPU-ready form: quantized vertices and the narrowest index type that fits.
+ */
+struct PackedMesh {
+    std::vector<PackedVertex> vertices;
+    std::vector<std::byte> index_data;
+    VkIndexType index_type;
+    uint32_t index_count;
+
+    Math::Vec3 position_offset; /**< The bounding box minimum. */
+    Math::Vec3 position_scale;  /**< The bounding box extent. */
+
+    /**
+     * @brief Quantizes a mesh. Run MeshOptimizer::optimize() on it first.
+     */
+    static PackedMesh pack(const MeshData& mesh);
+
+    /**
+     * @brief The vertex input state for PackedVertex at binding 0, locations 0 to 2.
+     */
+    static VertexInput getVertexInput();
+
+    /**
+     * @brief Bytes of vertex and index data, for comparing against the unpacked mesh.
+     */
+    inline size_t getSize() const { return vertices.size() * sizeof(PackedVertex) + index_data.size(); }
+};
+
+/**
+ * @brief The scalar encodings PackedVertex is built from.
+ */
+namespace Quantization {
+    uint16_t toUnorm16(float value);
+
+    int16_t toSnorm16(float value);
+
+    /**
+     * @brief IEEE 754 binary16, rounded to nearest even; out-of-range values become infinity.
+     */
+    uint16_t toHalf(float value);
+
+    float fromHalf(uint16_t half);
+
+    /**
+     * @brief Maps a unit vector onto the octahedron and unfolds it into [-1, 1]^2.
+     */
+    void encodeOctahedral(const Math::Vec3& normal, float& u, float& v);
+
+    Math::Vec3 decodeOctahedral(float u, float v);
+}
+
+#endif // _MEADOW_PACKED_MESH_HPP_
@@ -0,0 +1,94 @@
+#ifndef _MEADOW_COMPONENT_POOL_HPP_
+#define _MEADOW_COMPONENT_POOL_HPP_
+
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "Entity.hpp"
+
+/**
+ * @brief The type-independent side of a ComponentPool, through which a Scene drops the
+ * components of the entities it destroys.
+ */
+class ComponentStorage {
+public:
+    virtual ~ComponentStorage() = default;
+
+    /**
+     * @brief Removes the entity's component, if it has one.
+     */
+    virtual void remove(Entity entity) = 0;
+};
+
+/**
+ * @brief Dense storage for one component type, indexed by entity.
+ *
+ * Components are packed contiguously in no particular order, so systems
+ * iterate data() and getEntities() linearly. A sparse array maps entity
+ * slots to their position; removal swaps the last component into the hole.
+ * Attach the pool to its Scene so destroyed entities lose their components.
+ */
+template <typename T>
+class ComponentPool : public ComponentStorage {
+    static constexpr uint32_t ABSENT = UINT32_MAX;
+
+    std::vector<uint32_t> sparse;
+    std::vector<Entity> entities;
+    std::vector<T> components;
+
+public:
+    T& add(Entity entity, T component) {
+        if (entity.index >= sparse.size()) {
+            sparse.resize(entity.index + 1, ABSENT);
+        }
+        if (has(entity)) {
+            throw std::runtime_error("Entity already has this component!");
+        }
+
+        // A dead entity that once held this slot still owns its component; reuse that entry
+        uint32_t stale = sparse[entity.index];
+        if (stale != ABSENT) {
+            entities[stale] = entity;
+            components[stale] = std::move(component);
+            return components[stale];
+        }
+
+        sparse[entity.index] = (uint32_t)components.size();
+        entities.push_back(entity);
+        components.push_back(std::move(component));
+        return components.back();
+    }
+
+    void remove(Entity entity) override {
+        if (!has(entity)) {
+            return;
+        }
+
+        uint32_t dense = sparse[entity.index];
+        if (dense != components.size() - 1) {
+            sparse[entities.back().index] = dense;
+            entities[dense] = entities.back();
+            components[dense] = std::move(components.back());
+        }
+        entities.pop_back();
+        components.pop_back();
+        sparse[entity.index] = ABSENT;
+    }
+
+    bool has(Entity entity) const {
+        return entity.index < sparse.size() && sparse[entity.index] != ABSENT
+            && entities[sparse[entity.index]] == entity;
+    }
+
+    inline T& get(Entity entity) { return components[sparse[entity.index]]; }
+
+    inline const T& get(Entity entity) const { return components[sparse[entity.index]]; }
+
+    inline uint32_t size() const { return (uint32_t)components.size(); }
+
+    inline T* data() { return components.data(); }
+
+    inline const std::vector<Entity>& getEntities() const { return entities; }
+};
+
+#endif // _MEADOW_COMPONENT_POOL_HPP_
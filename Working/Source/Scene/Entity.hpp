@@ -0,0 +1,22 @@
+#ifndef _MEADOW_ENTITY_HPP_
+#define _MEADOW_ENTITY_HPP_
+
+#include <cstdint>
+
+/**
+ * @brief A handle to an entity in a Scene.
+ *
+ * The index names a slot; the generation is bumped whenever the slot is
+ * reused, so handles to destroyed entities are detected instead of silently
+ * aliasing whatever lives in the slot now.
+ */
+struct Entity {
+    uint32_t index;
+    uint32_t generation;
+
+    constexpr bool operator==(const Entity& other) const = default;
+};
+
+constexpr Entity NULL_ENTITY = {UINT32_MAX, UINT32_MAX};
+
+#endif // _MEADOW_ENTITY_HPP_
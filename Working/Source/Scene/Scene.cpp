@@ -0,0 +1,296 @@
+#include "Scene.hpp"
+#include "Config.h"
+#include <algorithm>
+#include <stdexcept>
+#include <atomic>
+
+Scene::Scene(JobSystem* jobs) : jobs(jobs), hierarchy_changed(false) {}
+
+Entity Scene::create(Entity parent_entity) {
+    uint32_t slot;
+    if (!free_slots.empty()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    }
+    else {
+        slot = (uint32_t)slot_dense.size();
+        slot_dense.push_back(0);
+        slot_generation.push_back(0);
+    }
+
+    uint32_t dense_index = (uint32_t)dense_slot.size();
+    slot_dense[slot] = dense_index;
+
+    // Appended out of depth order; the next update sorts it into its level
+    dense_slot.push_back(slot);
+    parent.push_back(parent_entity == NULL_ENTITY ? NO_PARENT : denseIndex(parent_entity));
+    depth.push_back(parent.back() == NO_PARENT ? 0 : depth[parent.back()] + 1);
+    local_position.push_back({0.0f, 0.0f, 0.0f});
+    local_rotation.push_back({0.0f, 0.0f, 0.0f, 1.0f});
+    local_scale.push_back({1.0f, 1.0f, 1.0f});
+    world.push_back(Math::Mat4::identity());
+    dirty.push_back(0);
+
+    hierarchy_changed = true;
+    markDirty(dense_index);
+
+    return {slot, slot_generation[slot]};
+}
+
+void Scene::attach(ComponentStorage& pool) {
+    if (std::find(component_pools.begin(), component_pools.end(), &pool) == component_pools.end()) {
+        component_pools.push_back(&pool);
+    }
+}
+
+void Scene::detach(ComponentStorage& pool) {
+    component_pools.erase(std::remove(component_pools.begin(), component_pools.end(), &pool), component_pools.end());
+}
+
+void Scene::destroy(Entity entity) {
+    if (!isAlive(entity)) {
+        return;
+    }
+
+    // Parents precede children once sorted, so one forward sweep finds the whole subtree
+    sortHierarchy();
+
+    std::vector<bool> removed(dense_slot.size(), false);
+    removed[denseIndex(entity)] = true;
+    for (uint32_t i = 0; i < dense_slot.size(); i++) {
+        if (parent[i] != NO_PARENT && removed[parent[i]]) {
+            removed[i] = true;
+        }
+    }
+
+    std::vector<uint32_t> order;
+    order.reserve(dense_slot.size());
+    for (uint32_t i = 0; i < dense_slot.size(); i++) {
+        if (removed[i]) {
+            // Components go while the handle still matches, as pools reject stale ones
+            const Entity dead = getEntity(i);
+            for (ComponentStorage* pool : component_pools) {
+                pool->remove(dead);
+            }
+            slot_generation[dense_slot[i]]++;
+            free_slots.push_back(dense_slot[i]);
+        }
+        else {
+            order.push_back(i);
+        }
+    }
+
+    // Stable compaction keeps the depth order intact
+    std::vector<uint32_t> remap(dense_slot.size(), NO_PARENT);
+    for (uint32_t i = 0; i < order.size(); i++) {
+        remap[order[i]] = i;
+    }
+
+    permute(dense_slot, order);
+    permute(parent, order);
+    permute(depth, order);
+    permute(local_position, order);
+    permute(local_rotation, order);
+    permute(local_scale, order);
+    permute(world, order);
+    permute(dirty, order);
+
+    for (uint32_t i = 0; i < dense_slot.size(); i++) {
+        slot_dense[dense_slot[i]] = i;
+        if (parent[i] != NO_PARENT) {
+            parent[i] = remap[parent[i]];
+        }
+    }
+
+    hierarchy_changed = true;
+    sortHierarchy();
+}
+
+bool Scene::isAlive(Entity entity) const {
+    return entity.index < slot_generation.size() && slot_generation[entity.index] == entity.generation;
+}
+
+void Scene::setParent(Entity entity, Entity parent_entity) {
+    uint32_t child = denseIndex(entity);
+    uint32_t new_parent = parent_entity == NULL_ENTITY ? NO_PARENT : denseIndex(parent_entity);
+
+    for (uint32_t ancestor = new_parent; ancestor != NO_PARENT; ancestor = parent[ancestor]) {
+        if (ancestor == child) {
+            throw std::runtime_error("Failed to set parent: an entity can't be its own ancestor!");
+        }
+    }
+
+    parent[child] = new_parent;
+    hierarchy_changed = true;
+    markDirty(child);
+}
+
+Entity Scene::getParent(Entity entity) const {
+    uint32_t parent_index = parent[denseIndex(entity)];
+    return parent_index == NO_PARENT ? NULL_ENTITY : getEntity(parent_index);
+}
+
+void Scene::setPosition(Entity entity, const Math::Vec3& position) {
+    uint32_t dense_index = denseIndex(entity);
+    local_position[dense_index] = position;
+    markDirty(dense_index);
+}
+
+void Scene::setRotation(Entity entity, const Math::Quat& rotation) {
+    uint32_t dense_index = denseIndex(entity);
+    local_rotation[dense_index] = rotation;
+    markDirty(dense_index);
+}
+
+void Scene::setScale(Entity entity, const Math::Vec3& scale) {
+    uint32_t dense_index = denseIndex(entity);
+    local_scale[dense_index] = scale;
+    markDirty(dense_index);
+}
+
+void Scene::updateTransforms() {
+    sortHierarchy();
+
+    // A level needs work if something in it was marked, or if its parents' level changed
+    std::vector<uint32_t> touched_levels;
+    uint32_t carried = 0;
+    for (uint32_t level = 0; level + 1 < level_begin.size(); level++) {
+        if (carried == 0 && level_dirty[level] == 0) {
+            continue;
+        }
+
+        uint32_t begin = level_begin[level];
+        uint32_t end = level_begin[level + 1];
+        uint32_t size = end - begin;
+
+        if (!jobs || size < CONSTANTS::SCENE_PARALLEL_THRESHOLD) {
+            carried = propagateRange(begin, end);
+        }
+        else {
+            std::atomic<uint32_t> changed = 0;
+            jobs->parallelFor(size, CONSTANTS::SCENE_PARALLEL_THRESHOLD / 4, [&](uint32_t batch_begin, uint32_t batch_end) {
+                changed.fetch_add(propagateRange(begin + batch_begin, begin + batch_end), std::memory_order_relaxed);
+            });
+            carried = changed.load();
+        }
+
+        touched_levels.push_back(level);
+    }
+
+    for (uint32_t level : touched_levels) {
+        std::fill(dirty.begin() + level_begin[level], dirty.begin() + level_begin[level + 1], 0);
+        level_dirty[level] = 0;
+    }
+}
+
+uint32_t Scene::denseIndex(Entity entity) const {
+    if (!isAlive(entity)) {
+        throw std::runtime_error("Entity handle is stale or invalid!");
+    }
+    return slot_dense[entity.index];
+}
+
+void Scene::markDirty(uint32_t dense_index) {
+    if (dirty[dense_index]) {
+        return;
+    }
+    dirty[dense_index] = 1;
+    if (depth[dense_index] >= level_dirty.size()) {
+        level_dirty.resize(depth[dense_index] + 1, 0);
+    }
+    level_dirty[depth[dense_index]]++;
+}
+
+void Scene::sortHierarchy() {
+    if (!hierarchy_changed) {
+        return;
+    }
+    hierarchy_changed = false;
+
+    const uint32_t count = (uint32_t)dense_slot.size();
+
+    // Depths from the parent chains; entities created or re-parented since the last sort may
+    // sit before their parents, so walk up until reaching an entity whose depth is known
+    std::vector<uint32_t> new_depth(count, NO_PARENT);
+    std::vector<uint32_t> chain;
+    for (uint32_t i = 0; i < count; i++) {
+        uint32_t node = i;
+        while (new_depth[node] == NO_PARENT && parent[node] != NO_PARENT) {
+            chain.push_back(node);
+            node = parent[node];
+        }
+        if (new_depth[node] == NO_PARENT) {
+            new_depth[node] = 0;
+        }
+        while (!chain.empty()) {
+            new_depth[chain.back()] = new_depth[parent[chain.back()]] + 1;
+            chain.pop_back();
+        }
+    }
+    depth = std::move(new_depth);
+
+    // Counting sort by depth, stable so siblings keep their relative order
+    uint32_t level_count = 0;
+    for (uint32_t d : depth) {
+        level_count = std::max(level_count, d + 1);
+    }
+    level_begin.assign(level_count + 1, 0);
+    for (uint32_t d : depth) {
+        level_begin[d + 1]++;
+    }
+    for (uint32_t level = 0; level < level_count; level++) {
+        level_begin[level + 1] += level_begin[level];
+    }
+
+    std::vector<uint32_t> order(count);
+    std::vector<uint32_t> remap(count);
+    std::vector<uint32_t> cursor(level_begin.begin(), level_begin.end() - 1);
+    for (uint32_t i = 0; i < count; i++) {
+        remap[i] = cursor[depth[i]]++;
+        order[remap[i]] = i;
+    }
+
+    permute(dense_slot, order);
+    permute(parent, order);
+    permute(depth, order);
+    permute(local_position, order);
+    permute(local_rotation, order);
+    permute(local_scale, order);
+    permute(world, order);
+    permute(dirty, order);
+
+    level_dirty.assign(level_count, 0);
+    for (uint32_t i = 0; i < count; i++) {
+        slot_dense[dense_slot[i]] = i;
+        if (parent[i] != NO_PARENT) {
+            parent[i] = remap[parent[i]];
+        }
+        level_dirty[depth[i]] += dirty[i];
+    }
+}
+
+uint32_t Scene::propagateRange(uint32_t begin, uint32_t end) {
+    uint32_t changed = 0;
+    for (uint32_t i = begin; i < end; i++) {
+        uint32_t parent_index = parent[i];
+        if (!dirty[i] && (parent_index == NO_PARENT || !dirty[parent_index])) {
+            continue;
+        }
+
+        dirty[i] = 1;
+        Math::Mat4 local = Math::Mat4::fromTransform(local_position[i], local_rotation[i], local_scale[i]);
+        world[i] = parent_index == NO_PARENT ? local : world[parent_index] * local;
+        changed++;
+    }
+    return changed;
+}
+
+template <typename T>
+void Scene::permute(std::vector<T>& values, const std::vector<uint32_t>& order) {
+    std::vector<T> permuted;
+    permuted.reserve(order.size());
+    for (uint32_t index : order) {
+        permuted.push_back(values[index]);
+    }
+    values = std::move(permuted);
+}
@@ -0,0 +1,148 @@
+#ifndef _MEADOW_SCENE_HPP_
+#define _MEADOW_SCENE_HPP_
+
+#include <cstdint>
+#include <vector>
+#include "ComponentPool.hpp"
+#include "Entity.hpp"
+#include "Math.hpp"
+#include "JobSystem.hpp"
+
+/**
+ * @brief Entities with a transform hierarchy, stored as structure-of-arrays.
+ *
+ * Every transform component lives in its own dense array, and the arrays are
+ * kept sorted by hierarchy depth: all roots first, then all of their children,
+ * and so on. A parent therefore always precedes its children, and every level
+ * is a contiguous range whose world transforms depend only on the level above,
+ * so updateTransforms() sweeps each level linearly and splits large levels
+ * across a JobSystem.
+ *
+ * Only entities whose local transform changed since the last update, and
+ * their descendants, are recomputed; levels with nothing dirty are skipped.
+ *
+ * Other per-entity data belongs in a ComponentPool keyed by the same handles,
+ * attached to the scene so destroy() removes it too.
+ */
+class Scene {
+public:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+private:
+    JobSystem* jobs;
+
+    // Handle slots
+    std::vector<uint32_t> slot_dense;
+    std::vector<uint32_t> slot_generation;
+    std::vector<uint32_t> free_slots;
+
+    // Dense component arrays, all indexed by dense index
+    std::vector<uint32_t> dense_slot;
+    std::vector<uint32_t> parent;            /**< Dense index of the parent, or NO_PARENT. */
+    std::vector<uint32_t> depth;
+    std::vector<Math::Vec3> local_position;
+    std::vector<Math::Quat> local_rotation;
+    std::vector<Math::Vec3> local_scale;
+    std::vector<Math::Mat4> world;
+    std::vector<uint8_t> dirty;
+
+    std::vector<uint32_t> level_begin;       /**< Dense range of each depth, plus an end sentinel. */
+    std::vector<uint32_t> level_dirty;       /**< Entities marked dirty per depth since the last update. */
+    bool hierarchy_changed;
+
+    std::vector<ComponentStorage*> component_pools;
+
+public:
+    /**
+     * @param jobs Used to propagate large hierarchy levels in parallel; optional.
+     */
+    Scene(JobSystem* jobs = nullptr);
+
+    /**
+     * @brief Creates an entity with an identity transform.
+     */
+    Entity create(Entity parent_entity = NULL_ENTITY);
+
+    /**
+     * @brief Destroys an entity along with all of its descendants.
+     */
+    void destroy(Entity entity);
+
+    bool isAlive(Entity entity) const;
+
+    /**
+     * @brief Has destroy() remove entities' components from pool. The pool must outlive the scene
+     * or be detached first.
+     */
+    void attach(ComponentStorage& pool);
+
+    void detach(ComponentStorage& pool);
+
+    /**
+     * @brief Moves an entity (and its subtree) under a new parent, or to the root with NULL_ENTITY.
+     * Throws if that would create a cycle.
+     */
+    void setParent(Entity entity, Entity parent_entity);
+
+    Entity getParent(Entity entity) const;
+
+    void setPosition(Entity entity, const Math::Vec3& position);
+
+    void setRotation(Entity entity, const Math::Quat& rotation);
+
+    void setScale(Entity entity, const Math::Vec3& scale);
+
+    inline const Math::Vec3& getPosition(Entity entity) const { return local_position[denseIndex(entity)]; }
+
+    inline const Math::Quat& getRotation(Entity entity) const { return local_rotation[denseIndex(entity)]; }
+
+    inline const Math::Vec3& getScale(Entity entity) const { return local_scale[denseIndex(entity)]; }
+
+    /**
+     * @brief The entity's world transform as of the last updateTransforms().
+     */
+    inline const Math::Mat4& getWorldMatrix(Entity entity) const { return world[denseIndex(entity)]; }
+
+    /**
+     * @brief Recomputes the world transforms of every dirty entity and its descendants.
+     */
+    void updateTransforms();
+
+    inline uint32_t getCount() const { return (uint32_t)dense_slot.size(); }
+
+    /**
+     * @brief World matrices in dense order, for systems that sweep every entity.
+     * Dense order only changes when the hierarchy does.
+     */
+    inline const std::vector<Math::Mat4>& getWorldMatrices() const { return world; }
+
+    /**
+     * @brief The handle of the entity at a dense index.
+     */
+    inline Entity getEntity(uint32_t dense_index) const {
+        uint32_t slot = dense_slot[dense_index];
+        return {slot, slot_generation[slot]};
+    }
+
+private:
+    uint32_t denseIndex(Entity entity) const;
+
+    void markDirty(uint32_t dense_index);
+
+    /**
+     * @brief Re-sorts the dense arrays by depth after entities were created, moved or destroyed.
+     */
+    void sortHierarchy();
+
+    /**
+     * @brief Recomputes the dirty entities of a dense range whose parents are already up to date.
+     *
+     * @return How many entities in the range ended up dirty.
+     */
+    uint32_t propagateRange(uint32_t begin, uint32_t end);
+
+    template <typename T>
+    static void permute(std::vector<T>& values, const std::vector<uint32_t>& order);
+};
+
+#endif // _MEADOW_SCENE_HPP_
@@ -0,0 +1,74 @@
+#ifndef _MEADOW_HANDLE_HPP_
+#define _MEADOW_HANDLE_HPP_
+
+#include <utility>
+
+/**
+ * @brief Move-only owner of a single handle, destroyed through Deleter.
+ *
+ * Holds nothing but the handle and the deleter, so wrapping a resource costs no
+ * more than storing it raw. A default constructed or moved-from Handle holds the
+ * null handle T{} and destroys nothing.
+ *
+ * @tparam T The handle type, e.g. a Vulkan object.
+ * @tparam Deleter Callable taking a T, carrying whatever else destruction needs.
+ */
+template<typename T, typename Deleter>
+class Handle {
+    T handle;
+    [[no_unique_address]] Deleter deleter;
+
+public:
+    using deleter_type = Deleter;
+
+    Handle() : handle{}, deleter{} {}
+
+    explicit Handle(T handle, Deleter deleter = {}) : handle(handle), deleter(std::move(deleter)) {}
+
+    ~Handle() {
+        reset();
+    }
+
+    Handle(const Handle&) = delete;
+    Handle& operator=(const Handle&) = delete;
+
+    Handle(Handle&& other) noexcept :
+        handle(std::exchange(other.handle, T{})),
+        deleter(std::move(other.deleter))
+    {}
+
+    Handle& operator=(Handle&& other) noexcept {
+        if (this != &other) {
+            reset();
+            handle = std::exchange(other.handle, T{});
+            deleter = std::move(other.deleter);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Destroys the owned handle, if any, and takes ownership of replacement. The
+     * deleter is kept.
+     */
+    void reset(T replacement = T{}) {
+        if (handle != T{}) {
+            deleter(handle);
+        }
+        handle = replacement;
+    }
+
+    /**
+     * @brief Gives up ownership without destroying the handle.
+     */
+    T release() {
+        return std::exchange(handle, T{});
+    }
+
+    inline const T& get() const { return handle; }
+
+    inline operator const T&() const { return handle; }
+
+    inline explicit operator bool() const { return handle != T{}; }
+};
+
+#endif // _MEADOW_HANDLE_HPP_
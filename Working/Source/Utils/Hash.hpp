@@ -0,0 +1,55 @@
+#ifndef _MEADOW_HASH_HPP_
+#define _MEADOW_HASH_HPP_
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * @brief Stable 64-bit FNV-1a hashing.
+ *
+ * Unlike std::hash, the result does not depend on the standard library or the
+ * process, so it can be stored on disk or used as a cache key across runs.
+ */
+namespace Hash {
+    constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325ull;
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    /**
+     * @brief Folds a block of bytes into a running hash.
+     */
+    inline uint64_t bytes(const void* data, size_t size, uint64_t hash = FNV_OFFSET_BASIS) {
+        const unsigned char* data_bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; i++) {
+            hash ^= data_bytes[i];
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Folds a string into a running hash. Usable at compile time.
+     */
+    constexpr uint64_t string(std::string_view str, uint64_t hash = FNV_OFFSET_BASIS) {
+        for (char c : str) {
+            hash ^= (unsigned char)c;
+            hash *= FNV_PRIME;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Folds a single integral, enum or handle value into a running hash.
+     *
+     * Values are hashed field by field rather than as raw structs so that
+     * padding bytes never leak into the result.
+     */
+    template <typename T>
+    inline uint64_t value(const T& value, uint64_t hash = FNV_OFFSET_BASIS) {
+        static_assert(std::is_trivially_copyable_v<T>, "Hash::value requires a trivially copyable type");
+        return bytes(&value, sizeof(T), hash);
+    }
+}
+
+#endif // _MEADOW_HASH_HPP_
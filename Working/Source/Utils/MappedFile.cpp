@@ -0,0 +1,123 @@
+#include "MappedFile.hpp"
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+    data(nullptr),
+    size(0)
+#ifdef _WIN32
+    , file_handle(nullptr),
+    mapping_handle(nullptr)
+#endif
+{}
+
+MappedFile::MappedFile(const char* path) : MappedFile() {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error(std::string("Failed to open file ") + path);
+    }
+    file_handle = file;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        close();
+        throw std::runtime_error(std::string("Failed to query size of ") + path);
+    }
+    size = (size_t)file_size.QuadPart;
+    if (size == 0) {
+        return;
+    }
+
+    mapping_handle = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_handle) {
+        close();
+        throw std::runtime_error(std::string("Failed to map ") + path);
+    }
+
+    data = static_cast<const std::byte*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+    if (!data) {
+        close();
+        throw std::runtime_error(std::string("Failed to map ") + path);
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(std::string("Failed to open file ") + path);
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat)) {
+        ::close(fd);
+        throw std::runtime_error(std::string("Failed to query size of ") + path);
+    }
+    size = (size_t)file_stat.st_size;
+    if (size == 0) {
+        ::close(fd);
+        return;
+    }
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps its own reference to the file
+    if (mapping == MAP_FAILED) {
+        size = 0;
+        throw std::runtime_error(std::string("Failed to map ") + path);
+    }
+    data = static_cast<const std::byte*>(mapping);
+#endif
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept : MappedFile() {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+#ifdef _WIN32
+        std::swap(file_handle, other.file_handle);
+        std::swap(mapping_handle, other.mapping_handle);
+#endif
+    }
+    return *this;
+}
+
+void MappedFile::close() {
+#ifdef _WIN32
+    if (data) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping_handle) {
+        CloseHandle(mapping_handle);
+    }
+    if (file_handle) {
+        CloseHandle(file_handle);
+    }
+    file_handle = nullptr;
+    mapping_handle = nullptr;
+#else
+    if (data) {
+        munmap(const_cast<std::byte*>(data), size);
+    }
+#endif
+    data = nullptr;
+    size = 0;
+}
@@ -0,0 +1,48 @@
+#ifndef _MEADOW_MAPPED_FILE_HPP_
+#define _MEADOW_MAPPED_FILE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A read-only memory mapping of an entire file.
+ *
+ * Pages are faulted in by the OS on first access, so opening a large file is
+ * cheap and only the ranges actually read ever hit the disk. Move-only.
+ */
+class MappedFile {
+    const std::byte* data;
+    size_t size;
+
+#ifdef _WIN32
+    void* file_handle;
+    void* mapping_handle;
+#endif
+
+public:
+    MappedFile();
+
+    /**
+     * @brief Maps the file at the given path. Throws std::runtime_error on failure.
+     */
+    explicit MappedFile(const char* path);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    inline const std::byte* getData() const { return data; }
+
+    inline size_t getSize() const { return size; }
+
+    inline explicit operator bool() const { return data != nullptr; }
+
+private:
+    void close();
+};
+
+#endif // _MEADOW_MAPPED_FILE_HPP_
@@ -0,0 +1,95 @@
+#ifndef _MEADOW_MATH_HPP_
+#define _MEADOW_MATH_HPP_
+
+#include <cmath>
+
+/**
+ * @brief The small amount of vector math the engine needs on the CPU side.
+ */
+namespace Math {
+    struct Vec3 {
+        float x, y, z;
+
+        constexpr Vec3 operator+(const Vec3& other) const { return {x + other.x, y + other.y, z + other.z}; }
+        constexpr Vec3 operator-(const Vec3& other) const { return {x - other.x, y - other.y, z - other.z}; }
+        constexpr Vec3 operator*(float scale) const { return {x * scale, y * scale, z * scale}; }
+    };
+
+    constexpr float dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    constexpr Vec3 cross(const Vec3& a, const Vec3& b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+
+    inline float length(const Vec3& v) { return std::sqrt(dot(v, v)); }
+
+    /**
+     * @brief A plane with points p satisfying dot(normal, p) + distance = 0. The normal
+     * points to the positive (inside) half-space.
+     */
+    struct Plane {
+        Vec3 normal;
+        float distance;
+
+        inline Plane normalized() const {
+            float inverse_length = 1.0f / length(normal);
+            return {normal * inverse_length, distance * inverse_length};
+        }
+    };
+
+    /**
+     * @brief A rotation quaternion; w is the scalar part.
+     */
+    struct Quat {
+        float x, y, z, w;
+    };
+
+    /**
+     * @brief A 4x4 matrix stored column-major, matching GLSL.
+     */
+    struct Mat4 {
+        float elements[16];
+
+        constexpr float at(int row, int column) const { return elements[column * 4 + row]; }
+
+        static constexpr Mat4 identity() {
+            return {{1.0f, 0.0f, 0.0f, 0.0f,  0.0f, 1.0f, 0.0f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f,  0.0f, 0.0f, 0.0f, 1.0f}};
+        }
+
+        /**
+         * @brief Scale, then rotate, then translate.
+         */
+        static constexpr Mat4 fromTransform(const Vec3& translation, const Quat& rotation, const Vec3& scale) {
+            const float xx = rotation.x * rotation.x, yy = rotation.y * rotation.y, zz = rotation.z * rotation.z;
+            const float xy = rotation.x * rotation.y, xz = rotation.x * rotation.z, yz = rotation.y * rotation.z;
+            const float wx = rotation.w * rotation.x, wy = rotation.w * rotation.y, wz = rotation.w * rotation.z;
+            return {{
+                (1.0f - 2.0f * (yy + zz)) * scale.x, 2.0f * (xy + wz) * scale.x, 2.0f * (xz - wy) * scale.x, 0.0f,
+                2.0f * (xy - wz) * scale.y, (1.0f - 2.0f * (xx + zz)) * scale.y, 2.0f * (yz + wx) * scale.y, 0.0f,
+                2.0f * (xz + wy) * scale.z, 2.0f * (yz - wx) * scale.z, (1.0f - 2.0f * (xx + yy)) * scale.z, 0.0f,
+                translation.x, translation.y, translation.z, 1.0f
+            }};
+        }
+
+        constexpr Mat4 operator*(const Mat4& other) const {
+            Mat4 result {};
+            for (int column = 0; column < 4; column++) {
+                for (int row = 0; row < 4; row++) {
+                    result.elements[column * 4 + row] = at(row, 0) * other.at(0, column) + at(row, 1) * other.at(1, column)
+                        + at(row, 2) * other.at(2, column) + at(row, 3) * other.at(3, column);
+                }
+            }
+            return result;
+        }
+
+        constexpr Vec3 transformPoint(const Vec3& point) const {
+            return {
+                at(0, 0) * point.x + at(0, 1) * point.y + at(0, 2) * point.z + at(0, 3),
+                at(1, 0) * point.x + at(1, 1) * point.y + at(1, 2) * point.z + at(1, 3),
+                at(2, 0) * point.x + at(2, 1) * point.y + at(2, 2) * point.z + at(2, 3)
+            };
+        }
+    };
+}
+
+#endif // _MEADOW_MATH_HPP_
@@ -0,0 +1,152 @@
+#include "Png.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    // Largest payload of one stored deflate block
+    constexpr uint32_t STORED_BLOCK_SIZE = 65535;
+
+    constexpr std::array<uint32_t, 256> makeCrcTable() {
+        std::array<uint32_t, 256> table {};
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        return table;
+    }
+
+    constexpr std::array<uint32_t, 256> CRC_TABLE = makeCrcTable();
+
+    void putBigEndian(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back((uint8_t)(value >> 24));
+        out.push_back((uint8_t)(value >> 16));
+        out.push_back((uint8_t)(value >> 8));
+        out.push_back((uint8_t)value);
+    }
+
+    /**
+     * @brief Fills in the length of the chunk begun at length_offset, now that its data
+     * has been appended, and appends its CRC.
+     */
+    void finishChunk(std::vector<uint8_t>& out, size_t length_offset) {
+        const uint32_t length = (uint32_t)(out.size() - length_offset - 8);
+        out[length_offset] = (uint8_t)(length >> 24);
+        out[length_offset + 1] = (uint8_t)(length >> 16);
+        out[length_offset + 2] = (uint8_t)(length >> 8);
+        out[length_offset + 3] = (uint8_t)length;
+
+        // The CRC covers the type and the data, not the length
+        uint32_t crc = 0xffffffffu;
+        for (size_t i = length_offset + 4; i < out.size(); i++) {
+            crc = CRC_TABLE[(crc ^ out[i]) & 0xff] ^ (crc >> 8);
+        }
+        putBigEndian(out, crc ^ 0xffffffffu);
+    }
+
+    size_t beginChunk(std::vector<uint8_t>& out, const char type[4]) {
+        const size_t length_offset = out.size();
+        putBigEndian(out, 0);
+        for (int i = 0; i < 4; i++) {
+            out.push_back((uint8_t)type[i]);
+        }
+        return length_offset;
+    }
+}
+
+std::vector<uint8_t> Png::encode(const uint8_t* pixels, uint32_t width, uint32_t height,
+    uint32_t row_pitch, bool bgra)
+{
+    const uint64_t row_size = 1 + (uint64_t)width * 4;
+    const uint64_t raw_size = row_size * height;
+    const uint64_t block_count = (raw_size + STORED_BLOCK_SIZE - 1) / STORED_BLOCK_SIZE;
+
+    std::vector<uint8_t> out;
+    out.reserve(64 + raw_size + block_count * 5);
+
+    for (uint8_t byte : {0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a}) {
+        out.push_back(byte);
+    }
+
+    size_t chunk = beginChunk(out, "IHDR");
+    putBigEndian(out, width);
+    putBigEndian(out, height);
+    out.push_back(8); // Bit depth
+    out.push_back(6); // RGBA
+    out.push_back(0); // Deflate
+    out.push_back(0); // Adaptive filtering, though every row uses filter 0
+    out.push_back(0); // Not interlaced
+    finishChunk(out, chunk);
+
+    chunk = beginChunk(out, "IDAT");
+    out.push_back(0x78); // Deflate, 32K window
+    out.push_back(0x01); // No preset dictionary, fastest level; divisible by 31 with the byte above
+
+    // Adler-32 of the uncompressed stream, updated as each byte goes out
+    uint32_t adler_a = 1;
+    uint32_t adler_b = 0;
+    uint64_t block_remaining = 0;
+    uint64_t written = 0;
+    auto put = [&](uint8_t byte) {
+        if (block_remaining == 0) {
+            const uint64_t left = raw_size - written;
+            const uint16_t size = (uint16_t)std::min<uint64_t>(left, STORED_BLOCK_SIZE);
+            out.push_back(left <= STORED_BLOCK_SIZE ? 1 : 0); // Final block flag, stored type
+            out.push_back((uint8_t)size);
+            out.push_back((uint8_t)(size >> 8));
+            out.push_back((uint8_t)~size);
+            out.push_back((uint8_t)(~size >> 8));
+            block_remaining = size;
+        }
+        out.push_back(byte);
+        block_remaining--;
+        written++;
+
+        adler_a += byte;
+        if (adler_a >= 65521) {
+            adler_a -= 65521;
+        }
+        adler_b += adler_a;
+        if (adler_b >= 65521) {
+            adler_b -= 65521;
+        }
+    };
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t* row = pixels + (uint64_t)y * row_pitch;
+        put(0);
+        for (uint32_t x = 0; x < width; x++) {
+            const uint8_t* pixel = row + (uint64_t)x * 4;
+            put(bgra ? pixel[2] : pixel[0]);
+            put(pixel[1]);
+            put(bgra ? pixel[0] : pixel[2]);
+            put(pixel[3]);
+        }
+    }
+    putBigEndian(out, (adler_b << 16) | adler_a);
+    finishChunk(out, chunk);
+
+    chunk = beginChunk(out, "IEND");
+    finishChunk(out, chunk);
+    return out;
+}
+
+void Png::write(const char* path, const uint8_t* pixels, uint32_t width, uint32_t height,
+    uint32_t row_pitch, bool bgra)
+{
+    std::vector<uint8_t> encoded = encode(pixels, width, height, row_pitch, bgra);
+
+    FILE* file = std::fopen(path, "wb");
+    if (!file) {
+        throw std::runtime_error(std::string("Failed to open ") + path + " for writing");
+    }
+    const size_t written = std::fwrite(encoded.data(), 1, encoded.size(), file);
+    if (std::fclose(file) != 0 || written != encoded.size()) {
+        throw std::runtime_error(std::string("Failed to write ") + path);
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef _MEADOW_PNG_HPP_
+#define _MEADOW_PNG_HPP_
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Minimal PNG writing for 8-bit RGBA images.
+ *
+ * Image data goes into stored (uncompressed) deflate blocks, so encoding runs at
+ * memory speed and keeps up with frame capture, at the cost of file size. Any PNG
+ * reader accepts the result; recompress offline where size matters.
+ */
+namespace Png {
+    /**
+     * @brief Encodes width x height pixels of 4 bytes each, rows row_pitch bytes apart.
+     *
+     * @param bgra Whether the pixels are stored B, G, R, A, as in most swapchain formats.
+     */
+    std::vector<uint8_t> encode(const uint8_t* pixels, uint32_t width, uint32_t height,
+        uint32_t row_pitch, bool bgra = false);
+
+    /**
+     * @brief Encodes the pixels and writes them to path. Throws std::runtime_error on failure.
+     */
+    void write(const char* path, const uint8_t* pixels, uint32_t width, uint32_t height,
+        uint32_t row_pitch, bool bgra = false);
+}
+
+#endif // _MEADOW_PNG_HPP_
@@ -0,0 +1,175 @@
+#ifndef _MEADOW_SMALL_VECTOR_HPP_
+#define _MEADOW_SMALL_VECTOR_HPP_
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <utility>
+
+/**
+ * @brief A vector storing up to N elements inline, only allocating past that.
+ *
+ * For the short lists resources come in, e.g. the shaders of a pipeline, which
+ * then cost no allocation at all. Move-only element types are supported; moving
+ * a SmallVector steals its heap buffer or moves the inline elements one by one,
+ * and leaves it empty.
+ *
+ * @tparam T The element type.
+ * @tparam N How many elements fit inline.
+ */
+template<typename T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "Use std::vector without inline storage");
+
+    alignas(T) std::byte storage[N * sizeof(T)];
+    T* elements;
+    size_t count;
+    size_t capacity;
+
+    inline T* inlineElements() { return std::launder(reinterpret_cast<T*>(storage)); }
+
+    inline bool isInline() const { return capacity == N; }
+
+    static T* allocate(size_t capacity) {
+        return static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    static void deallocate(T* elements) {
+        ::operator delete(elements, std::align_val_t(alignof(T)));
+    }
+
+    /**
+     * @brief Switches to a heap buffer the elements were already moved into.
+     */
+    void adopt(T* grown, size_t new_capacity) {
+        std::destroy(elements, elements + count);
+        if (!isInline()) {
+            deallocate(elements);
+        }
+        elements = grown;
+        capacity = new_capacity;
+    }
+
+    void takeFrom(SmallVector& other) {
+        if (other.isInline()) {
+            std::uninitialized_move(other.elements, other.elements + other.count, elements);
+            count = other.count;
+            other.clear();
+        }
+        else {
+            elements = std::exchange(other.elements, other.inlineElements());
+            count = std::exchange(other.count, 0);
+            capacity = std::exchange(other.capacity, N);
+        }
+    }
+
+public:
+    SmallVector() : elements(inlineElements()), count(0), capacity(N) {}
+
+    SmallVector(std::initializer_list<T> values) requires std::copy_constructible<T> : SmallVector() {
+        reserve(values.size());
+        for (const T& value : values) {
+            push_back(value);
+        }
+    }
+
+    SmallVector(const SmallVector& other) requires std::copy_constructible<T> : SmallVector() {
+        reserve(other.count);
+        std::uninitialized_copy(other.elements, other.elements + other.count, elements);
+        count = other.count;
+    }
+
+    SmallVector(SmallVector&& other) noexcept : SmallVector() {
+        takeFrom(other);
+    }
+
+    ~SmallVector() {
+        clear();
+        if (!isInline()) {
+            deallocate(elements);
+        }
+    }
+
+    SmallVector& operator=(const SmallVector& other) requires std::copy_constructible<T> {
+        if (this != &other) {
+            clear();
+            reserve(other.count);
+            std::uninitialized_copy(other.elements, other.elements + other.count, elements);
+            count = other.count;
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            clear();
+            if (!isInline()) {
+                deallocate(elements);
+                elements = inlineElements();
+                capacity = N;
+            }
+            takeFrom(other);
+        }
+        return *this;
+    }
+
+    void reserve(size_t new_capacity) {
+        if (new_capacity > capacity) {
+            T* grown = allocate(new_capacity);
+            std::uninitialized_move(elements, elements + count, grown);
+            adopt(grown, new_capacity);
+        }
+    }
+
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        if (count < capacity) {
+            std::construct_at(elements + count, std::forward<Args>(args)...);
+        }
+        else {
+            // Constructed before the old elements move, as args may refer to one of them
+            const size_t new_capacity = capacity * 2;
+            T* grown = allocate(new_capacity);
+            std::construct_at(grown + count, std::forward<Args>(args)...);
+            std::uninitialized_move(elements, elements + count, grown);
+            adopt(grown, new_capacity);
+        }
+        return elements[count++];
+    }
+
+    inline void push_back(const T& value) { emplace_back(value); }
+
+    inline void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void clear() {
+        std::destroy(elements, elements + count);
+        count = 0;
+    }
+
+    inline size_t size() const { return count; }
+
+    inline bool empty() const { return count == 0; }
+
+    inline T* data() { return elements; }
+    inline const T* data() const { return elements; }
+
+    inline T& operator[](size_t index) { return elements[index]; }
+    inline const T& operator[](size_t index) const { return elements[index]; }
+
+    inline T& back() { return elements[count - 1]; }
+    inline const T& back() const { return elements[count - 1]; }
+
+    bool operator==(const SmallVector& other) const requires std::equality_comparable<T> {
+        return count == other.count && std::equal(elements, elements + count, other.elements);
+    }
+
+    inline T* begin() { return elements; }
+    inline T* end() { return elements + count; }
+    inline const T* begin() const { return elements; }
+    inline const T* end() const { return elements + count; }
+};
+
+#endif // _MEADOW_SMALL_VECTOR_HPP_
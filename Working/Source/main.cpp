@@ -1,26 +1,228 @@
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
 #include "GraphicsContext.hpp"
 #include "Swapchain.hpp"
-#include "RenderPass.hpp"
 #include "Pipeline.hpp"
+#include "PipelineStateCache.hpp"
+#include "FixedPipelineState.hpp"
 #include "Shader.hpp"
 #include "CommandPool.hpp"
 #include "Frames.hpp"
+#include "RenderGraph.hpp"
+#include "DescriptorAllocator.hpp"
+#include "OcclusionCuller.hpp"
+#include "JobSystem.hpp"
+#include "AsyncIO.hpp"
+#include "FrameCapture.hpp"
+#include "GoldenImage.hpp"
+#include "PerformanceBaseline.hpp"
 #include "Config.h"
-#include "collection.hpp"
 
-int main() {
+namespace {
+	using DepthMode = PipelineDesc::DepthMode;
+
+	// Fixed state of the scene pipelines, checked and built at compile time
+	using ScenePipeline = PipelineTemplate<FixedPipelineState{ .depth_mode = DepthMode::TestWrite }>;
+	using SceneAfterPrepassPipeline = PipelineTemplate<FixedPipelineState{ .depth_mode = DepthMode::Equal }>;
+	using DepthPrepassPipeline = PipelineTemplate<FixedPipelineState{ .depth_mode = DepthMode::Prepass }>;
+
+	// A regression run measures every frame after the warmup, and compares the last one
+	// against its golden image
+	constexpr uint32_t REGRESSION_WARMUP_FRAMES = 30;
+	constexpr uint32_t REGRESSION_FRAMES = 300;
+
+	// CTest's SKIP_RETURN_CODE for the regression test, returned while the references are missing
+	constexpr int REGRESSION_SKIPPED = 77;
+
+	// Objects the occlusion culler can be handed
+	constexpr uint32_t OCCLUSION_CAPACITY = 4096;
+
+	/**
+	 * @brief Renders a fixed run and checks it against the golden image and performance
+	 * baseline in directory, or rewrites them when updating.
+	 *
+	 * @return The process exit code: non-zero on a regression, REGRESSION_SKIPPED without references.
+	 */
+	int runRegression(GraphicsContext& gc, Frames& fif, FrameCapture& capture, GoldenImageCheck& golden,
+		const std::string& directory, bool update)
+	{
+		// The run captures a single frame, which is frame 0 of the golden images
+		const std::string baseline_path = directory + "/baseline.txt";
+		if (update) {
+			std::filesystem::create_directories(directory);
+		}
+		else if (!golden.hasGoldenImage(0) || !std::filesystem::exists(baseline_path)) {
+			std::cout << "[REGRESSION] No golden image or baseline in " << directory
+				<< ", skipped; capture them on lavapipe with --update" << std::endl;
+			return REGRESSION_SKIPPED;
+		}
+
+		PerformanceBaseline performance;
+
+		// A few frames past the last, so the captured one gets collected
+		for (uint32_t i = 0; i < REGRESSION_FRAMES + CONSTANTS::FRAMES_IN_FLIGHT && gc; i++) {
+			if (i == REGRESSION_FRAMES - 1) {
+				capture.start();
+			}
+			else if (i == REGRESSION_FRAMES) {
+				capture.stop();
+			}
+
+			const bool measured = i >= REGRESSION_WARMUP_FRAMES && i < REGRESSION_FRAMES;
+			if (measured) {
+				performance.beginFrame(gc.getMemoryBudget().getTotalAllocations());
+			}
+			fif.drawFrame();
+			if (measured) {
+				performance.endFrame(gc.getMemoryBudget().getTotalAllocations());
+			}
+		}
+		capture.wait();
+
+		if (update) {
+			PerformanceBaseline::save(baseline_path.c_str(), performance.measure());
+			std::cout << "Updated the golden image and baseline in " << directory << std::endl;
+			return capture.getStats().delivered == 1 ? 0 : 1;
+		}
+
+		golden.report(std::cout);
+		bool passed = golden.passed() && capture.getStats().delivered == 1;
+
+		std::optional<PerformanceBaseline::Metrics> baseline = PerformanceBaseline::load(baseline_path.c_str());
+		if (baseline.has_value()) {
+			passed = performance.check(baseline.value(), std::cout) && passed;
+		}
+		else {
+			std::cout << "[PERF] No baseline at " << baseline_path << ", FAILED" << std::endl;
+			passed = false;
+		}
+		return passed ? 0 : 1;
+	}
+}
+
+int main(int argc, char** argv) {
+	// --regression <directory> [--update]: check a fixed run against the golden image and
+	// performance baseline stored in directory, or rewrite them
+	std::optional<std::string> regression_directory;
+	bool update = false;
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--regression") == 0 && i + 1 < argc) {
+			regression_directory = argv[++i];
+		}
+		else if (strcmp(argv[i], "--update") == 0) {
+			update = true;
+		}
+	}
+
 	GraphicsContext gc("Meadow");
 	Swapchain sc(gc);
-	RenderPass rp (gc.getLogicalDevice(), sc.getFormat());
-	sc.setRenderPass(rp);
 
-	ShaderCollection shaders (2);
-	shaders[0] = Shader::create(SHADER_BINARY_DIR "Shader.vert.spv", gc.getLogicalDevice(), VK_SHADER_STAGE_VERTEX_BIT);
-	shaders[1] = Shader::create(SHADER_BINARY_DIR "Shader.frag.spv", gc.getLogicalDevice(), VK_SHADER_STAGE_FRAGMENT_BIT);
+	JobSystem jobs;
+	AsyncIO io(jobs);
 
-	Pipeline p(gc, sc, shaders, false);
-	Frames fif(gc, sc, p);
+	std::vector<std::vector<char>> shader_code = syncWait(io.readFiles({
+		SHADER_BINARY_DIR "Shader.vert.spv",
+		SHADER_BINARY_DIR "Shader.frag.spv"
+	}), jobs);
+
+	ShaderCollection shaders (gc.getLogicalDevice());
+	shaders.add(shader_code[0], VK_SHADER_STAGE_VERTEX_BIT);
+	shaders.add(shader_code[1], VK_SHADER_STAGE_FRAGMENT_BIT);
+
+	ShaderCollection prepass_shaders (gc.getLogicalDevice());
+	prepass_shaders.add(shader_code[0], VK_SHADER_STAGE_VERTEX_BIT);
+
+	PipelineStateCache pipelines(gc, sc.getExtent());
+	DescriptorAllocator descriptors(gc);
+	OcclusionCuller occlusion(gc, descriptors, OCCLUSION_CAPACITY, sc.getSampleCount());
+	RenderGraph render_graph(gc);
+
+	// Declared ahead of the frames, which deliver their last captures when destroyed
+	std::optional<GoldenImageCheck> golden;
+	std::unique_ptr<FrameCapture> capture;
+	if (regression_directory.has_value()) {
+		golden.emplace(regression_directory.value(), GoldenImage::Tolerance{}, update);
+		capture = std::make_unique<FrameCapture>(gc, sc, jobs, golden->sink());
+	}
+
+	Frames fif(gc, sc);
+	if (capture) {
+		fif.setFrameCapture(*capture);
+	}
+
+	fif.addFrameResetCallback([&](uint32_t frame_index) {
+		descriptors.beginFrame(frame_index);
+		occlusion.beginFrame(frame_index);
+	});
+
+	// Pipelines are looked up while recording, as they need the render passes the graph
+	// compiled; pass callbacks run after the builder returns, so they capture its locals by value
+	fif.setRenderGraph(render_graph, [&](RenderGraph& graph, uint32_t image_index) {
+		const VkExtent2D extent = sc.getExtent();
+		const VkSampleCountFlagBits samples = sc.getSampleCount();
+
+		RenderGraph::ResourceHandle backbuffer = graph.importImage("backbuffer", sc.getImages()[image_index],
+			sc.getImageViews()[image_index], { sc.getFormat(), extent },
+			VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+
+		// Multisampled color never leaves the frame: the scene pass resolves it into the swapchain image
+		const bool multisampled = samples != VK_SAMPLE_COUNT_1_BIT;
+		RenderGraph::ResourceHandle color = multisampled
+			? graph.createTexture("color", { sc.getFormat(), extent, samples })
+			: backbuffer;
+		RenderGraph::ResourceHandle depth = graph.createTexture("depth", { sc.getDepthFormat(), extent, samples });
+
+		// Clears both targets, draws the occluders and builds the Hi-Z pyramid from their depth
+		occlusion.addPasses(graph, color, depth, extent, Math::Mat4::identity(),
+			[&fif, &pipelines, &shaders, &occlusion, &graph, samples](VkCommandBuffer command_buffer, VkBuffer commands, uint32_t count) {
+				// Both draw passes have the same attachments, so share one compatible pipeline
+				if (count > 0) {
+					fif.getCommandPool().bindPipeline(0, pipelines.get(ScenePipeline::describe(
+						Pipeline::describe(graph.getRenderPass("occlusion_early_draw"), samples, shaders))));
+					occlusion.drawIndirect(command_buffer, commands, count);
+				}
+			},
+			VkClearColorValue{{0.0f, 0.0f, 0.0f, 1.0f}});
+
+		if (CONSTANTS::DEPTH_PREPASS) {
+			graph.addPass("depth_prepass", RenderGraph::PassType::Raster,
+				[&](RenderGraph::PassBuilder& builder) {
+					builder.writeDepth(depth);
+				},
+				[&fif, &pipelines, &prepass_shaders, &graph, samples](VkCommandBuffer) {
+					fif.getCommandPool().recordDraw(0, pipelines.get(DepthPrepassPipeline::describe(
+						Pipeline::describe(graph.getRenderPass("depth_prepass"), samples, prepass_shaders))));
+				});
+		}
+
+		graph.addPass("scene", RenderGraph::PassType::Raster,
+			[&](RenderGraph::PassBuilder& builder) {
+				builder.writeColor(color);
+				if (CONSTANTS::DEPTH_PREPASS) {
+					builder.readDepth(depth);
+				}
+				else {
+					builder.writeDepth(depth);
+				}
+				if (multisampled) {
+					builder.resolveColor(color, backbuffer);
+				}
+			},
+			[&fif, &pipelines, &shaders, &graph, samples](VkCommandBuffer) {
+				const PipelineDesc scene_desc = Pipeline::describe(graph.getRenderPass("scene"), samples, shaders);
+				fif.getCommandPool().recordDraw(0, pipelines.get(CONSTANTS::DEPTH_PREPASS
+					? SceneAfterPrepassPipeline::describe(scene_desc)
+					: ScenePipeline::describe(scene_desc)));
+			});
+	});
+
+	if (regression_directory.has_value()) {
+		return runRegression(gc, fif, *capture, *golden, regression_directory.value(), update);
+	}
 
 	while (gc) {
 		fif.drawFrame();
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "AssetPackWriter.hpp"
+
+namespace {
+    void printUsage() {
+        std::fprintf(stderr,
+            "Usage: MeadowPacker [--codec none|lz4|zstd] <output.pack> <input directory>\n"
+            "\n"
+            "Packs every file under the input directory, named by its path relative to it\n"
+            "with forward slashes (e.g. \"Shader.vert.spv\", \"textures/rock.ktx2\").\n"
+            "Files are stored as-is, so they should already be in their GPU-ready layout.\n");
+    }
+
+    std::vector<std::byte> readFile(const std::filesystem::path& path) {
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            throw std::runtime_error("Failed to open file " + path.string());
+        }
+        std::vector<std::byte> data((size_t)file.tellg());
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), data.size());
+        if (!file) {
+            throw std::runtime_error("Failed to read file " + path.string());
+        }
+        return data;
+    }
+}
+
+int main(int argc, char** argv) {
+    Compression::Codec codec = Compression::Codec::None;
+    std::vector<const char*> positional;
+
+    for (int i = 1; i < argc; i++) {
+        if (!std::strcmp(argv[i], "--codec") && i + 1 < argc) {
+            const char* name = argv[++i];
+            if (!std::strcmp(name, "none")) {
+                codec = Compression::Codec::None;
+            }
+            else if (!std::strcmp(name, "lz4")) {
+                codec = Compression::Codec::LZ4;
+            }
+            else if (!std::strcmp(name, "zstd")) {
+                codec = Compression::Codec::Zstd;
+            }
+            else {
+                printUsage();
+                return 1;
+            }
+        }
+        else {
+            positional.push_back(argv[i]);
+        }
+    }
+
+    if (positional.size() != 2) {
+        printUsage();
+        return 1;
+    }
+    if (!Compression::isAvailable(codec)) {
+        std::fprintf(stderr, "MeadowPacker was built without %s support\n", Compression::getName(codec));
+        return 1;
+    }
+
+    try {
+        const std::filesystem::path root = positional[1];
+
+        // Sorted so the same inputs always produce the same pack
+        std::vector<std::filesystem::path> files;
+        for (const auto& item : std::filesystem::recursive_directory_iterator(root)) {
+            if (item.is_regular_file()) {
+                files.push_back(item.path());
+            }
+        }
+        std::sort(files.begin(), files.end());
+
+        AssetPackWriter writer;
+        uint64_t total_size = 0;
+        for (const auto& path : files) {
+            std::vector<std::byte> data = readFile(path);
+            total_size += data.size();
+            writer.add(std::filesystem::relative(path, root).generic_string(), data, codec);
+        }
+        writer.write(positional[0]);
+
+        std::printf("Packed %zu assets into %s: %llu bytes, %llu stored (%s)\n", writer.getCount(), positional[0],
+            (unsigned long long)total_size, (unsigned long long)writer.getStoredSize(), Compression::getName(codec));
+    }
+    catch (const std::exception& e) {
+        std::fprintf(stderr, "MeadowPacker: %s\n", e.what());
+        return 1;
+    }
+
+    return 0;
+}